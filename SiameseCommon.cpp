@@ -32,6 +32,42 @@
 namespace siamese {
 
 
+//------------------------------------------------------------------------------
+// RowSumPlan
+
+static RowSumPlan m_RowSumPlans[kRowPeriod];
+
+void InitializeRowSumPlans()
+{
+    for (unsigned row = 0; row < kRowPeriod; ++row)
+    {
+        RowSumPlan& plan = m_RowSumPlans[row];
+        plan.RecoveryCount = 0;
+        plan.ProductCount  = 0;
+
+        for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+        {
+            const unsigned opcode = GetRowOpcode(laneIndex, row);
+
+            for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+            {
+                const uint8_t laneSum = (uint8_t)(laneIndex * kColumnSumCount + sumIndex);
+                if (opcode & (1 << sumIndex))
+                    plan.Recovery[plan.RecoveryCount++] = laneSum;
+                if (opcode & (1 << (sumIndex + kColumnSumCount)))
+                    plan.Product[plan.ProductCount++] = laneSum;
+            }
+        }
+    }
+}
+
+const RowSumPlan& GetRowSumPlan(unsigned row)
+{
+    SIAMESE_DEBUG_ASSERT(row < kRowPeriod);
+    return m_RowSumPlans[row];
+}
+
+
 //------------------------------------------------------------------------------
 // GrowingAlignedByteMatrix
 
@@ -123,6 +159,9 @@ unsigned OriginalPacket::Initialize(pktalloc::Allocator* allocator, const Siames
 {
     SIAMESE_DEBUG_ASSERT(allocator && packet.Data && packet.DataBytes > 0 && packet.PacketNum < kColumnPeriod);
 
+    // Do not reallocate a buffer that belongs to the application
+    ReleaseOwned();
+
     // Allocate space for the packet
     const unsigned bufferSize = kMaxPacketLengthFieldBytes + packet.DataBytes;
     if (!Buffer.Initialize(allocator, bufferSize))
@@ -138,10 +177,96 @@ unsigned OriginalPacket::Initialize(pktalloc::Allocator* allocator, const Siames
     Buffer.Bytes = HeaderBytes + packet.DataBytes;
 
     Column = packet.PacketNum;
-    LastSendMsec = 0;
 
     return HeaderBytes;
 }
 
+unsigned OriginalPacket::InitializeGather(
+    pktalloc::Allocator* allocator,
+    const SiameseOriginalPacket& packet,
+    const SiameseIOVec* vecs,
+    unsigned vecCount)
+{
+    SIAMESE_DEBUG_ASSERT(allocator && vecs && packet.DataBytes > 0 && packet.PacketNum < kColumnPeriod);
+
+    // Do not reallocate a buffer that belongs to the application
+    ReleaseOwned();
+
+    // Allocate space for the packet
+    const unsigned bufferSize = kMaxPacketLengthFieldBytes + packet.DataBytes;
+    if (!Buffer.Initialize(allocator, bufferSize))
+        return 0;
+
+    // Serialize the packet length into the front using a compressed format
+    HeaderBytes = SerializeHeader_PacketLength(packet.DataBytes, Buffer.Data);
+    SIAMESE_DEBUG_ASSERT(HeaderBytes <= kMaxPacketLengthFieldBytes);
+
+    // Copy each fragment after the length
+    uint8_t* dest = Buffer.Data + HeaderBytes;
+    for (unsigned i = 0; i < vecCount; ++i)
+    {
+        const unsigned fragmentBytes = vecs[i].DataBytes;
+        if (fragmentBytes > 0)
+        {
+            memcpy(dest, vecs[i].Data, fragmentBytes);
+            dest += fragmentBytes;
+        }
+    }
+    SIAMESE_DEBUG_ASSERT(dest == Buffer.Data + HeaderBytes + packet.DataBytes);
+
+    Buffer.Bytes = HeaderBytes + packet.DataBytes;
+
+    Column = packet.PacketNum;
+
+    return HeaderBytes;
+}
+
+unsigned OriginalPacket::Adopt(
+    pktalloc::Allocator* allocator,
+    const SiameseOriginalPacket& packet,
+    SiameseReleaseCallback release,
+    void* context)
+{
+    SIAMESE_DEBUG_ASSERT(allocator && packet.Data && packet.DataBytes > 0 && packet.PacketNum < kColumnPeriod);
+    SIAMESE_DEBUG_ASSERT(release != nullptr);
+    static_assert(kMaxPacketLengthFieldBytes <= SIAMESE_OWNED_HEADROOM, "Update this");
+
+    // Free the buffer used by the last packet in this slot
+    ReleaseOwned();
+    Buffer.Free(allocator);
+
+    // Serialize the packet length right in front of the data
+    uint8_t header[kMaxPacketLengthFieldBytes];
+    HeaderBytes = SerializeHeader_PacketLength(packet.DataBytes, header);
+    SIAMESE_DEBUG_ASSERT(HeaderBytes <= kMaxPacketLengthFieldBytes);
+
+    uint8_t* data = const_cast<uint8_t*>(packet.Data) - HeaderBytes;
+    memcpy(data, header, HeaderBytes);
+
+    Buffer.Data  = data;
+    Buffer.Bytes = HeaderBytes + packet.DataBytes;
+
+    Column         = packet.PacketNum;
+    Release        = release;
+    ReleaseContext = context;
+
+    return HeaderBytes;
+}
+
+void OriginalPacket::ReleaseApplicationBuffer()
+{
+    SIAMESE_DEBUG_ASSERT(Release && Buffer.Data);
+
+    const SiameseReleaseCallback release = Release;
+    const uint8_t* data = Buffer.Data + HeaderBytes;
+
+    // Forget the buffer before handing it back
+    Release      = nullptr;
+    Buffer.Data  = nullptr;
+    Buffer.Bytes = 0;
+
+    release(ReleaseContext, data);
+}
+
 
 } // namespace siamese
@@ -141,6 +141,31 @@ static const unsigned kPairAddRate = 16;
 // of this size in order to reduce the cost of elimination
 static const unsigned kSubwindowSize = kColumnLaneCount * 8;
 
+// Recovery rows at least this long are accumulated with the streaming gf256
+// kernels, which write around the cache so the running sums stay resident.
+// Measured with tests/gf256_stream_bench.cpp: Because each row is read back
+// by the next accumulation, streaming only helps once a row is far larger
+// than the last level cache, so this is set conservatively high
+static const unsigned kStreamingMinBytes = 64 * 1024 * 1024;
+
+// Accumulate "x[] += y[]" into a recovery row, selecting kernel by size
+SIAMESE_FORCE_INLINE void RowAddMem(void* vx, const void* vy, unsigned bytes)
+{
+    if (bytes >= kStreamingMinBytes)
+        gf256_add_mem_stream(vx, vy, (int)bytes);
+    else
+        gf256_add_mem(vx, vy, (int)bytes);
+}
+
+// Accumulate "z[] += x[] * y" into a recovery row, selecting kernel by size
+SIAMESE_FORCE_INLINE void RowMulAddMem(void* vz, uint8_t y, const void* vx, unsigned bytes)
+{
+    if (bytes >= kStreamingMinBytes)
+        gf256_muladd_mem_stream(vz, y, vx, (int)bytes);
+    else
+        gf256_muladd_mem(vz, y, vx, (int)bytes);
+}
+
 
 // Calculate operation code for the given row and lane
 SIAMESE_FORCE_INLINE unsigned GetRowOpcode(unsigned lane, unsigned row)
@@ -157,6 +182,25 @@ SIAMESE_FORCE_INLINE unsigned GetRowOpcode(unsigned lane, unsigned row)
     return (opcode == 0) ? kZeroValue : (unsigned)opcode;
 }
 
+// Lane sums that one row adds into the recovery packet and product workspace,
+// which are the set bits of GetRowOpcode() for each lane
+struct RowSumPlan
+{
+    // Number of lane sums added into each buffer
+    unsigned RecoveryCount;
+    unsigned ProductCount;
+
+    // Lane sums to add, each as laneIndex * kColumnSumCount + sumIndex
+    uint8_t Recovery[kColumnLaneCount * kColumnSumCount];
+    uint8_t Product[kColumnLaneCount * kColumnSumCount];
+};
+
+// Precompute the plans for all rows.  Called by siamese_init()
+void InitializeRowSumPlans();
+
+// Returns the precomputed plan for the given row
+const RowSumPlan& GetRowSumPlan(unsigned row);
+
 
 //------------------------------------------------------------------------------
 // MDS Erasure Codes using Cauchy Matrix
@@ -313,6 +357,78 @@ struct GrowingAlignedByteMatrix
 };
 
 
+//------------------------------------------------------------------------------
+// MultiplyAddBatch
+//
+// Collects "z[] += x_i[] * y_i" operations into one destination buffer and
+// performs them together with gf256_muladd_multi(), so that the destination
+// passes through the cache once per batch rather than once per source.
+// Sources of at least kStreamingMinBytes are still added one at a time with
+// the streaming kernels, like RowAddMem() and RowMulAddMem().
+// The source buffers must stay valid until Flush() is called.
+
+struct MultiplyAddBatch
+{
+    // Maximum number of sources combined in one gf256_muladd_multi() call
+    static const unsigned kMaxSources = 64;
+
+    // Destination buffer
+    uint8_t* Destination = nullptr;
+
+    // Queued sources
+    uint8_t Coefficients[kMaxSources];
+    const void* Sources[kMaxSources];
+    unsigned Lengths[kMaxSources];
+    unsigned Count = 0;
+
+
+    explicit MultiplyAddBatch(uint8_t* destination)
+        : Destination(destination)
+    {
+    }
+
+    // Queue "Destination[] += source[] * y"
+    void Add(uint8_t y, const void* source, unsigned bytes)
+    {
+        if (y == 0 || bytes == 0)
+            return;
+        if (Count >= kMaxSources)
+            Flush();
+        Coefficients[Count] = y;
+        Sources[Count]      = source;
+        Lengths[Count]      = bytes;
+        ++Count;
+    }
+
+    // Perform all queued operations
+    void Flush()
+    {
+        unsigned batchCount = 0;
+        for (unsigned i = 0; i < Count; ++i)
+        {
+            // If the source is long enough to stream:
+            if (Lengths[i] >= kStreamingMinBytes)
+            {
+                if (Coefficients[i] == 1)
+                    RowAddMem(Destination, Sources[i], Lengths[i]);
+                else
+                    RowMulAddMem(Destination, Coefficients[i], Sources[i], Lengths[i]);
+                continue;
+            }
+
+            Coefficients[batchCount] = Coefficients[i];
+            Sources[batchCount]      = Sources[i];
+            Lengths[batchCount]      = Lengths[i];
+            ++batchCount;
+        }
+
+        if (batchCount > 0)
+            gf256_muladd_multi(Destination, Coefficients, Sources, Lengths, batchCount);
+        Count = 0;
+    }
+};
+
+
 //------------------------------------------------------------------------------
 // OriginalPacket
 
@@ -327,13 +443,43 @@ struct OriginalPacket
     // Keep track of the number of bytes for header on the packet data
     unsigned HeaderBytes = 0;
 
-    // Timestamp at which we last sent the packet
-    uint64_t LastSendMsec = 0;
+    // If the buffer belongs to the application, this returns it.
+    // Otherwise it is null and the buffer is allocated by the codec
+    SiameseReleaseCallback Release = nullptr;
+    void* ReleaseContext = nullptr;
 
 
     // Write data to buffer with length prefix and initialize other members
     // Returns the number of bytes overhead, or 0 on out-of-memory error
     unsigned Initialize(pktalloc::Allocator* allocator, const SiameseOriginalPacket& packet);
+
+    // Gather data from vecs into buffer with length prefix and initialize other members.
+    // packet.DataBytes is the total length of the vecs and packet.Data is unused.
+    // Returns the number of bytes overhead, or 0 on out-of-memory error
+    unsigned InitializeGather(
+        pktalloc::Allocator* allocator,
+        const SiameseOriginalPacket& packet,
+        const SiameseIOVec* vecs,
+        unsigned vecCount);
+
+    // Use the application's buffer in place, writing the length prefix into the
+    // SIAMESE_OWNED_HEADROOM bytes in front of it, and initialize other members.
+    // Returns the number of bytes overhead
+    unsigned Adopt(
+        pktalloc::Allocator* allocator,
+        const SiameseOriginalPacket& packet,
+        SiameseReleaseCallback release,
+        void* context);
+
+    // Return the buffer to the application if it belongs to the application
+    SIAMESE_FORCE_INLINE void ReleaseOwned()
+    {
+        if (Release)
+            ReleaseApplicationBuffer();
+    }
+
+    // Calls the release callback and clears the buffer
+    void ReleaseApplicationBuffer();
 };
 
 
@@ -464,26 +464,25 @@ bool Decoder::AddSingleRecovery(const SiameseRecoveryPacket& packet, const Recov
     if (windowOriginal->Buffer.Bytes != 0)
         return true;
 
-    const unsigned headerBytes = windowOriginal->HeaderBytes;
-
-#ifdef SIAMESE_DEBUG
-    // Check: Deserialize length from the front
-    SIAMESE_DEBUG_ASSERT(packet.DataBytes > (unsigned)footerSize);
+    // Deserialize length from the front.
+    // Note: The missing element has no header of its own to go by
+    if (packet.DataBytes <= (unsigned)footerSize)
+    {
+        SIAMESE_DEBUG_BREAK(); // Invalid input
+        return false;
+    }
     const unsigned lengthPlusDataBytes = packet.DataBytes - footerSize;
-    unsigned lengthCheck;
-    int headerBytesCheck = DeserializeHeader_PacketLength(packet.Data, lengthPlusDataBytes, lengthCheck);
-    if ((int)headerBytes != headerBytesCheck ||
-        headerBytesCheck < 1 || lengthCheck == 0 ||
-        lengthCheck + headerBytesCheck != lengthPlusDataBytes)
+    unsigned length;
+    const int headerBytes = DeserializeHeader_PacketLength(packet.Data, lengthPlusDataBytes, length);
+    if (headerBytes < 1 || length == 0 ||
+        length + headerBytes != lengthPlusDataBytes)
     {
         SIAMESE_DEBUG_BREAK(); // Invalid input
         return false;
     }
-#endif // SIAMESE_DEBUG
 
     SiameseOriginalPacket original;
-    SIAMESE_DEBUG_ASSERT(packet.DataBytes > footerSize + headerBytes);
-    original.DataBytes = packet.DataBytes - footerSize - headerBytes;
+    original.DataBytes = length;
     original.Data      = packet.Data + headerBytes;
     original.PacketNum = metadata.ColumnStart;
 
@@ -817,6 +816,8 @@ bool Decoder::EliminateOriginalData()
         // If it is a Cauchy or parity row:
         if (metadata.SumCount <= SIAMESE_CAUCHY_THRESHOLD)
         {
+            MultiplyAddBatch batch(recoveryBuffer.Data);
+
             // If this is a parity row:
             if (metadata.Row == 0)
             {
@@ -832,7 +833,7 @@ bool Decoder::EliminateOriginalData()
                             SIAMESE_DEBUG_BREAK(); // Should never happen
                             addBytes = recoveryBuffer.Bytes;
                         }
-                        gf256_add_mem(recoveryBuffer.Data, original->Buffer.Data, addBytes);
+                        batch.Add(1, original->Buffer.Data, addBytes);
                     }
                 }
             }
@@ -851,11 +852,12 @@ bool Decoder::EliminateOriginalData()
                             SIAMESE_DEBUG_BREAK(); // Should never happen
                             addBytes = recoveryBuffer.Bytes;
                         }
-                        gf256_muladd_mem(recoveryBuffer.Data, y, original->Buffer.Data, addBytes);
+                        batch.Add(y, original->Buffer.Data, addBytes);
                     }
                 }
             }
 
+            batch.Flush();
             continue;
         }
 #endif // SIAMESE_ENABLE_CAUCHY
@@ -884,44 +886,30 @@ bool Decoder::EliminateOriginalData()
         Window.SumColumnCount = metadata.SumCount;
 
         // Eliminate dense recovery data outside of matrix:
-        for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
         {
-            const unsigned opcode = GetRowOpcode(laneIndex, metadata.Row);
+            const RowSumPlan& plan = GetRowSumPlan(metadata.Row);
 
-            // For summations into the RecoveryPacket buffer:
-            unsigned mask = 1;
-            for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+            // Queue a lane sum to add into one of the buffers
+            const auto addSum = [&](MultiplyAddBatch& batch, unsigned laneSum)
             {
-                if (opcode & mask)
-                {
-                    const GrowingAlignedDataBuffer* sum = Window.GetSum(laneIndex, sumIndex, elementEnd);
-                    unsigned addBytes = sum->Bytes;
-                    if (addBytes > 0)
-                    {
-                        if (addBytes > recoveryBytes)
-                            addBytes = recoveryBytes;
-                        gf256_add_mem(recoveryBuffer.Data, sum->Data, addBytes);
-                    }
-                }
-                mask <<= 1;
-            }
-
-            // For summations into the ProductWorkspace buffer:
-            for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
-            {
-                if (opcode & mask)
-                {
-                    const GrowingAlignedDataBuffer* sum = Window.GetSum(laneIndex, sumIndex, elementEnd);
-                    unsigned addBytes = sum->Bytes;
-                    if (addBytes > 0)
-                    {
-                        if (addBytes > recoveryBytes)
-                            addBytes = recoveryBytes;
-                        gf256_add_mem(ProductSum.Data, sum->Data, addBytes);
-                    }
-                }
-                mask <<= 1;
-            }
+                const GrowingAlignedDataBuffer* sum = Window.GetSum(
+                    laneSum / kColumnSumCount, laneSum % kColumnSumCount, elementEnd);
+                unsigned addBytes = sum->Bytes;
+                if (addBytes > recoveryBytes)
+                    addBytes = recoveryBytes;
+                batch.Add(1, sum->Data, addBytes);
+            };
+
+            // Add all the sums for each buffer in a single pass over it
+            MultiplyAddBatch recoveryBatch(recoveryBuffer.Data);
+            for (unsigned k = 0; k < plan.RecoveryCount; ++k)
+                addSum(recoveryBatch, plan.Recovery[k]);
+            recoveryBatch.Flush();
+
+            MultiplyAddBatch productBatch(ProductSum.Data);
+            for (unsigned k = 0; k < plan.ProductCount; ++k)
+                addSum(productBatch, plan.Product[k]);
+            productBatch.Flush();
         }
 
         // Eliminate light recovery data outside of matrix:
@@ -949,7 +937,7 @@ bool Decoder::EliminateOriginalData()
                     SIAMESE_DEBUG_BREAK(); // Should never happen
                     addBytes1 = recoveryBytes;
                 }
-                gf256_add_mem(recoveryBuffer.Data, original1->Buffer.Data, addBytes1);
+                RowAddMem(recoveryBuffer.Data, original1->Buffer.Data, addBytes1);
 
                 if (pDebugMsg)
                     *pDebugMsg << element1 << " ";
@@ -970,7 +958,7 @@ bool Decoder::EliminateOriginalData()
                     SIAMESE_DEBUG_BREAK(); // Should never happen
                     addBytesRX = recoveryBytes;
                 }
-                gf256_add_mem(ProductSum.Data, originalRX->Buffer.Data, addBytesRX);
+                RowAddMem(ProductSum.Data, originalRX->Buffer.Data, addBytesRX);
 
                 if (pDebugMsg)
                     *pDebugMsg << elementRX << " ";
@@ -987,7 +975,7 @@ bool Decoder::EliminateOriginalData()
 
         SIAMESE_DEBUG_ASSERT(recoveryBuffer.Bytes == ProductSum.Bytes);
         const uint8_t RX = GetRowValue(metadata.Row);
-        gf256_muladd_mem(recoveryBuffer.Data, RX, ProductSum.Data, ProductSum.Bytes);
+        RowMulAddMem(recoveryBuffer.Data, RX, ProductSum.Data, ProductSum.Bytes);
     }
 
     // Return false if GetSum() ran out of memory
@@ -1001,32 +989,48 @@ bool Decoder::MultiplyLowerTriangle()
 
     const unsigned columns = CheckedRegion.LostCount;
 
-    // Multiply lower triangle following solution order from left to right:
-    for (unsigned col_i = 0; col_i < columns - 1; ++col_i)
+    // Multiply lower triangle following solution order from left to right.
+    // Each row pulls in all of the rows above it in one pass over its data,
+    // which is the same as pushing each row down in turn because rows above
+    // have already received all of their own contributions.
+    for (unsigned col_j = 1; col_j < columns; ++col_j)
     {
-        const unsigned matrixRowIndex_i = RecoveryMatrix.Pivots[col_i];
-        const GrowingAlignedDataBuffer& recovery_i = RecoveryMatrix.Rows[matrixRowIndex_i].Recovery->Buffer;
-        const uint8_t* srcData  = recovery_i.Data;
-        const unsigned srcBytes = recovery_i.Bytes;
-        SIAMESE_DEBUG_ASSERT(srcData && srcBytes > 0);
+        const unsigned matrixRowIndex_j = RecoveryMatrix.Pivots[col_j];
+        GrowingAlignedDataBuffer& recovery_j = RecoveryMatrix.Rows[matrixRowIndex_j].Recovery->Buffer;
+        SIAMESE_DEBUG_ASSERT(recovery_j.Data && recovery_j.Bytes > 0);
 
-        for (unsigned col_j = col_i + 1; col_j < columns; ++col_j)
+        // Make room for the summation
+        unsigned maxSrcBytes = 0;
+        for (unsigned col_i = 0; col_i < col_j; ++col_i)
+        {
+            if (RecoveryMatrix.Matrix.Get(matrixRowIndex_j, col_i) == 0)
+                continue;
+
+            const unsigned matrixRowIndex_i = RecoveryMatrix.Pivots[col_i];
+            const unsigned srcBytes = RecoveryMatrix.Rows[matrixRowIndex_i].Recovery->Buffer.Bytes;
+            if (maxSrcBytes < srcBytes)
+                maxSrcBytes = srcBytes;
+        }
+        if (maxSrcBytes == 0)
+            continue;
+        if (!recovery_j.GrowZeroPadded(&TheAllocator, maxSrcBytes))
+            return false;
+
+        MultiplyAddBatch batch(recovery_j.Data);
+        for (unsigned col_i = 0; col_i < col_j; ++col_i)
         {
-            const unsigned matrixRowIndex_j = RecoveryMatrix.Pivots[col_j];
             const uint8_t y = RecoveryMatrix.Matrix.Get(matrixRowIndex_j, col_i);
 
             if (y == 0)
                 continue;
 
-            GrowingAlignedDataBuffer& recovery_j = RecoveryMatrix.Rows[matrixRowIndex_j].Recovery->Buffer;
-            SIAMESE_DEBUG_ASSERT(recovery_j.Data && recovery_j.Bytes > 0);
-
-            // Make room for the summation
-            if (!recovery_j.GrowZeroPadded(&TheAllocator, srcBytes))
-                return false;
+            const unsigned matrixRowIndex_i = RecoveryMatrix.Pivots[col_i];
+            const GrowingAlignedDataBuffer& recovery_i = RecoveryMatrix.Rows[matrixRowIndex_i].Recovery->Buffer;
+            SIAMESE_DEBUG_ASSERT(recovery_i.Data && recovery_i.Bytes > 0);
 
-            gf256_muladd_mem(recovery_j.Data, y, srcData, srcBytes);
+            batch.Add(y, recovery_i.Data, recovery_i.Bytes);
         }
+        batch.Flush();
     }
 
     return true;
@@ -1056,6 +1060,31 @@ SiameseResult Decoder::BackSubstitution()
         SIAMESE_DEBUG_ASSERT(buffer && recovery->Buffer.Bytes > 0);
         SIAMESE_DEBUG_ASSERT(y != 0);
 
+        // Eliminate all of the columns to the right, which are already solved.
+        // This pulls every solved column into this row in one pass over its
+        // data, rather than pushing each solution into all the rows above it
+        MultiplyAddBatch batch(buffer);
+        for (unsigned col_k = col_i + 1; col_k < columns; ++col_k)
+        {
+            const uint8_t x = RecoveryMatrix.Matrix.Get(matrixRowIndex, col_k);
+
+            if (x == 0)
+                continue;
+
+            const GrowingAlignedDataBuffer& solved_k = RecoveryMatrix.Columns[col_k].Original->Buffer;
+            SIAMESE_DEBUG_ASSERT(solved_k.Data && solved_k.Bytes > 0);
+
+            unsigned addBytes = solved_k.Bytes;
+            if (addBytes > recovery->Buffer.Bytes)
+            {
+                SIAMESE_DEBUG_BREAK(); // This should never happen
+                addBytes = recovery->Buffer.Bytes;
+            }
+
+            batch.Add(x, solved_k.Data, addBytes);
+        }
+        batch.Flush();
+
         // Reveal the first chunk of bytes of data
         unsigned bufferBytes      = recovery->Buffer.Bytes;
         unsigned lengthCheckBytes = pktalloc::kAlignmentBytes;
@@ -1086,7 +1115,6 @@ SiameseResult Decoder::BackSubstitution()
         original->Buffer.Bytes   = bufferBytes;
         original->Column         = RecoveryMatrix.Columns[col_i].Column;
         original->HeaderBytes    = (unsigned)headerBytes;
-        original->LastSendMsec   = 0;
         recovery->Buffer.Data    = oldOriginalData;
         recovery->Buffer.Bytes   = 0;
 
@@ -1101,28 +1129,6 @@ SiameseResult Decoder::BackSubstitution()
         Logger.Trace("GE Decoded: Column=", original->Column, " Row=", recovery->Metadata.Row);
 
         iterateNextExpected |= Window.MarkGotColumn(original->Column);
-
-        // Eliminate from all other pivot rows above it:
-        for (unsigned col_j = 0; col_j < (unsigned)col_i; ++col_j)
-        {
-            unsigned pivot_j = RecoveryMatrix.Pivots[col_j];
-            const uint8_t x  = RecoveryMatrix.Matrix.Get(pivot_j, col_i);
-
-            if (x == 0)
-                continue;
-
-            const GrowingAlignedDataBuffer& buffer_j = RecoveryMatrix.Rows[pivot_j].Recovery->Buffer;
-            SIAMESE_DEBUG_ASSERT(buffer_j.Data && buffer_j.Bytes > 0);
-
-            unsigned addBytes = bufferBytes;
-            if (addBytes > buffer_j.Bytes)
-            {
-                SIAMESE_DEBUG_BREAK(); // This should never happen
-                addBytes = buffer_j.Bytes;
-            }
-
-            gf256_muladd_mem(buffer_j.Data, x, buffer, addBytes);
-        }
     }
 
     // We always expect to have recovered the next expected packet
@@ -1365,12 +1371,12 @@ bool DecoderPacketWindow::GrowWindow(unsigned windowElementEnd)
     return true;
 }
 
-SiameseResult DecoderPacketWindow::AddOriginal(const SiameseOriginalPacket& packet)
+SiameseResult DecoderPacketWindow::AddOriginal(const SiameseOriginalPacket& packet, const SiameseIOVec* vecs, unsigned vecCount)
 {
     if (EmergencyDisabled)
         return Siamese_Disabled;
 
-    SIAMESE_DEBUG_ASSERT(packet.Data && packet.DataBytes > 0);
+    SIAMESE_DEBUG_ASSERT((packet.Data || vecs) && packet.DataBytes > 0);
     SIAMESE_DEBUG_ASSERT(packet.PacketNum >= ColumnStart);
     const unsigned element = ColumnToElement(packet.PacketNum);
 
@@ -1397,7 +1403,10 @@ SiameseResult DecoderPacketWindow::AddOriginal(const SiameseOriginalPacket& pack
     }
 
     // Make space for the packet data
-    if (0 == original->Initialize(TheAllocator, packet))
+    const unsigned headerBytes = vecs ?
+        original->InitializeGather(TheAllocator, packet, vecs, vecCount) :
+        original->Initialize(TheAllocator, packet);
+    if (0 == headerBytes)
     {
         EmergencyDisabled = true;
         Logger.Error("AddOriginal.Initialize OOM");
@@ -1563,17 +1572,25 @@ bool DecoderPacketWindow::StartSums(unsigned elementStart, unsigned bufferBytes)
     return true;
 }
 
-const GrowingAlignedDataBuffer* DecoderPacketWindow::GetSum(unsigned laneIndex, unsigned sumIndex, unsigned elementEnd)
+void DecoderPacketWindow::AccumulateLaneSums(unsigned laneIndex, unsigned elementEnd)
 {
-    DecoderSum& sum = Lanes[laneIndex].Sums[sumIndex];
+    static_assert(kColumnSumCount == 3, "Update this");
 
-    SIAMESE_DEBUG_ASSERT(sum.ElementStart <= sum.ElementEnd);
-    SIAMESE_DEBUG_ASSERT((sum.ElementStart + ColumnStart) % kColumnLaneCount == laneIndex);
-    SIAMESE_DEBUG_ASSERT((sum.ElementEnd + ColumnStart) % kColumnLaneCount == laneIndex);
+    DecoderSum* sums = Lanes[laneIndex].Sums;
 
-    unsigned element = sum.ElementEnd;
+    // Start from the sum that is furthest behind
+    unsigned element = elementEnd;
+    for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+    {
+        const DecoderSum& sum = sums[sumIndex];
+        SIAMESE_DEBUG_ASSERT(sum.ElementStart <= sum.ElementEnd);
+        SIAMESE_DEBUG_ASSERT((sum.ElementStart + ColumnStart) % kColumnLaneCount == laneIndex);
+        SIAMESE_DEBUG_ASSERT((sum.ElementEnd + ColumnStart) % kColumnLaneCount == laneIndex);
+        if (element > sum.ElementEnd)
+            element = sum.ElementEnd;
+    }
     if (element >= elementEnd)
-        return &sum.Buffer;
+        return;
 
     // For each element to accumulate in this lane:
     do
@@ -1582,45 +1599,65 @@ const GrowingAlignedDataBuffer* DecoderPacketWindow::GetSum(unsigned laneIndex,
         OriginalPacket* original     = GetWindowElement(element);
         const unsigned originalBytes = original->Buffer.Bytes;
 
-        Logger.Info("Lane ", laneIndex,  " sum ",  sumIndex,  " accumulating column: ",  element + ColumnStart,  ". Got = ",  (originalBytes > 0));
+        Logger.Info("Lane ", laneIndex, " accumulating column: ", element + ColumnStart, ". Got = ", (originalBytes > 0));
 
         if (originalBytes > 0)
         {
             SIAMESE_DEBUG_ASSERT(original->Column % kColumnLaneCount == laneIndex);
-            if (originalBytes > sum.Buffer.Bytes)
+
+            // Select the sums that have not accumulated this element yet
+            unsigned sumMask = 0;
+            for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
             {
+                GrowingAlignedDataBuffer& buffer = sums[sumIndex].Buffer;
+                if (element < sums[sumIndex].ElementEnd)
+                    continue;
+                sumMask |= 1 << sumIndex;
+
                 // Grow sum to encompass the original data
-                if (!sum.Buffer.GrowZeroPadded(TheAllocator, originalBytes))
+                if (originalBytes > buffer.Bytes &&
+                    !buffer.GrowZeroPadded(TheAllocator, originalBytes))
                 {
                     EmergencyDisabled = true;
-                    goto ExitSum;
+                    return;
                 }
             }
 
-            // Sum += PacketData
-            if (sumIndex == 0)
-                gf256_add_mem(sum.Buffer.Data, original->Buffer.Data, originalBytes);
+            const uint8_t CX  = GetColumnValue(original->Column);
+            const uint8_t CX2 = gf256_sqr(CX);
+            const uint8_t* data = original->Buffer.Data;
+
+            // Sums are normally in step, so the data is only read once
+            if (sumMask == 7)
+            {
+                // Sum[0] += PacketData
+                // Sum[1] += CX * PacketData
+                // Sum[2] += CX^2 * PacketData
+                gf256_add_muladd2_mem(
+                    sums[0].Buffer.Data,
+                    sums[1].Buffer.Data, CX,
+                    sums[2].Buffer.Data, CX2,
+                    data, originalBytes);
+            }
             else
             {
-                uint8_t CX = GetColumnValue(original->Column);
-                if (sumIndex == 2)
-                    CX = gf256_sqr(CX);
-
-                // Sum += CX * PacketData
-                gf256_muladd_mem(sum.Buffer.Data, CX, original->Buffer.Data, originalBytes);
+                if (sumMask & 1)
+                    gf256_add_mem(sums[0].Buffer.Data, data, originalBytes);
+                if (sumMask & 2)
+                    gf256_muladd_mem(sums[1].Buffer.Data, CX, data, originalBytes);
+                if (sumMask & 4)
+                    gf256_muladd_mem(sums[2].Buffer.Data, CX2, data, originalBytes);
             }
         }
 
-        SIAMESE_DEBUG_ASSERT(original->Buffer.Bytes == 0 || original->Column % kColumnLaneCount == laneIndex);
         element += kColumnLaneCount;
     } while (element < elementEnd);
 
     SIAMESE_DEBUG_ASSERT((element + ColumnStart) % kColumnLaneCount == laneIndex);
 
-    sum.ElementEnd = element;
-
-ExitSum:
-    return &sum.Buffer;
+    for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+        if (sums[sumIndex].ElementEnd < element)
+            sums[sumIndex].ElementEnd = element;
 }
 
 /*
@@ -1782,9 +1819,10 @@ void DecoderPacketWindow::RemoveElements()
         // Roll up all the sums past the point of removal
         for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
         {
+            AccumulateLaneSums(laneIndex, removedElementCount);
+
             for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
             {
-                GetSum(laneIndex, sumIndex, removedElementCount);
 
                 // If the start element is getting clipped:
                 if (Lanes[laneIndex].Sums[sumIndex].ElementStart >= removedElementCount)
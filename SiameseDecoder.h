@@ -433,8 +433,9 @@ struct DecoderPacketWindow
     // Find the next expected element
     void IterateNextExpectedElement(unsigned elementStart);
 
-    // Append a packet to the end of the set
-    SiameseResult AddOriginal(const SiameseOriginalPacket& packet);
+    // Append a packet to the end of the set.
+    // If vecs is not null, the packet data is gathered from vecs instead of packet.Data
+    SiameseResult AddOriginal(const SiameseOriginalPacket& packet, const SiameseIOVec* vecs, unsigned vecCount);
 
     // Mark that we got a column
     // Returns true if this was the next expected element
@@ -443,8 +444,15 @@ struct DecoderPacketWindow
     // Make sure the window contains the given end element
     bool GrowWindow(unsigned windowElementEnd);
 
+    // Accumulate all of the running sums for a lane up to the given element
+    void AccumulateLaneSums(unsigned laneIndex, unsigned elementEnd);
+
     // Get running sums for a lane
-    const GrowingAlignedDataBuffer* GetSum(unsigned laneIndex, unsigned sumIndex, unsigned elementEnd);
+    const GrowingAlignedDataBuffer* GetSum(unsigned laneIndex, unsigned sumIndex, unsigned elementEnd)
+    {
+        AccumulateLaneSums(laneIndex, elementEnd);
+        return &Lanes[laneIndex].Sums[sumIndex].Buffer;
+    }
 
     // Rebase running sums from the given element
     bool StartSums(unsigned elementStart, unsigned bufferBytes);
@@ -552,18 +560,25 @@ private:
         const unsigned columnEnd, uint8_t y)
     {
 #ifdef GF256_ALIGNED_ACCESSES
-        // Do unaligned operations first
-        // Note: Each row starts at an aliged address
-        unsigned unalignedEnd = NextAlignedOffset(columnStart);
-        if (unalignedEnd > columnEnd)
-            unalignedEnd = columnEnd;
-        for (; columnStart < unalignedEnd; ++columnStart)
-            rem_row[columnStart] ^= gf256_mul(ge_row[columnStart], y);
-        if (columnStart >= columnEnd)
-            return;
-#endif
-
+        // Widen the range to aligned offsets rather than multiplying the
+        // unaligned ends a byte at a time.
+        // Note: Each row starts at an aligned address, and the row pitch is
+        // aligned, so the end can be rounded up into the padding columns.
+        // Columns of ge_row past columnEnd are zero up to the matrix width,
+        // and the padding after that is never read.  The columns before
+        // columnStart hold elimination constants, so those are saved and
+        // restored around the operation
+        const unsigned alignedStart = columnStart & ~(pktalloc::kAlignmentBytes - 1);
+        const unsigned headBytes = columnStart - alignedStart;
+        uint8_t head[pktalloc::kAlignmentBytes];
+        memcpy(head, rem_row + alignedStart, headBytes);
+
+        gf256_muladd_mem(rem_row + alignedStart, y, ge_row + alignedStart, pktalloc::NextAlignedOffset(columnEnd) - alignedStart);
+
+        memcpy(rem_row + alignedStart, head, headBytes);
+#else
         gf256_muladd_mem(rem_row + columnStart, y, ge_row + columnStart, columnEnd - columnStart);
+#endif
     }
 
     // Internal function common to both GE functions, used to eliminate a row of data
@@ -603,7 +618,11 @@ public:
     SiameseResult AddRecovery(const SiameseRecoveryPacket& packet);
     SIAMESE_FORCE_INLINE SiameseResult AddOriginal(const SiameseOriginalPacket& packet)
     {
-        return Window.AddOriginal(packet);
+        return Window.AddOriginal(packet, nullptr, 0);
+    }
+    SIAMESE_FORCE_INLINE SiameseResult AddOriginalV(const SiameseOriginalPacket& packet, const SiameseIOVec* vecs, unsigned vecCount)
+    {
+        return Window.AddOriginal(packet, vecs, vecCount);
     }
     SIAMESE_FORCE_INLINE SiameseResult IsReadyToDecode()
     {
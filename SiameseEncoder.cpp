@@ -49,6 +49,19 @@ EncoderPacketWindow::EncoderPacketWindow()
     ClearWindow();
 }
 
+EncoderPacketWindow::~EncoderPacketWindow()
+{
+    ReleaseOwnedElements(0, (unsigned)Subwindows.size() * kSubwindowSize);
+}
+
+void EncoderPacketWindow::ReleaseOwnedElements(unsigned elementStart, unsigned elementEnd)
+{
+    SIAMESE_DEBUG_ASSERT(elementEnd <= Subwindows.size() * kSubwindowSize);
+
+    for (unsigned element = elementStart; element < elementEnd; ++element)
+        Subwindows[element / kSubwindowSize]->Originals[element % kSubwindowSize].ReleaseOwned();
+}
+
 void EncoderPacketWindow::ClearWindow()
 {
     FirstUnremovedElement = 0;
@@ -59,18 +72,18 @@ void EncoderPacketWindow::ClearWindow()
 
     for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
     {
-        EncoderColumnLane& lane = Lanes[laneIndex];
-
-        for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
-        {
-            lane.Sum[sumIndex].Bytes   = 0;
-            lane.NextElement[sumIndex] = laneIndex;
-        }
-        lane.LongestPacket = 0;
+        ClearLaneSums(laneIndex, laneIndex);
+        Lanes[laneIndex].LongestPacket = 0;
+        Lanes[laneIndex].Longest.Clear();
     }
 }
 
-SiameseResult EncoderPacketWindow::Add(SiameseOriginalPacket& packet)
+SiameseResult EncoderPacketWindow::Add(
+    SiameseOriginalPacket& packet,
+    const SiameseIOVec* vecs,
+    unsigned vecCount,
+    SiameseReleaseCallback release,
+    void* releaseContext)
 {
     if (EmergencyDisabled)
         return Siamese_Disabled;
@@ -111,7 +124,14 @@ SiameseResult EncoderPacketWindow::Add(SiameseOriginalPacket& packet)
 
     // Initialize original packet with received data
     OriginalPacket* original = GetWindowElement(element);
-    if (0 == original->Initialize(TheAllocator, packet))
+    unsigned headerBytes;
+    if (release)
+        headerBytes = original->Adopt(TheAllocator, packet, release, releaseContext);
+    else if (vecs)
+        headerBytes = original->InitializeGather(TheAllocator, packet, vecs, vecCount);
+    else
+        headerBytes = original->Initialize(TheAllocator, packet);
+    if (0 == headerBytes)
     {
         EmergencyDisabled = true;
         Logger.Error("WindowAdd.Initialize OOM");
@@ -131,6 +151,15 @@ SiameseResult EncoderPacketWindow::Add(SiameseOriginalPacket& packet)
         lane.LongestPacket = originalBytes;
     if (LongestPacket < originalBytes)
         LongestPacket = originalBytes;
+    lane.Longest.Push(column, originalBytes);
+
+    // If the sums are running, fold this packet into them now instead of on the next encode
+    if (EagerSums && SumEndElement > SumStartElement)
+    {
+        AccumulateLaneSums(laneIndex, Count);
+        if (EmergencyDisabled)
+            return Siamese_Disabled;
+    }
 
     Stats->Counts[SiameseEncoderStats_OriginalCount]++;
     Stats->Counts[SiameseEncoderStats_OriginalBytes] += packet.DataBytes;
@@ -149,10 +178,14 @@ void EncoderPacketWindow::StartNewWindow(unsigned column)
     FirstUnremovedElement  = element;
     Count                  = element + 1;
 
-    // Reset longest packet
+    // Reset longest packet and forget the sums of the previous window
     LongestPacket = 0;
     for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+    {
+        ClearLaneSums(laneIndex, laneIndex);
         Lanes[laneIndex].LongestPacket = 0;
+        Lanes[laneIndex].Longest.Clear();
+    }
 
     Logger.Info(">>> Starting a new window from column ", ColumnStart);
 }
@@ -176,6 +209,8 @@ void EncoderPacketWindow::RemoveBefore(unsigned firstKeptColumn)
             // Removed everything
             Count = 0;
 
+            ReleaseOwnedElements(0, (unsigned)Subwindows.size() * kSubwindowSize);
+
             Logger.Info("Remove before column ", firstKeptColumn, " - Removed everything");
         }
     }
@@ -185,23 +220,38 @@ void EncoderPacketWindow::RemoveBefore(unsigned firstKeptColumn)
 
         // Mark these elements for removal next time we generate output
         if (FirstUnremovedElement < firstKeptElement)
+        {
             FirstUnremovedElement = firstKeptElement;
+
+            // Shrink recovery packets now rather than when the elements are removed
+            UpdateLongestPacket();
+        }
     }
 }
 
 void EncoderPacketWindow::ResetSums(unsigned elementStart)
 {
-    // Recreate all the sums from scratch after this:
+    const unsigned subwindowStart = elementStart - elementStart % kSubwindowSize;
+
+    // Recreate all the sums after this:
     for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
     {
-        // Calculate first element to accumulate for this lane
-        const unsigned nextElement = GetNextLaneElement(elementStart, laneIndex);
+        const EncoderColumnLane& lane = Lanes[laneIndex];
 
-        for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+        // If the lane has accumulated past the start of the subwindow and the
+        // new start, restart from the checkpoint instead of from scratch:
+        if (lane.PrefixStartElement <= subwindowStart &&
+            lane.NextElement > subwindowStart + laneIndex &&
+            lane.NextElement >= elementStart)
         {
-            Lanes[laneIndex].NextElement[sumIndex] = nextElement;
-            Lanes[laneIndex].Sum[sumIndex].Bytes   = 0;
+            if (!RestartLaneSums(laneIndex, elementStart))
+            {
+                EmergencyDisabled = true;
+                return;
+            }
         }
+        else
+            ClearLaneSums(laneIndex, GetNextLaneElement(elementStart, laneIndex));
     }
 
     SumStartElement = elementStart;
@@ -221,18 +271,16 @@ void EncoderPacketWindow::RemoveElements()
     Logger.Info("******** Removing up to ", FirstUnremovedElement, " and startColumn=", ColumnStart);
 
     // If there are running sums:
-    if (SumEndElement > SumStartElement)
+    const bool sumsRunning = SumEndElement > SumStartElement;
+    if (sumsRunning)
     {
         // Roll up the sums past the removal point
         for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
         {
-            for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
-            {
-                GetSum(laneIndex, sumIndex, removedElementCount);
+            AccumulateLaneSums(laneIndex, removedElementCount);
 
-                SIAMESE_DEBUG_ASSERT(Lanes[laneIndex].NextElement[sumIndex] >= removedElementCount);
-                Lanes[laneIndex].NextElement[sumIndex] -= removedElementCount;
-            }
+            SIAMESE_DEBUG_ASSERT(Lanes[laneIndex].NextElement >= removedElementCount);
+            Lanes[laneIndex].NextElement -= removedElementCount;
         }
 
         if (removedElementCount > SumStartElement)
@@ -249,6 +297,31 @@ void EncoderPacketWindow::RemoveElements()
             SumStartElement = 0;
     }
 
+    // Shift the lane prefix sums along with the elements
+    for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+    {
+        EncoderColumnLane& lane = Lanes[laneIndex];
+
+        if (!sumsRunning)
+        {
+            // If the lane stopped accumulating before the kept elements:
+            if (lane.NextElement < removedElementCount)
+            {
+                ClearLaneSums(laneIndex, laneIndex);
+                continue;
+            }
+            lane.NextElement -= removedElementCount;
+        }
+
+        if (lane.PrefixStartElement > removedElementCount)
+            lane.PrefixStartElement -= removedElementCount;
+        else
+            lane.PrefixStartElement = 0;
+    }
+
+    // Return removed packets that belong to the application
+    ReleaseOwnedElements(0, removedElementCount);
+
     // Shift kept subwindows to the front of the vector
     // Note: Removed entries get rotated to the end
     std::rotate(Subwindows.begin(), Subwindows.begin() + firstKeptSubwindow, Subwindows.end());
@@ -267,87 +340,242 @@ void EncoderPacketWindow::RemoveElements()
     FirstUnremovedElement -= removedElementCount;
 
     // Determine the new longest packets
+    UpdateLongestPacket();
+
+    // If there are no running sums:
+    if (SumEndElement <= SumStartElement)
+        ResetSums(FirstUnremovedElement);
+}
+
+void EncoderPacketWindow::UpdateLongestPacket()
+{
     unsigned longestPacket = 0;
-    unsigned laneLongest[kColumnLaneCount] = { 0 };
+    for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+    {
+        EncoderColumnLane& lane = Lanes[laneIndex];
+
+        // Drop candidates that are not in flight anymore
+        while (lane.Longest.Count > 0)
+        {
+            const unsigned element = ColumnToElement(lane.Longest.Front().Column);
+            if (!IsColumnDeltaNegative(element) && element >= FirstUnremovedElement)
+                break;
+            lane.Longest.PopFront();
+        }
+
+        lane.LongestPacket = lane.Longest.Longest();
+        if (longestPacket < lane.LongestPacket)
+            longestPacket = lane.LongestPacket;
+    }
+    LongestPacket = longestPacket;
+
+#ifdef SIAMESE_DEBUG
+    // Check: Longest packets match a scan of the window
     for (unsigned i = FirstUnremovedElement, count = Count; i < count; ++i)
     {
-        OriginalPacket* original     = GetWindowElement(i);
-        const unsigned originalBytes = original->Buffer.Bytes;
-        if (longestPacket < originalBytes)
-            longestPacket = originalBytes;
-        SIAMESE_DEBUG_ASSERT(original->Column % kColumnLaneCount == i % kColumnLaneCount);
-        const unsigned laneIndex = i % kColumnLaneCount;
-        if (laneLongest[laneIndex] < originalBytes)
-            laneLongest[laneIndex] = originalBytes;
+        const unsigned originalBytes = GetWindowElement(i)->Buffer.Bytes;
+        SIAMESE_DEBUG_ASSERT(originalBytes <= Lanes[i % kColumnLaneCount].LongestPacket);
     }
+#endif // SIAMESE_DEBUG
+}
 
-    // Update longest packet fields
-    LongestPacket = longestPacket;
-    for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
-        Lanes[laneIndex].LongestPacket = laneLongest[laneIndex];
+void EncoderPacketWindow::ClearLaneSums(unsigned laneIndex, unsigned elementStart)
+{
+    SIAMESE_DEBUG_ASSERT(elementStart % kColumnLaneCount == laneIndex);
+    EncoderColumnLane& lane = Lanes[laneIndex];
 
-    // If there are no running sums:
-    if (SumEndElement <= SumStartElement)
-        ResetSums(FirstUnremovedElement);
+    lane.NextElement        = elementStart;
+    lane.PrefixStartElement = elementStart;
+
+    for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+    {
+        lane.Sum[sumIndex].Bytes  = 0;
+        lane.Base[sumIndex].Bytes = 0;
+    }
+}
+
+bool EncoderPacketWindow::CheckpointLaneSums(unsigned laneIndex, unsigned subwindowIndex)
+{
+    const EncoderColumnLane& lane = Lanes[laneIndex];
+    GrowingAlignedDataBuffer* checkpoint = Subwindows[subwindowIndex]->Checkpoints[laneIndex];
+
+    for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+    {
+        const GrowingAlignedDataBuffer& sum  = lane.Sum[sumIndex];
+        const GrowingAlignedDataBuffer& base = lane.Base[sumIndex];
+        const unsigned bytes = sum.Bytes > base.Bytes ? sum.Bytes : base.Bytes;
+
+        checkpoint[sumIndex].Bytes = 0;
+        if (bytes <= 0)
+            continue;
+
+        // Checkpoint = Sum + Base
+        if (!checkpoint[sumIndex].Initialize(TheAllocator, bytes))
+            return false;
+        memcpy(checkpoint[sumIndex].Data, sum.Data, sum.Bytes);
+        memset(checkpoint[sumIndex].Data + sum.Bytes, 0, bytes - sum.Bytes);
+        if (base.Bytes > 0)
+            gf256_add_mem(checkpoint[sumIndex].Data, base.Data, base.Bytes);
+    }
+
+    return true;
 }
 
-const GrowingAlignedDataBuffer* EncoderPacketWindow::GetSum(unsigned laneIndex, unsigned sumIndex, unsigned elementEnd)
+bool EncoderPacketWindow::RestartLaneSums(unsigned laneIndex, unsigned elementStart)
 {
+    static_assert(kColumnSumCount == 3, "Update this");
+
     EncoderColumnLane& lane = Lanes[laneIndex];
-    unsigned element = lane.NextElement[sumIndex];
-    SIAMESE_DEBUG_ASSERT(element % kColumnLaneCount == laneIndex);
-    SIAMESE_DEBUG_ASSERT(element < Count + kColumnLaneCount);
+    const unsigned subwindowIndex = elementStart / kSubwindowSize;
+    SIAMESE_DEBUG_ASSERT(lane.PrefixStartElement <= subwindowIndex * kSubwindowSize);
+    SIAMESE_DEBUG_ASSERT(lane.NextElement > subwindowIndex * kSubwindowSize + laneIndex);
+    SIAMESE_DEBUG_ASSERT(lane.NextElement >= elementStart);
+    const GrowingAlignedDataBuffer* checkpoint = Subwindows[subwindowIndex]->Checkpoints[laneIndex];
 
-    if (element < elementEnd)
+    for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
     {
-        GrowingAlignedDataBuffer& sum = lane.Sum[sumIndex];
+        GrowingAlignedDataBuffer& sum  = lane.Sum[sumIndex];
+        GrowingAlignedDataBuffer& base = lane.Base[sumIndex];
 
-        // Grow this sum for this lane to fit new (larger) data if needed
-        if (lane.LongestPacket > 0 &&
-            !sum.GrowZeroPadded(TheAllocator, lane.LongestPacket))
+        // Sum += Base, so it is the prefix sum up to NextElement
+        if (base.Bytes > 0)
         {
-            EmergencyDisabled = true;
-            goto ExitSum;
+            if (!sum.GrowZeroPadded(TheAllocator, base.Bytes))
+                return false;
+            gf256_add_mem(sum.Data, base.Data, base.Bytes);
         }
 
-        do
+        // Base = Checkpoint
+        base.Bytes = 0;
+        const unsigned checkpointBytes = checkpoint[sumIndex].Bytes;
+        if (checkpointBytes > 0)
         {
-            Logger.Info("Lane ", laneIndex, " sum ", sumIndex, " accumulating column: ", ColumnStart + element);
+            if (!base.Initialize(TheAllocator, checkpointBytes))
+                return false;
+            memcpy(base.Data, checkpoint[sumIndex].Data, checkpointBytes);
+        }
+    }
+
+    // Base += Lane elements from the start of the subwindow up to the new start.
+    // Note: These are still in the window since only whole subwindows are removed
+    for (unsigned element = subwindowIndex * kSubwindowSize + laneIndex; element < elementStart; element += kColumnLaneCount)
+    {
+        OriginalPacket* original = GetWindowElement(element);
+        const unsigned addBytes  = original->Buffer.Bytes;
 
-            OriginalPacket* original = GetWindowElement(element);
-            const unsigned column    = original->Column;
-            unsigned addBytes        = original->Buffer.Bytes;
+        for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+            if (!lane.Base[sumIndex].GrowZeroPadded(TheAllocator, addBytes))
+                return false;
+
+        const uint8_t CX = GetColumnValue(original->Column);
+        gf256_add_muladd2_mem(
+            lane.Base[0].Data,
+            lane.Base[1].Data, CX,
+            lane.Base[2].Data, gf256_sqr(CX),
+            original->Buffer.Data, addBytes);
+    }
 
-            if (!sum.GrowZeroPadded(TheAllocator, addBytes))
+    // Sum += Base, so it is the sum from the new start up to NextElement
+    for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+    {
+        GrowingAlignedDataBuffer& sum  = lane.Sum[sumIndex];
+        GrowingAlignedDataBuffer& base = lane.Base[sumIndex];
+
+        if (base.Bytes > 0)
+        {
+            if (!sum.GrowZeroPadded(TheAllocator, base.Bytes))
+                return false;
+            gf256_add_mem(sum.Data, base.Data, base.Bytes);
+        }
+
+        // Longer packets before the new start cancelled out, leaving zeroes
+        // past the longest packet that is still in flight in this lane
+        SIAMESE_DEBUG_ASSERT(elementStart >= FirstUnremovedElement);
+        if (sum.Bytes > lane.LongestPacket)
+        {
+#ifdef SIAMESE_DEBUG
+            for (unsigned i = lane.LongestPacket; i < sum.Bytes; ++i)
+                SIAMESE_DEBUG_ASSERT(sum.Data[i] == 0);
+#endif // SIAMESE_DEBUG
+            sum.Bytes = lane.LongestPacket;
+        }
+    }
+
+    return true;
+}
+
+void EncoderPacketWindow::AccumulateLaneSums(unsigned laneIndex, unsigned elementEnd)
+{
+    static_assert(kColumnSumCount == 3, "Update this");
+
+    EncoderColumnLane& lane = Lanes[laneIndex];
+    unsigned element = lane.NextElement;
+    SIAMESE_DEBUG_ASSERT(element % kColumnLaneCount == laneIndex);
+    SIAMESE_DEBUG_ASSERT(element < Count + kColumnLaneCount);
+
+    if (element >= elementEnd)
+        return;
+
+    // Grow the sums for this lane to fit new (larger) data if needed
+    const unsigned sumBytes = lane.LongestPacket;
+    if (sumBytes > 0)
+    {
+        for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+        {
+            if (!lane.Sum[sumIndex].GrowZeroPadded(TheAllocator, sumBytes))
             {
                 EmergencyDisabled = true;
-                goto ExitSum;
+                return;
             }
+        }
+    }
 
-            SIAMESE_DEBUG_ASSERT(original->Buffer.Bytes <= sum.Bytes || element < FirstUnremovedElement);
+    do
+    {
+        Logger.Info("Lane ", laneIndex, " accumulating column: ", ColumnStart + element);
 
-            // Sum += PacketData
-            if (sumIndex == 0)
-                gf256_add_mem(sum.Data, original->Buffer.Data, addBytes);
-            else
+        // Checkpoint the prefix sums before the first lane element of each subwindow
+        if (element % kSubwindowSize < kColumnLaneCount &&
+            lane.PrefixStartElement <= element - laneIndex)
+        {
+            if (!CheckpointLaneSums(laneIndex, element / kSubwindowSize))
             {
-                // Sum += CX[2] * PacketData
-                uint8_t CX = GetColumnValue(column);
-                if (sumIndex == 2)
-                    CX = gf256_sqr(CX);
-                gf256_muladd_mem(sum.Data, CX, original->Buffer.Data, addBytes);
+                EmergencyDisabled = true;
+                return;
             }
+        }
 
-            SIAMESE_DEBUG_ASSERT(original->Column % kColumnLaneCount == laneIndex);
-            element += kColumnLaneCount;
-        } while (element < elementEnd);
+        OriginalPacket* original = GetWindowElement(element);
+        const unsigned column    = original->Column;
+        unsigned addBytes        = original->Buffer.Bytes;
 
-        // Store next element to accumulate
-        lane.NextElement[sumIndex] = element;
-    }
+        for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+        {
+            if (!lane.Sum[sumIndex].GrowZeroPadded(TheAllocator, addBytes))
+            {
+                EmergencyDisabled = true;
+                return;
+            }
+        }
 
-ExitSum:
-    return &lane.Sum[sumIndex];
+        SIAMESE_DEBUG_ASSERT(original->Buffer.Bytes <= lane.Sum[0].Bytes || element < FirstUnremovedElement);
+
+        // Sum[0] += PacketData
+        // Sum[1] += CX * PacketData
+        // Sum[2] += CX^2 * PacketData
+        const uint8_t CX = GetColumnValue(column);
+        gf256_add_muladd2_mem(
+            lane.Sum[0].Data,
+            lane.Sum[1].Data, CX,
+            lane.Sum[2].Data, gf256_sqr(CX),
+            original->Buffer.Data, addBytes);
+
+        SIAMESE_DEBUG_ASSERT(original->Column % kColumnLaneCount == laneIndex);
+        element += kColumnLaneCount;
+    } while (element < elementEnd);
+
+    // Store next element to accumulate
+    lane.NextElement = element;
 }
 
 
@@ -374,9 +602,12 @@ bool EncoderAcknowledgementState::OnAcknowledgementData(const uint8_t* data, uns
     }
 
     NextColumnExpected = nextColumnExpected;
+    Acknowledged       = true;
 
-    // Remove data the given column
-    TheWindow->RemoveBefore(NextColumnExpected);
+    // Remember which columns were resent before forgetting the previous loss list
+    const int resentCount = SaveResent();
+    if (resentCount < 0)
+        return false;
 
     // Reset message decoder state
     Offset     = 0;
@@ -384,6 +615,11 @@ bool EncoderAcknowledgementState::OnAcknowledgementData(const uint8_t* data, uns
     LossCount  = 0;
     DataBytes  = bytes;
 
+    // Forget the previous loss list
+    RetransmitSize  = 0;
+    RetransmitHead  = 0;
+    RetransmitCount = 0;
+
     // If there are no loss ranges:
     if (bytes <= 0)
         return true;
@@ -395,7 +631,106 @@ bool EncoderAcknowledgementState::OnAcknowledgementData(const uint8_t* data, uns
     memset(Data + bytes, 0, kPaddingBytes); // Zero guard bytes
 
     // Returns false if decoding the first loss range fails
-    return DecodeNextRange();
+    if (!DecodeNextRange())
+        return false;
+
+    // Queue the lost columns of each loss range
+    do
+    {
+        if (!QueueLossRange())
+        {
+            RetransmitCount = 0;
+            return false;
+        }
+
+        // Note: The next range starts relative to one beyond the end of this one
+        LossColumn = AddColumns(LossColumn, LossCount + 1);
+    } while (DecodeNextRange());
+
+    RetransmitSize = RetransmitCount;
+
+    if (resentCount > 0)
+        RestoreResent((unsigned)resentCount);
+
+    // Resend the packets that were sent longest ago first.
+    // Note: Packets that were never resent have LastSendMsec = 0 and stay in column order
+    const auto sentEarlier = [](const EncoderRetransmit& a, const EncoderRetransmit& b) -> bool
+    {
+        return a.LastSendMsec < b.LastSendMsec;
+    };
+    EncoderRetransmit* retransmitsEnd = Retransmits + RetransmitCount;
+    if (!std::is_sorted(Retransmits, retransmitsEnd, sentEarlier))
+        std::stable_sort(Retransmits, retransmitsEnd, sentEarlier);
+
+    return true;
+}
+
+int EncoderAcknowledgementState::SaveResent()
+{
+    if (RetransmitCount <= 0)
+        return 0;
+
+    if (RetransmitCount > ResentCapacity)
+    {
+        Resent = reinterpret_cast<EncoderRetransmit*>(TheAllocator->Reallocate(
+            reinterpret_cast<uint8_t*>(Resent),
+            RetransmitCount * (unsigned)sizeof(EncoderRetransmit),
+            pktalloc::Realloc::Uninitialized));
+        if (!Resent)
+        {
+            ResentCapacity = 0;
+            return -1;
+        }
+        ResentCapacity = RetransmitCount;
+    }
+
+    // Copy the columns that were resent and are still in the window
+    EncoderPacketWindow* window = TheWindow;
+    unsigned resentCount = 0;
+    for (unsigned i = 0, index = RetransmitHead; i < RetransmitCount; ++i)
+    {
+        const EncoderRetransmit& retransmit = Retransmits[index];
+        if (++index >= RetransmitSize)
+            index = 0;
+
+        if (retransmit.LastSendMsec == 0)
+            continue;
+        const unsigned element = window->ColumnToElement(retransmit.Column);
+        if (window->InvalidElement(element) || element < window->FirstUnremovedElement)
+            continue;
+
+        Resent[resentCount++] = retransmit;
+    }
+
+    // Sort by position in the window to match the order of the new loss list
+    const unsigned columnStart = window->ColumnStart;
+    std::sort(Resent, Resent + resentCount, [columnStart](const EncoderRetransmit& a, const EncoderRetransmit& b) -> bool
+    {
+        return SubtractColumns(a.Column, columnStart) < SubtractColumns(b.Column, columnStart);
+    });
+
+    return (int)resentCount;
+}
+
+void EncoderAcknowledgementState::RestoreResent(unsigned resentCount)
+{
+    const unsigned columnStart = TheWindow->ColumnStart;
+
+    // Both lists are in column order, so walk them together
+    unsigned resentIndex = 0;
+    for (unsigned i = 0; i < RetransmitCount && resentIndex < resentCount; ++i)
+    {
+        const unsigned element = SubtractColumns(Retransmits[i].Column, columnStart);
+
+        while (resentIndex < resentCount &&
+            SubtractColumns(Resent[resentIndex].Column, columnStart) < element)
+        {
+            ++resentIndex;
+        }
+
+        if (resentIndex < resentCount && Resent[resentIndex].Column == Retransmits[i].Column)
+            Retransmits[i].LastSendMsec = Resent[resentIndex++].LastSendMsec;
+    }
 }
 
 bool EncoderAcknowledgementState::DecodeNextRange()
@@ -422,81 +757,387 @@ bool EncoderAcknowledgementState::DecodeNextRange()
         return false;
     }
 
-    // Move ahead the loss column
-    LossColumn = AddColumns(LossColumn, relativeStart);
-    LossCount  = lossCountM1 + 1;
+    // Move ahead the loss column
+    LossColumn = AddColumns(LossColumn, relativeStart);
+    LossCount  = lossCountM1 + 1;
+
+    return true;
+}
+
+bool EncoderAcknowledgementState::QueueLossRange()
+{
+    EncoderPacketWindow* window = TheWindow;
+    if (window->Count <= 0)
+        return true;
+
+    unsigned count   = LossCount;
+    unsigned element = window->ColumnToElement(LossColumn);
+
+    // Skip lost columns that were removed from the window already
+    if (IsColumnDeltaNegative(element))
+    {
+        const unsigned removedCount = SubtractColumns(window->ColumnStart, LossColumn);
+        if (removedCount >= count)
+            return true;
+        count  -= removedCount;
+        element = 0;
+    }
+
+    // Clip the range to the end of the window
+    if (element >= window->Count)
+        return true;
+    if (count > window->Count - element)
+        count = window->Count - element;
+
+    // Grow the queue to fit the range
+    const unsigned needed = RetransmitCount + count;
+    if (needed > RetransmitCapacity)
+    {
+        const unsigned capacity = needed > RetransmitCapacity * 2 ? needed : RetransmitCapacity * 2;
+        Retransmits = reinterpret_cast<EncoderRetransmit*>(TheAllocator->Reallocate(
+            reinterpret_cast<uint8_t*>(Retransmits),
+            capacity * (unsigned)sizeof(EncoderRetransmit),
+            pktalloc::Realloc::CopyExisting));
+        if (!Retransmits)
+        {
+            RetransmitCapacity = 0;
+            return false;
+        }
+        RetransmitCapacity = capacity;
+    }
+
+    for (unsigned elementEnd = element + count; element < elementEnd; ++element)
+    {
+        const OriginalPacket* original = window->GetWindowElement(element);
+        if (original->Buffer.Bytes > 0)
+        {
+            EncoderRetransmit& retransmit = Retransmits[RetransmitCount++];
+            retransmit.Column       = window->ElementToColumn(element);
+            retransmit.LastSendMsec = 0;
+        }
+    }
+
+    return true;
+}
+
+void EncoderAcknowledgementState::Clear()
+{
+    // Reset message decoder state
+    Offset     = 0;
+    LossColumn = 0;
+    LossCount  = 0;
+    DataBytes  = 0;
+
+    RetransmitSize  = 0;
+    RetransmitHead  = 0;
+    RetransmitCount = 0;
+}
+
+void EncoderAcknowledgementState::Free()
+{
+    Clear();
+
+    TheAllocator->Free(Data);
+    TheAllocator->Free(reinterpret_cast<uint8_t*>(Retransmits));
+    TheAllocator->Free(reinterpret_cast<uint8_t*>(Resent));
+    Data        = nullptr;
+    Retransmits = nullptr;
+    Resent      = nullptr;
+
+    RetransmitCapacity = 0;
+    ResentCapacity     = 0;
+}
+
+
+//------------------------------------------------------------------------------
+// Encoder
+
+Encoder::Encoder()
+{
+    Window.TheAllocator = &TheAllocator;
+    Window.Stats        = &Stats;
+    Ack.TheAllocator    = &TheAllocator;
+    Ack.TheWindow       = &Window;
+}
+
+Encoder::~Encoder()
+{
+    // Stop the worker before the window it reads goes away
+    StopPreEncode();
+
+    for (EncoderAcknowledgementState* receiver : Receivers)
+        TheAllocator.Destruct(receiver);
+}
+
+SiameseResult Encoder::AddPacket(
+    SiameseOriginalPacket& packet,
+    const SiameseIOVec* vecs,
+    unsigned vecCount,
+    SiameseReleaseCallback release,
+    void* releaseContext)
+{
+    // Note: This does not wait for the worker to finish a packet that would not cover the new data
+    std::unique_lock<std::mutex> locker = LockPreEncodeForAdd();
+
+    const SiameseResult result = Window.Add(packet, vecs, vecCount, release, releaseContext);
+
+    if (PreEncodeDepth > 0)
+    {
+        // Ready packets do not cover the new data, so start over
+        if (result == Siamese_Success)
+            DiscardPreEncoded();
+
+        // Resume the worker if it was interrupted
+        PreEncodeCondition.notify_one();
+    }
+
+    return result;
+}
+
+SiameseResult Encoder::AddOwned(SiameseOriginalPacket& packet, SiameseReleaseCallback release, void* releaseContext)
+{
+#ifdef GF256_ALIGNED_ACCESSES
+    // The math requires aligned buffers, so copy the packet and release it right away
+    const SiameseResult result = AddPacket(packet, nullptr, 0, nullptr, nullptr);
+    if (result == Siamese_Success)
+        release(releaseContext, packet.Data);
+    return result;
+#else // GF256_ALIGNED_ACCESSES
+    return AddPacket(packet, nullptr, 0, release, releaseContext);
+#endif // GF256_ALIGNED_ACCESSES
+}
+
+SiameseResult Encoder::SetPreEncode(unsigned depth)
+{
+    SIAMESE_DEBUG_ASSERT(depth <= SIAMESE_MAX_PRE_ENCODE);
+
+    if (depth <= 0)
+    {
+        StopPreEncode();
+        return Siamese_Success;
+    }
+
+    // If the worker is already running:
+    if (PreEncodeThread.joinable())
+    {
+        std::lock_guard<std::mutex> locker(PreEncodeLock);
+
+        // Drop ready packets beyond the new depth, newest first
+        while (PreEncodedCount > depth)
+        {
+            const PreEncodedPacket& ready = PreEncoded[(PreEncodedHead + PreEncodedCount - 1) % SIAMESE_MAX_PRE_ENCODE];
+            Stats.Counts[SiameseEncoderStats_RecoveryCount]--;
+            Stats.Counts[SiameseEncoderStats_RecoveryBytes] -= ready.Packet.DataBytes;
+            --PreEncodedCount;
+        }
+
+        PreEncodeDepth = depth;
+        PreEncodeCondition.notify_one();
+        return Siamese_Success;
+    }
+
+    PreEncodeDepth      = depth;
+    PreEncodeTerminated = false;
+
+    try
+    {
+        PreEncodeThread = std::thread(&Encoder::PreEncodeLoop, this);
+    }
+    catch (...)
+    {
+        PreEncodeDepth = 0;
+        return Siamese_Disabled;
+    }
+
+    return Siamese_Success;
+}
+
+void Encoder::StopPreEncode()
+{
+    if (!PreEncodeThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> locker(PreEncodeLock);
+        PreEncodeTerminated = true;
+        PreEncodeCondition.notify_one();
+    }
+
+    PreEncodeThread.join();
+
+    DiscardPreEncoded();
+    PreEncodeDepth = 0;
+}
+
+void Encoder::DiscardPreEncoded()
+{
+    // Note: Their rows are skipped, which the decoder handles like lost packets
+    for (unsigned i = 0; i < PreEncodedCount; ++i)
+    {
+        const PreEncodedPacket& ready = PreEncoded[(PreEncodedHead + i) % SIAMESE_MAX_PRE_ENCODE];
+        Stats.Counts[SiameseEncoderStats_RecoveryCount]--;
+        Stats.Counts[SiameseEncoderStats_RecoveryBytes] -= ready.Packet.DataBytes;
+    }
+
+    PreEncodedHead  = 0;
+    PreEncodedCount = 0;
+}
+
+void Encoder::PreEncodeLoop()
+{
+    std::unique_lock<std::mutex> locker(PreEncodeLock);
+
+    while (!PreEncodeTerminated)
+    {
+        // If there is nothing to do right now:
+        if (PreEncodedCount >= PreEncodeDepth ||
+            Window.Count <= 0 ||
+            Window.EmergencyDisabled ||
+            IsPreEncodeInterrupted(true))
+        {
+            PreEncodeCondition.wait(locker);
+            continue;
+        }
+
+        PreEncodedPacket& ready = PreEncoded[(PreEncodedHead + PreEncodedCount) % SIAMESE_MAX_PRE_ENCODE];
+
+        // Note: If new data is waiting to be added, this gives up and waits for it
+        const SiameseResult result = GenerateRecovery(&ready.Packet, 1, &ready.Buffer, nullptr, true);
+        if (result != Siamese_Success)
+        {
+            PreEncodeCondition.wait(locker);
+            continue;
+        }
+
+        SIAMESE_DEBUG_ASSERT(ready.Packet.Data == ready.Buffer.Data);
+        ++PreEncodedCount;
+
+        // Let the application in between packets
+        locker.unlock();
+        std::this_thread::yield();
+        locker.lock();
+    }
+}
+
+void Encoder::RemoveBefore(unsigned firstKeptColumn)
+{
+    std::unique_lock<std::mutex> locker = LockPreEncode();
 
-    return true;
+    Window.RemoveBefore(firstKeptColumn);
+
+    // Ready packets only cover data that no longer needs protection
+    if (Window.Count <= 0)
+        DiscardPreEncoded();
 }
 
-bool EncoderAcknowledgementState::GetNextLossColumn(unsigned& columnOut)
+EncoderAcknowledgementState* Encoder::AddReceiver()
 {
-    if (LossCount <= 0)
-    {
-        // Note: LossColumn is used as the offset for the next loss range, so
-        // we should increment it to one beyond the end of the current region
-        // when we get to the end of the region.
-        LossColumn = IncrementColumn1(LossColumn);
+    std::unique_lock<std::mutex> locker = LockPreEncode();
 
-        if (!DecodeNextRange())
-            return false;
-    }
+    // The default receiver only holds data it has NACKed, so it cannot share the window
+    if (Ack.Acknowledged)
+        return nullptr;
 
-    columnOut = LossColumn;
+    EncoderAcknowledgementState* receiver = TheAllocator.Construct<EncoderAcknowledgementState>();
+    if (!receiver)
+        return nullptr;
 
-    LossColumn = IncrementColumn1(LossColumn);
-    --LossCount;
+    receiver->TheAllocator = &TheAllocator;
+    receiver->TheWindow    = &Window;
+    Receivers.push_back(receiver);
 
-    return true;
+    return receiver;
 }
 
-void EncoderAcknowledgementState::RestartLossIterator()
+void Encoder::RemoveReceiver(EncoderAcknowledgementState* receiver)
 {
-    // Reset message decoder state
-    Offset     = 0;
-    LossColumn = NextColumnExpected;
-    LossCount  = 0;
+    std::unique_lock<std::mutex> locker = LockPreEncode();
 
-    DecodeNextRange();
-    // Note: Ignore return value
+    auto iter = std::find(Receivers.begin(), Receivers.end(), receiver);
+    if (iter == Receivers.end())
+    {
+        SIAMESE_DEBUG_BREAK(); // Invalid input
+        return;
+    }
+    Receivers.erase(iter);
+
+    receiver->Free();
+    TheAllocator.Destruct(receiver);
+
+    // The remaining receivers may have acknowledged more data
+    RemoveAcknowledged();
 }
 
-void EncoderAcknowledgementState::Clear()
+void Encoder::RemoveAcknowledged()
 {
-    // Reset message decoder state
-    Offset     = 0;
-    LossColumn = 0;
-    LossCount  = 0;
-    DataBytes  = 0;
-}
+    bool found = false;
+    unsigned firstKeptColumn = 0;
 
+    // Keep the data after the earliest column that any receiver still expects
+    const auto consider = [&found, &firstKeptColumn](const EncoderAcknowledgementState& receiver)
+    {
+        if (!found || IsColumnDeltaNegative(SubtractColumns(receiver.NextColumnExpected, firstKeptColumn)))
+            firstKeptColumn = receiver.NextColumnExpected;
+        found = true;
+    };
 
-//------------------------------------------------------------------------------
-// Encoder
+    // The default receiver only takes part once the application has used it.
+    // Note: It cannot be used while there are other receivers
+    if (Ack.Acknowledged)
+        consider(Ack);
 
-Encoder::Encoder()
-{
-    Window.TheAllocator = &TheAllocator;
-    Window.Stats        = &Stats;
-    Ack.TheAllocator    = &TheAllocator;
-    Ack.TheWindow       = &Window;
+    for (const EncoderAcknowledgementState* receiver : Receivers)
+    {
+        // A receiver that has not acknowledged anything yet may still need all of it
+        if (!receiver->Acknowledged)
+            return;
+        consider(*receiver);
+    }
+
+    if (!found)
+        return;
+
+    Window.RemoveBefore(firstKeptColumn);
+
+    // Ready packets only cover data that no longer needs protection
+    if (Window.Count <= 0)
+        DiscardPreEncoded();
 }
 
-SiameseResult Encoder::Acknowledge(const uint8_t* data, unsigned bytes)
+SiameseResult Encoder::Acknowledge(EncoderAcknowledgementState* receiver, const uint8_t* data, unsigned bytes)
 {
+    std::unique_lock<std::mutex> locker = LockPreEncode();
+
     if (Window.EmergencyDisabled)
         return Siamese_Disabled;
 
-    if (!Ack.OnAcknowledgementData(data, bytes))
+    EncoderAcknowledgementState* receiverState = GetReceiverState(receiver);
+    if (!receiverState)
+        return Siamese_InvalidInput;
+    EncoderAcknowledgementState& state = *receiverState;
+
+    const bool wasAcknowledged = state.Acknowledged;
+    const unsigned previousNextColumn = state.NextColumnExpected;
+
+    if (!state.OnAcknowledgementData(data, bytes))
         return Siamese_InvalidInput;
 
     Stats.Counts[SiameseEncoderStats_AckCount]++;
     Stats.Counts[SiameseEncoderStats_AckBytes] += bytes;
 
+    // The window can only shrink when this receiver has acknowledged more data
+    if (!wasAcknowledged || previousNextColumn != state.NextColumnExpected)
+        RemoveAcknowledged();
+
     return Siamese_Success;
 }
 
-SiameseResult Encoder::Retransmit(unsigned retransmitMsec, SiameseOriginalPacket& originalOut)
+SiameseResult Encoder::FindRetransmit(
+    EncoderAcknowledgementState& receiver,
+    unsigned retransmitMsec,
+    uint64_t nowMsec,
+    unsigned maxBytes,
+    SiameseOriginalPacket& originalOut)
 {
     originalOut.Data      = nullptr;
     originalOut.DataBytes = 0;
@@ -504,62 +1145,53 @@ SiameseResult Encoder::Retransmit(unsigned retransmitMsec, SiameseOriginalPacket
     if (Window.EmergencyDisabled)
         return Siamese_Disabled;
 
-    if (!Ack.HasNegativeAcknowledgements())
+    if (!receiver.HasNegativeAcknowledgements())
         return Siamese_NeedMoreData;
 
-    const uint64_t nowMsec = siamese::GetTimeMsec();
-
-    std::ostringstream* pDebugMsg = nullptr;
-    if (Logger.ShouldLog(logger::Level::Debug))
+    // While there is another lost packet to consider:
+    while (receiver.HasNegativeAcknowledgements())
     {
-        delete pDebugMsg;
-        pDebugMsg = new std::ostringstream();
-        *pDebugMsg << "Encoder NACK parsing: Columns resent recently = {";
-    }
+        const EncoderRetransmit& retransmit = receiver.GetRetransmitFront();
+        originalOut.PacketNum = retransmit.Column;
 
-    // While there is another loss column to process:
-    while (Ack.GetNextLossColumn(originalOut.PacketNum))
-    {
-        // Note: This also works when Count == 0
-        SIAMESE_DEBUG_ASSERT(originalOut.PacketNum >= Window.ColumnStart);
+        // If the packet was removed from the window since the acknowledgement:
         const unsigned element = Window.ColumnToElement(originalOut.PacketNum);
-        if (Window.InvalidElement(element))
+        if (Window.InvalidElement(element) || element < Window.FirstUnremovedElement)
         {
-            SIAMESE_DEBUG_BREAK(); // Should never happen
-            break;
+            receiver.PopRetransmit();
+            continue;
         }
 
-        // Return the packet data
         OriginalPacket* original = Window.GetWindowElement(element);
         if (original->Buffer.Bytes <= 0)
         {
             SIAMESE_DEBUG_BREAK(); // Should never happen
-            break;
-        }
-
-        // If the packet cannot be resent yet:
-        const uint64_t lastSendMsec = original->LastSendMsec;
-        const uint64_t deltaMsec    = nowMsec - lastSendMsec;
-        if (deltaMsec < retransmitMsec)
-        {
-            if (pDebugMsg)
-                *pDebugMsg << " " << originalOut.PacketNum;
+            receiver.PopRetransmit();
             continue;
         }
 
-        if (pDebugMsg)
+        // If the packet sent longest ago cannot be resent yet, then none of them can:
+        const uint64_t deltaMsec = nowMsec - retransmit.LastSendMsec;
+        if (deltaMsec < retransmitMsec)
         {
-            *pDebugMsg << " }. Found next column to retransmit: " << originalOut.PacketNum;
-            Logger.Debug(pDebugMsg->str());
+            Logger.Debug("Encoder NACK: Oldest column ", originalOut.PacketNum, " was resent ", deltaMsec, " msec ago");
+            break;
         }
 
-        // Update last send time
-        original->LastSendMsec = nowMsec;
+        Logger.Debug("Encoder NACK: Found next column to retransmit: ", originalOut.PacketNum);
 
         const unsigned headerBytes = original->HeaderBytes;
         SIAMESE_DEBUG_ASSERT(headerBytes > 0 && original->Buffer.Bytes > headerBytes);
         const unsigned length = original->Buffer.Bytes - headerBytes;
 
+        // If the packet does not fit in the output buffer:
+        // Note: It stays at the front to be found again by the next call
+        if (length > maxBytes)
+            return Siamese_InvalidInput;
+
+        // Update last send time and move it to the back of the queue
+        receiver.RequeueRetransmit(nowMsec);
+
 #ifdef SIAMESE_DEBUG
         // Check: Deserialize length from the front
         unsigned lengthCheck;
@@ -583,69 +1215,180 @@ SiameseResult Encoder::Retransmit(unsigned retransmitMsec, SiameseOriginalPacket
         return Siamese_Success;
     }
 
-    // Restart the iterator through loss ranges after this
-    Ack.RestartLossIterator();
+    return Siamese_NeedMoreData;
+}
+
+SiameseResult Encoder::RetransmitInto(
+    EncoderAcknowledgementState* receiver,
+    unsigned retransmitMsec,
+    uint8_t* buffer,
+    unsigned capacity,
+    unsigned headroom,
+    unsigned& packetNumOut,
+    unsigned& bytesOut)
+{
+    bytesOut = 0;
 
-    if (pDebugMsg)
+    if (headroom > capacity)
+        return Siamese_InvalidInput;
+
+    std::unique_lock<std::mutex> locker = LockPreEncode();
+
+    EncoderAcknowledgementState* state = GetReceiverState(receiver);
+    if (!state)
+        return Siamese_InvalidInput;
+
+    SiameseOriginalPacket original;
+    const SiameseResult result = FindRetransmit(*state, retransmitMsec, siamese::GetTimeMsec(), capacity - headroom, original);
+    if (result != Siamese_Success)
+        return result;
+
+    memcpy(buffer + headroom, original.Data, original.DataBytes);
+    packetNumOut = original.PacketNum;
+    bytesOut     = original.DataBytes;
+    return Siamese_Success;
+}
+
+SiameseResult Encoder::RetransmitBatch(
+    EncoderAcknowledgementState* receiver,
+    unsigned retransmitMsec,
+    SiameseOriginalPacket* originalsOut,
+    unsigned maxCount,
+    unsigned& countOut)
+{
+    countOut = 0;
+
+    std::unique_lock<std::mutex> locker = LockPreEncode();
+
+    EncoderAcknowledgementState* receiverState = GetReceiverState(receiver);
+    if (!receiverState)
+        return Siamese_InvalidInput;
+    EncoderAcknowledgementState& state = *receiverState;
+
+    const uint64_t nowMsec = siamese::GetTimeMsec();
+
+    // Each resent packet goes to the back of the queue, so stop after visiting
+    // the entries that were queued on entry to avoid returning one twice
+    unsigned unvisited = state.RetransmitCount;
+
+    while (unvisited > 0 && countOut < maxCount)
     {
-        *pDebugMsg << " }. Restarted loss range iterator";
-        Logger.Debug(pDebugMsg->str());
+        const unsigned queuedBefore = state.RetransmitCount;
+
+        const SiameseResult result = FindRetransmit(state, retransmitMsec, nowMsec, SIAMESE_MAX_PACKET_BYTES, originalsOut[countOut]);
+        if (result != Siamese_Success)
+        {
+            if (result != Siamese_NeedMoreData)
+                return result;
+            break;
+        }
+        ++countOut;
+
+        // Entries dropped from the front plus the one that was requeued
+        const unsigned visited = queuedBefore - state.RetransmitCount + 1;
+        unvisited = (visited < unvisited) ? unvisited - visited : 0;
     }
 
-    return Siamese_NeedMoreData;
+    return (countOut > 0) ? Siamese_Success : Siamese_NeedMoreData;
 }
 
-void Encoder::AddDenseColumns(unsigned row, uint8_t* productWorkspace)
+bool Encoder::AddDenseColumns(
+    const unsigned* rows,
+    uint8_t* const* recovery,
+    uint8_t* const* productWorkspace,
+    unsigned count,
+    bool preEncode)
 {
     const unsigned recoveryBytes = Window.LongestPacket;
+    static const unsigned kLaneSumCount = kColumnLaneCount * kColumnSumCount;
 
-    // For each lane:
-    for (unsigned laneIndex = 0; laneIndex < kColumnLaneCount; ++laneIndex)
+    // Lane sums to add for each row
+    const RowSumPlan* plans[SIAMESE_MAX_ENCODE_BATCH];
+
+    // Lane sums used by any row, indexed by laneIndex * kColumnSumCount + sumIndex
+    bool sumUsed[kLaneSumCount] = {};
+    for (unsigned i = 0; i < count; ++i)
     {
-        // Compute the operations to run for this lane and row
-        unsigned opcode = GetRowOpcode(laneIndex, row);
+        const RowSumPlan& plan = GetRowSumPlan(rows[i]);
+        plans[i] = &plan;
+        for (unsigned k = 0; k < plan.RecoveryCount; ++k)
+            sumUsed[plan.Recovery[k]] = true;
+        for (unsigned k = 0; k < plan.ProductCount; ++k)
+            sumUsed[plan.Product[k]] = true;
+    }
 
-        // For summations into the RecoveryPacket buffer:
-        unsigned mask = 1;
-        for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
-        {
-            if (opcode & mask)
-            {
-                const GrowingAlignedDataBuffer* sum = Window.GetSum(laneIndex, sumIndex, Window.Count);
-                unsigned addBytes = sum->Bytes;
-                if (addBytes > 0)
-                {
-                    if (addBytes > recoveryBytes)
-                        addBytes = recoveryBytes;
-                    gf256_add_mem(RecoveryPacket.Data, sum->Data, addBytes);
-                }
-            }
-            mask <<= 1;
-        }
+    const uint8_t* sumData[kLaneSumCount];
+    unsigned sumBytes[kLaneSumCount];
+    for (unsigned laneSum = 0; laneSum < kLaneSumCount; ++laneSum)
+    {
+        sumData[laneSum]  = nullptr;
+        sumBytes[laneSum] = 0;
+        if (!sumUsed[laneSum])
+            continue;
 
-        // For summations into the ProductWorkspace buffer:
-        for (unsigned sumIndex = 0; sumIndex < kColumnSumCount; ++sumIndex)
+        // Note: Sums accumulated so far are kept for the next packet
+        if (IsPreEncodeInterrupted(preEncode))
+            return false;
+
+        const GrowingAlignedDataBuffer* sum = Window.GetSum(
+            laneSum / kColumnSumCount, laneSum % kColumnSumCount, Window.Count);
+        unsigned addBytes = sum->Bytes;
+        if (addBytes > recoveryBytes)
+            addBytes = recoveryBytes;
+
+        sumData[laneSum]  = sum->Data;
+        sumBytes[laneSum] = addBytes;
+    }
+
+    // Work through the packets one chunk at a time so that the chunks of all
+    // the rows in a batch stay in cache while the sums are read for each row.
+    // The worker also uses chunks so it can be interrupted between them
+    unsigned chunkBytes = pktalloc::NextAlignedOffset(kEncodeBatchCacheBytes / (2 * count));
+    if (chunkBytes < kEncodeBatchMinChunkBytes)
+        chunkBytes = kEncodeBatchMinChunkBytes;
+    if ((count <= 1 && !preEncode) || chunkBytes > recoveryBytes)
+        chunkBytes = recoveryBytes;
+
+    for (unsigned offset = 0; offset < recoveryBytes; offset += chunkBytes)
+    {
+        if (IsPreEncodeInterrupted(preEncode))
+            return false;
+
+        // Queue the part of a lane sum that overlaps this chunk
+        const auto addChunk = [&](MultiplyAddBatch& batch, unsigned laneSum)
         {
-            if (opcode & mask)
-            {
-                const GrowingAlignedDataBuffer* sum = Window.GetSum(laneIndex, sumIndex, Window.Count);
-                unsigned addBytes = sum->Bytes;
-                if (addBytes > 0)
-                {
-                    if (addBytes > recoveryBytes)
-                        addBytes = recoveryBytes;
-                    gf256_add_mem(productWorkspace, sum->Data, addBytes);
-                }
-            }
-            mask <<= 1;
+            const unsigned addBytes = sumBytes[laneSum];
+            if (addBytes <= offset)
+                return;
+            unsigned bytes = addBytes - offset;
+            if (bytes > chunkBytes)
+                bytes = chunkBytes;
+            batch.Add(1, sumData[laneSum] + offset, bytes);
+        };
+
+        // Add all the sums for each destination in a single pass over it
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const RowSumPlan& plan = *plans[i];
+
+            MultiplyAddBatch recoveryBatch(recovery[i] + offset);
+            for (unsigned k = 0; k < plan.RecoveryCount; ++k)
+                addChunk(recoveryBatch, plan.Recovery[k]);
+            recoveryBatch.Flush();
+
+            MultiplyAddBatch productBatch(productWorkspace[i] + offset);
+            for (unsigned k = 0; k < plan.ProductCount; ++k)
+                addChunk(productBatch, plan.Product[k]);
+            productBatch.Flush();
         }
     }
 
     // Keep track of where the sum ended
     Window.SumEndElement = Window.Count;
+    return true;
 }
 
-void Encoder::AddLightColumns(unsigned row, uint8_t* productWorkspace)
+bool Encoder::AddLightColumns(unsigned row, uint8_t* recovery, uint8_t* productWorkspace, bool preEncode)
 {
     const unsigned startElement = Window.FirstUnremovedElement;
     SIAMESE_DEBUG_ASSERT(Window.SumEndElement >= startElement);
@@ -667,6 +1410,12 @@ void Encoder::AddLightColumns(unsigned row, uint8_t* productWorkspace)
     const unsigned pairCount = (count + kPairAddRate - 1) / kPairAddRate;
     for (unsigned i = 0; i < pairCount; ++i)
     {
+        if (IsPreEncodeInterrupted(preEncode))
+        {
+            delete pDebugMsg;
+            return false;
+        }
+
         const unsigned element1          = startElement + (prng.Next() % count);
         const OriginalPacket* original1  = Window.GetWindowElement(element1);
         const unsigned elementRX         = startElement + (prng.Next() % count);
@@ -680,23 +1429,75 @@ void Encoder::AddLightColumns(unsigned row, uint8_t* productWorkspace)
         SIAMESE_DEBUG_ASSERT(Window.LongestPacket >= original1->Buffer.Bytes);
         SIAMESE_DEBUG_ASSERT(Window.LongestPacket >= originalRX->Buffer.Bytes);
 
-        gf256_add_mem(RecoveryPacket.Data, original1->Buffer.Data,  original1->Buffer.Bytes);
-        gf256_add_mem(productWorkspace,    originalRX->Buffer.Data, originalRX->Buffer.Bytes);
+        RowAddMem(recovery,         original1->Buffer.Data,  original1->Buffer.Bytes);
+        RowAddMem(productWorkspace, originalRX->Buffer.Data, originalRX->Buffer.Bytes);
     }
 
     if (pDebugMsg)
+    {
         Logger.Debug(pDebugMsg->str());
+        delete pDebugMsg;
+    }
+    return true;
+}
+
+SiameseResult Encoder::EncodeBatch(SiameseRecoveryPacket* recoveryOut, unsigned count)
+{
+    SIAMESE_DEBUG_ASSERT(count >= 1 && count <= SIAMESE_MAX_ENCODE_BATCH);
+
+    std::unique_lock<std::mutex> locker = LockPreEncode();
+
+    if (Window.EmergencyDisabled)
+        return Siamese_Disabled;
+
+    // Hand out packets the worker has ready first
+    unsigned taken = 0;
+    while (taken < count && PreEncodedCount > 0)
+    {
+        PreEncodedPacket& ready = PreEncoded[PreEncodedHead];
+
+        // Keep the data valid until the next call, like generated packets
+        std::swap(RecoveryPackets[taken], ready.Buffer);
+        recoveryOut[taken] = ready.Packet;
+
+        PreEncodedHead = (PreEncodedHead + 1) % SIAMESE_MAX_PRE_ENCODE;
+        --PreEncodedCount;
+        ++taken;
+    }
+
+    if (taken <= 0)
+        return GenerateRecovery(recoveryOut, count, RecoveryPackets, nullptr, false);
+
+    PreEncodeCondition.notify_one();
+
+    if (taken < count)
+        return GenerateRecovery(recoveryOut + taken, count - taken, RecoveryPackets + taken, nullptr, false);
+
+    // Remove any data from the window at this point, since the worker does not
+    if (Window.FirstUnremovedElement >= kEncoderRemoveThreshold)
+        Window.RemoveElements();
+
+    return Siamese_Success;
 }
 
-SiameseResult Encoder::Encode(SiameseRecoveryPacket& packet)
+SiameseResult Encoder::GenerateRecovery(
+    SiameseRecoveryPacket* packets,
+    unsigned count,
+    GrowingAlignedDataBuffer* buffers,
+    uint8_t* dest,
+    bool preEncode)
 {
+    SIAMESE_DEBUG_ASSERT(count >= 1 && count <= SIAMESE_MAX_ENCODE_BATCH);
+    SIAMESE_DEBUG_ASSERT(!dest || count == 1);
+
     if (Window.EmergencyDisabled)
         return Siamese_Disabled;
 
     // If there are no packets so far:
     if (Window.Count <= 0)
     {
-        packet.DataBytes = 0;
+        for (unsigned i = 0; i < count; ++i)
+            packets[i].DataBytes = 0;
         return Siamese_NeedMoreData;
     }
 
@@ -705,7 +1506,22 @@ SiameseResult Encoder::Encode(SiameseRecoveryPacket& packet)
 
     // If there is only a single packet so far:
     if (unacknowledgedCount == 1)
-        return GenerateSinglePacket(packet);
+    {
+        // Note: Every packet in the batch is the same
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const SiameseResult result = GenerateSinglePacket(packets[i], buffers[i], preEncode);
+            if (result != Siamese_Success)
+                return result;
+        }
+        return Siamese_Success;
+    }
+
+    // Note: The choice below does not change between packets of a batch, because
+    // generating a packet leaves the window in a state that makes the same choice.
+#ifdef SIAMESE_ENABLE_CAUCHY
+    bool useCauchy = false;
+#endif // SIAMESE_ENABLE_CAUCHY
 
     // Calculate upper bound on width of sum for this recovery packet
     SIAMESE_DEBUG_ASSERT(Window.Count + Window.SumErasedCount >= Window.SumStartElement);
@@ -718,12 +1534,16 @@ SiameseResult Encoder::Encode(SiameseRecoveryPacket& packet)
 #ifdef SIAMESE_ENABLE_CAUCHY
         // If the number of packets in flight is small enough, use Cauchy rows for now:
         if (unacknowledgedCount <= SIAMESE_CAUCHY_THRESHOLD)
-            return GenerateCauchyPacket(packet);
+            useCauchy = true;
+        else
 #endif // SIAMESE_ENABLE_CAUCHY
+        {
+            Logger.Debug("Resetting sums at element ", Window.FirstUnremovedElement);
 
-        Logger.Debug("Resetting sums at element ", Window.FirstUnremovedElement);
-
-        Window.ResetSums(Window.FirstUnremovedElement);
+            Window.ResetSums(Window.FirstUnremovedElement);
+            if (Window.EmergencyDisabled)
+                return Siamese_Disabled;
+        }
     }
 #ifdef SIAMESE_ENABLE_CAUCHY
     else
@@ -738,58 +1558,176 @@ SiameseResult Encoder::Encode(SiameseRecoveryPacket& packet)
             // Stop using sums
             Window.SumEndElement = Window.SumStartElement;
 
-            return GenerateCauchyPacket(packet);
+            useCauchy = true;
+        }
+    }
+
+    if (useCauchy)
+    {
+        for (unsigned i = 0; i < count; ++i)
+        {
+            uint8_t* recovery = dest;
+            if (!recovery)
+            {
+                // Reset recovery packet
+                GrowingAlignedDataBuffer& buffer = buffers[i];
+                if (!buffer.Initialize(&TheAllocator, Window.LongestPacket + kMaxRecoveryMetadataBytes))
+                {
+                    Window.EmergencyDisabled = true;
+                    return Siamese_Disabled;
+                }
+                recovery = buffer.Data;
+            }
+
+            const SiameseResult result = GenerateCauchyPacket(packets[i], recovery);
+            if (result != Siamese_Success)
+                return result;
         }
+        return Siamese_Success;
     }
 #endif // SIAMESE_ENABLE_CAUCHY
 
-    // Remove any data from the window at this point
-    if (Window.FirstUnremovedElement >= kEncoderRemoveThreshold)
+    // Remove any data from the window at this point.
+    // Note: The worker leaves this to the application thread, which may still
+    // be using removed packets or expecting release callbacks
+    if (!preEncode && Window.FirstUnremovedElement >= kEncoderRemoveThreshold)
         Window.RemoveElements();
 
-    // Advance row index
-    const unsigned row = NextRow;
-    if (++NextRow >= kRowPeriod)
-        NextRow = 0;
-
-    // Reset workspaces
     const unsigned recoveryBytes = Window.LongestPacket;
     const unsigned alignedBytes  = pktalloc::NextAlignedOffset(recoveryBytes);
-    if (!RecoveryPacket.Initialize(&TheAllocator, 2 * alignedBytes + kMaxRecoveryMetadataBytes))
+
+    // Note: Zero-initialized because the compiler cannot prove that count >= 1
+    unsigned rows[SIAMESE_MAX_ENCODE_BATCH] = {};
+    uint8_t* recovery[SIAMESE_MAX_ENCODE_BATCH] = {};
+    uint8_t* productWorkspace[SIAMESE_MAX_ENCODE_BATCH] = {};
+
+    for (unsigned i = 0; i < count; ++i)
     {
-        Window.EmergencyDisabled = true;
-        return Siamese_Disabled;
+        // Advance row index
+        rows[i] = NextRow;
+        if (++NextRow >= kRowPeriod)
+            NextRow = 0;
+
+        // Reset workspaces
+        GrowingAlignedDataBuffer& buffer = buffers[i];
+        if (dest)
+        {
+            // Only the product workspace is internal
+            if (!buffer.Initialize(&TheAllocator, alignedBytes))
+            {
+                Window.EmergencyDisabled = true;
+                return Siamese_Disabled;
+            }
+            memset(buffer.Data, 0, alignedBytes);
+            memset(dest, 0, recoveryBytes);
+            recovery[i]         = dest;
+            productWorkspace[i] = buffer.Data;
+            continue;
+        }
+        if (!buffer.Initialize(&TheAllocator, 2 * alignedBytes + kMaxRecoveryMetadataBytes))
+        {
+            Window.EmergencyDisabled = true;
+            return Siamese_Disabled;
+        }
+        SIAMESE_DEBUG_ASSERT(buffer.Bytes >= alignedBytes * 2);
+        memset(buffer.Data, 0, alignedBytes * 2);
+        recovery[i]         = buffer.Data;
+        productWorkspace[i] = buffer.Data + alignedBytes;
     }
-    SIAMESE_DEBUG_ASSERT(RecoveryPacket.Bytes >= alignedBytes * 2);
-    memset(RecoveryPacket.Data, 0, alignedBytes * 2);
-    uint8_t* productWorkspace = RecoveryPacket.Data + alignedBytes;
-
-    // Generate the recovery packet
-    AddDenseColumns(row, productWorkspace);
-    AddLightColumns(row, productWorkspace);
 
-    // RecoveryPacket += RX * ProductWorkspace
-    const uint8_t RX = GetRowValue(row);
-    gf256_muladd_mem(RecoveryPacket.Data, RX, productWorkspace, recoveryBytes);
+    // Generate the recovery packets
+    if (!AddDenseColumns(rows, recovery, productWorkspace, count, preEncode))
+        return Siamese_NeedMoreData;
 
     RecoveryMetadata metadata;
     SIAMESE_DEBUG_ASSERT(Window.SumEndElement + Window.SumErasedCount >= Window.SumStartElement);
     metadata.SumCount = Window.SumEndElement - Window.SumStartElement + Window.SumErasedCount;
     metadata.LDPCCount   = unacknowledgedCount;
     metadata.ColumnStart = Window.SumColumnStart;
-    metadata.Row         = row;
 
-    // Serialize metadata into the last few bytes of the packet
-    // Note: This saves an extra copy to move the data around
-    const unsigned footerBytes = SerializeFooter_RecoveryMetadata(metadata, RecoveryPacket.Data + recoveryBytes);
-    packet.Data      = RecoveryPacket.Data;
-    packet.DataBytes = recoveryBytes + footerBytes;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const unsigned row = rows[i];
 
-    Stats.Counts[SiameseEncoderStats_RecoveryCount]++;
-    Stats.Counts[SiameseEncoderStats_RecoveryBytes] += packet.DataBytes;
+        if (!AddLightColumns(row, recovery[i], productWorkspace[i], preEncode))
+            return Siamese_NeedMoreData;
+
+        // RecoveryPacket += RX * ProductWorkspace
+        const uint8_t RX = GetRowValue(row);
+        RowMulAddMem(recovery[i], RX, productWorkspace[i], recoveryBytes);
+
+        metadata.Row = row;
+
+        // Serialize metadata into the last few bytes of the packet
+        // Note: This saves an extra copy to move the data around
+        const unsigned footerBytes = SerializeFooter_RecoveryMetadata(metadata, recovery[i] + recoveryBytes);
+        packets[i].Data      = recovery[i];
+        packets[i].DataBytes = recoveryBytes + footerBytes;
+
+        Stats.Counts[SiameseEncoderStats_RecoveryCount]++;
+        Stats.Counts[SiameseEncoderStats_RecoveryBytes] += packets[i].DataBytes;
+
+        Logger.Info("Generated Siamese sum recovery packet start=", metadata.ColumnStart, " ldpcCount=", metadata.LDPCCount, " sumCount=", metadata.SumCount, " row=", metadata.Row);
+    }
+
+    return Siamese_Success;
+}
+
+SiameseResult Encoder::EncodeInto(uint8_t* buffer, unsigned capacity, unsigned headroom, unsigned& bytesOut)
+{
+    static_assert(kMaxPacketLengthFieldBytes + kMaxRecoveryMetadataBytes <= SIAMESE_ENCODE_INTO_OVERHEAD, "Update this");
+
+    bytesOut = 0;
+
+    std::unique_lock<std::mutex> locker = LockPreEncode();
+
+    // Require room for the largest possible recovery packet
+    if (headroom > capacity ||
+        capacity - headroom < Window.LongestPacket + kMaxRecoveryMetadataBytes)
+    {
+        return Siamese_InvalidInput;
+    }
+
+    // If the worker has a packet ready that fits:
+    if (PreEncodedCount > 0 &&
+        !Window.EmergencyDisabled &&
+        PreEncoded[PreEncodedHead].Packet.DataBytes <= capacity - headroom)
+    {
+        const PreEncodedPacket& ready = PreEncoded[PreEncodedHead];
+        memcpy(buffer + headroom, ready.Packet.Data, ready.Packet.DataBytes);
+        bytesOut = ready.Packet.DataBytes;
+
+        PreEncodedHead = (PreEncodedHead + 1) % SIAMESE_MAX_PRE_ENCODE;
+        --PreEncodedCount;
+        PreEncodeCondition.notify_one();
 
-    Logger.Info("Generated Siamese sum recovery packet start=", metadata.ColumnStart, " ldpcCount=", metadata.LDPCCount, " sumCount=", metadata.SumCount, " row=", metadata.Row);
+        // Remove any data from the window at this point, since the worker does not
+        if (Window.FirstUnremovedElement >= kEncoderRemoveThreshold)
+            Window.RemoveElements();
 
+        return Siamese_Success;
+    }
+
+    uint8_t* dest = buffer + headroom;
+#ifdef GF256_ALIGNED_ACCESSES
+    // The math requires aligned buffers, so generate the packet internally and copy it
+    if ((uintptr_t)dest % GF256_ALIGN_BYTES != 0)
+        dest = nullptr;
+#endif // GF256_ALIGNED_ACCESSES
+
+    SiameseRecoveryPacket packet;
+    const SiameseResult result = GenerateRecovery(&packet, 1, RecoveryPackets, dest, false);
+    if (result != Siamese_Success)
+        return result;
+
+    // If the packet was not generated in place (e.g. only one packet in flight):
+    if (packet.Data != buffer + headroom)
+    {
+        SIAMESE_DEBUG_ASSERT(packet.DataBytes <= capacity - headroom);
+        memcpy(buffer + headroom, packet.Data, packet.DataBytes);
+    }
+
+    bytesOut = packet.DataBytes;
     return Siamese_Success;
 }
 
@@ -797,6 +1735,8 @@ SiameseResult Encoder::Get(SiameseOriginalPacket& packetOut)
 {
     // Note: Keep this in sync with Decoder::Get
 
+    std::unique_lock<std::mutex> locker = LockPreEncode();
+
     if (Window.EmergencyDisabled)
         return Siamese_Disabled;
 
@@ -843,20 +1783,37 @@ SiameseResult Encoder::Get(SiameseOriginalPacket& packetOut)
     return Siamese_Success;
 }
 
-SiameseResult Encoder::GenerateSinglePacket(SiameseRecoveryPacket& packet)
+SiameseResult Encoder::GenerateSinglePacket(SiameseRecoveryPacket& packet, GrowingAlignedDataBuffer& buffer, bool copy)
 {
     OriginalPacket* original     = Window.GetWindowElement(Window.FirstUnremovedElement);
     const unsigned originalBytes = original->Buffer.Bytes;
+    uint8_t* data;
 
-    // Note: This often does not actually reallocate or move since we overallocate
-    if (!original->Buffer.GrowZeroPadded(&TheAllocator, originalBytes + kMaxRecoveryMetadataBytes))
+    // If the buffer belongs to the application or must not be grown:
+    if (original->Release || copy)
     {
-        Window.EmergencyDisabled = true;
-        return Siamese_Disabled;
+        // Copy the packet since there is no room to append the metadata
+        if (!buffer.Initialize(&TheAllocator, originalBytes + kMaxRecoveryMetadataBytes))
+        {
+            Window.EmergencyDisabled = true;
+            return Siamese_Disabled;
+        }
+        memcpy(buffer.Data, original->Buffer.Data, originalBytes);
+        data = buffer.Data;
     }
+    else
+    {
+        // Note: This often does not actually reallocate or move since we overallocate
+        if (!original->Buffer.GrowZeroPadded(&TheAllocator, originalBytes + kMaxRecoveryMetadataBytes))
+        {
+            Window.EmergencyDisabled = true;
+            return Siamese_Disabled;
+        }
 
-    // Set bytes back to original
-    original->Buffer.Bytes = originalBytes;
+        // Set bytes back to original
+        original->Buffer.Bytes = originalBytes;
+        data = original->Buffer.Data;
+    }
 
     // Serialize metadata into the last few bytes of the packet
     // Note: This saves an extra copy to move the data around
@@ -866,8 +1823,8 @@ SiameseResult Encoder::GenerateSinglePacket(SiameseRecoveryPacket& packet)
     metadata.ColumnStart = original->Column;
     metadata.Row         = 0;
 
-    const unsigned footerBytes = SerializeFooter_RecoveryMetadata(metadata, original->Buffer.Data + originalBytes);
-    packet.Data      = original->Buffer.Data;
+    const unsigned footerBytes = SerializeFooter_RecoveryMetadata(metadata, data + originalBytes);
+    packet.Data      = data;
     packet.DataBytes = originalBytes + footerBytes;
 
     Logger.Info("Generated single recovery packet start=", metadata.ColumnStart, " ldpcCount=", metadata.LDPCCount, " sumCount=", metadata.SumCount, " row=", metadata.Row);
@@ -881,16 +1838,18 @@ SiameseResult Encoder::GenerateSinglePacket(SiameseRecoveryPacket& packet)
 
 #ifdef SIAMESE_ENABLE_CAUCHY
 
-SiameseResult Encoder::GenerateCauchyPacket(SiameseRecoveryPacket& packet)
+// Note: This walks every unacknowledged original for each packet rather than
+// keeping running row accumulators.  A Cauchy element 1/(X(i) + Y(j)) does not
+// split into a row factor times a column factor like the Siamese sums, and each
+// packet takes the next row so that packets with overlapping windows stay
+// independent.  An accumulator for a row would need the whole window folded in
+// when the row comes up, which costs as much as generating it here.  A running
+// parity row would not save anything either: it is sent about once per window
+// of columns, and each column would still be folded in and back out once.
+SiameseResult Encoder::GenerateCauchyPacket(SiameseRecoveryPacket& packet, uint8_t* recovery)
 {
-    // Reset recovery packet
     const unsigned firstElement  = Window.FirstUnremovedElement;
     const unsigned recoveryBytes = Window.LongestPacket;
-    if (!RecoveryPacket.Initialize(&TheAllocator, recoveryBytes + kMaxRecoveryMetadataBytes))
-    {
-        Window.EmergencyDisabled = true;
-        return Siamese_Disabled;
-    }
 
     const unsigned unacknowledgedCount = Window.GetUnacknowledgedCount();
     RecoveryMetadata metadata;
@@ -916,26 +1875,28 @@ SiameseResult Encoder::GenerateCauchyPacket(SiameseRecoveryPacket& packet)
         OriginalPacket* original = Window.GetWindowElement(firstElement);
         unsigned originalBytes   = original->Buffer.Bytes;
 
-        memcpy(RecoveryPacket.Data, original->Buffer.Data, originalBytes);
+        memcpy(recovery, original->Buffer.Data, originalBytes);
         // Pad the rest out with zeroes to avoid corruption
-        SIAMESE_DEBUG_ASSERT(RecoveryPacket.Bytes >= originalBytes);
-        memset(RecoveryPacket.Data + originalBytes, 0, recoveryBytes - originalBytes);
+        SIAMESE_DEBUG_ASSERT(recoveryBytes >= originalBytes);
+        memset(recovery + originalBytes, 0, recoveryBytes - originalBytes);
 
         usedBytes = originalBytes;
 
         // For each remaining column:
+        MultiplyAddBatch batch(recovery);
         for (unsigned element = firstElement + 1, count = Window.Count; element < count; ++element)
         {
             original      = Window.GetWindowElement(element);
             originalBytes = original->Buffer.Bytes;
 
-            SIAMESE_DEBUG_ASSERT(RecoveryPacket.Bytes >= originalBytes);
+            SIAMESE_DEBUG_ASSERT(recoveryBytes >= originalBytes);
 
-            gf256_add_mem(RecoveryPacket.Data, original->Buffer.Data, originalBytes);
+            batch.Add(1, original->Buffer.Data, originalBytes);
 
             if (usedBytes < originalBytes)
                 usedBytes = originalBytes;
         }
+        batch.Flush();
     }
     else
     {
@@ -951,15 +1912,15 @@ SiameseResult Encoder::GenerateCauchyPacket(SiameseRecoveryPacket& packet)
         uint8_t y                = CauchyElement(cauchyRow, cauchyColumn);
         unsigned originalBytes   = original->Buffer.Bytes;
 
-        gf256_mul_mem(RecoveryPacket.Data, original->Buffer.Data, y, originalBytes);
+        gf256_mul_mem(recovery, original->Buffer.Data, y, originalBytes);
         // Pad the rest out with zeroes to avoid corruption
         SIAMESE_DEBUG_ASSERT(recoveryBytes >= originalBytes);
-        SIAMESE_DEBUG_ASSERT(RecoveryPacket.Bytes >= originalBytes);
-        memset(RecoveryPacket.Data + originalBytes, 0, recoveryBytes - originalBytes);
+        memset(recovery + originalBytes, 0, recoveryBytes - originalBytes);
 
         usedBytes = originalBytes;
 
         // For each remaining column:
+        MultiplyAddBatch batch(recovery);
         for (unsigned element = firstElement + 1, count = Window.Count; element < count; ++element)
         {
             cauchyColumn  = (cauchyColumn + 1) % kCauchyMaxColumns;
@@ -967,19 +1928,20 @@ SiameseResult Encoder::GenerateCauchyPacket(SiameseRecoveryPacket& packet)
             originalBytes = original->Buffer.Bytes;
             y             = CauchyElement(cauchyRow, cauchyColumn);
 
-            SIAMESE_DEBUG_ASSERT(RecoveryPacket.Bytes >= originalBytes);
+            SIAMESE_DEBUG_ASSERT(recoveryBytes >= originalBytes);
 
-            gf256_muladd_mem(RecoveryPacket.Data, y, original->Buffer.Data, originalBytes);
+            batch.Add(y, original->Buffer.Data, originalBytes);
 
             if (usedBytes < originalBytes)
                 usedBytes = originalBytes;
         }
+        batch.Flush();
     }
 
     // Slap metadata footer on the end
-    const unsigned footerBytes = SerializeFooter_RecoveryMetadata(metadata, RecoveryPacket.Data + usedBytes);
+    const unsigned footerBytes = SerializeFooter_RecoveryMetadata(metadata, recovery + usedBytes);
 
-    packet.Data      = RecoveryPacket.Data;
+    packet.Data      = recovery;
     packet.DataBytes = usedBytes + footerBytes;
 
     Logger.Info("Generated Cauchy/parity recovery packet start=", metadata.ColumnStart, " ldpcCount=", metadata.LDPCCount, " sumCount=", metadata.SumCount, " row=", metadata.Row);
@@ -997,11 +1959,25 @@ SiameseResult Encoder::GetStatistics(uint64_t* statsOut, unsigned statsCount)
     if (statsCount > SiameseEncoderStats_Count)
         statsCount = SiameseEncoderStats_Count;
 
+    std::unique_lock<std::mutex> locker = LockPreEncode();
+
     // Fill in memory allocated
     Stats.Counts[SiameseEncoderStats_MemoryUsed] = TheAllocator.GetMemoryAllocatedBytes();
 
+    uint64_t counts[SiameseEncoderStats_Count];
+    for (unsigned i = 0; i < SiameseEncoderStats_Count; ++i)
+        counts[i] = Stats.Counts[i];
+
+    // Packets the worker has ready are not counted until they are handed out
+    for (unsigned i = 0; i < PreEncodedCount; ++i)
+    {
+        const PreEncodedPacket& ready = PreEncoded[(PreEncodedHead + i) % SIAMESE_MAX_PRE_ENCODE];
+        counts[SiameseEncoderStats_RecoveryCount]--;
+        counts[SiameseEncoderStats_RecoveryBytes] -= ready.Packet.DataBytes;
+    }
+
     for (unsigned i = 0; i < statsCount; ++i)
-        statsOut[i] = Stats.Counts[i];
+        statsOut[i] = counts[i];
 
     return Siamese_Success;
 }
@@ -38,6 +38,11 @@
 
 #include "SiameseCommon.h"
 
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
 
 namespace siamese {
 
@@ -65,21 +70,110 @@ struct EncoderStats
 };
 
 
+//------------------------------------------------------------------------------
+// EncoderLongestQueue
+//
+// Monotonic queue of the packets in a lane that may become the longest one as
+// packets are removed from the front of the window.  Packets are pushed at the
+// back, dropping any shorter packets in front of them since those can never be
+// the longest again.  Lengths decrease from front to back, so the front is the
+// longest packet left once removed packets are popped off the front.
+
+struct EncoderLongestQueue
+{
+    struct Entry
+    {
+        unsigned Column;
+        unsigned Bytes;
+    };
+
+    // Ring buffer of entries, with a power of two size
+    std::vector<Entry> Entries;
+
+    // Index of the front entry
+    unsigned Head = 0;
+
+    // Number of entries in the queue
+    unsigned Count = 0;
+
+
+    void Clear()
+    {
+        Head  = 0;
+        Count = 0;
+    }
+
+    // Add a packet at the back
+    void Push(unsigned column, unsigned bytes)
+    {
+        // Drop packets that are no longer than this one
+        const unsigned mask = (unsigned)Entries.size() - 1;
+        while (Count > 0 && Entries[(Head + Count - 1) & mask].Bytes <= bytes)
+            --Count;
+
+        // If the ring is full, double it and unwrap the entries
+        if (Count >= Entries.size())
+        {
+            std::vector<Entry> grown(Entries.empty() ? 16 : Entries.size() * 2);
+            for (unsigned i = 0; i < Count; ++i)
+                grown[i] = Entries[(Head + i) & mask];
+            Entries.swap(grown);
+            Head = 0;
+        }
+
+        Entries[(Head + Count) & ((unsigned)Entries.size() - 1)] = { column, bytes };
+        ++Count;
+    }
+
+    // Precondition: Count > 0
+    const Entry& Front() const
+    {
+        SIAMESE_DEBUG_ASSERT(Count > 0);
+        return Entries[Head];
+    }
+    void PopFront()
+    {
+        SIAMESE_DEBUG_ASSERT(Count > 0);
+        Head = (Head + 1) & ((unsigned)Entries.size() - 1);
+        --Count;
+    }
+
+    // Longest packet in the queue, or 0 if it is empty
+    unsigned Longest() const
+    {
+        return Count > 0 ? Entries[Head].Bytes : 0;
+    }
+};
+
+
 //------------------------------------------------------------------------------
 // EncoderColumnLane
 
 struct EncoderColumnLane
 {
-    // Next element to accumulate, once we get it from the application
-    unsigned NextElement[kColumnSumCount];
+    // Next element to accumulate, once we get it from the application.
+    // All of the sums in a lane are accumulated together so each original
+    // is only read once
+    unsigned NextElement = 0;
 
-    // Running sums.  See kColumnSumCount definition
+    // Running sums.  See kColumnSumCount definition.
+    // Bytes is the valid length of each sum, and the rest is known to be zero
     GrowingAlignedDataBuffer Sum[kColumnSumCount];
 
-    // Longest packet in this lane
+    // Prefix sums of the lane from PrefixStartElement up to SumStartElement.
+    // Sum + Base is the prefix sum up to NextElement, which is checkpointed
+    // at the start of each subwindow so the sums can be restarted from any
+    // element without accumulating the whole window again
+    GrowingAlignedDataBuffer Base[kColumnSumCount];
+    unsigned PrefixStartElement = 0;
+
+    // Longest packet in this lane from FirstUnremovedElement
     // Note: I think it's a win to keep this per-lane because if the
     // data size is highly variable we may reduce memory accesses
     unsigned LongestPacket = 0;
+
+    // Candidates for the longest packet after removing elements
+    EncoderLongestQueue Longest;
 };
 
 
@@ -90,6 +184,11 @@ struct EncoderSubwindow
 {
     // Original packets in this subwindow indexed by packet number
     std::array<OriginalPacket, kSubwindowSize> Originals;
+
+    // Prefix sums of each lane up to the first element of this subwindow.
+    // Only valid for lanes that have accumulated across the subwindow start
+    // since their PrefixStartElement
+    GrowingAlignedDataBuffer Checkpoints[kColumnLaneCount][kColumnSumCount];
 };
 
 
@@ -111,7 +210,8 @@ struct EncoderPacketWindow
     // Note: When Count == 0, this is undefined
     unsigned ColumnStart = 0;
 
-    // Longest packet
+    // Longest packet from FirstUnremovedElement to the end of the window,
+    // which is the size of the recovery packets
     // Note: Undefined if count == 0
     unsigned LongestPacket = 0;
 
@@ -135,10 +235,16 @@ struct EncoderPacketWindow
     // to prevent it from allowing exploits to run or cause crashes
     bool EmergencyDisabled = false;
 
+    // Fold new packets into running sums as they are added rather than on encode
+    bool EagerSums = false;
+
 
     // Ctor initializes elements to default values
     EncoderPacketWindow();
 
+    // Dtor returns any buffers that belong to the application
+    ~EncoderPacketWindow();
+
     // Convert a column to a window element
     SIAMESE_FORCE_INLINE unsigned ColumnToElement(unsigned column) const
     {
@@ -165,8 +271,19 @@ struct EncoderPacketWindow
         return &Subwindows[windowElement / kSubwindowSize]->Originals[windowElement % kSubwindowSize];
     }
 
-    // Append a packet to the end of the set
-    SiameseResult Add(SiameseOriginalPacket& packet);
+    // Append a packet to the end of the set.
+    // If vecs is not null, the packet data is gathered from vecs instead of packet.Data.
+    // If release is not null, the packet data is used in place and released later
+    SiameseResult Add(
+        SiameseOriginalPacket& packet,
+        const SiameseIOVec* vecs,
+        unsigned vecCount,
+        SiameseReleaseCallback release,
+        void* releaseContext);
+
+    // Return buffers that belong to the application for elements in [elementStart, elementEnd),
+    // which may be outside of the window
+    void ReleaseOwnedElements(unsigned elementStart, unsigned elementEnd);
 
     // Removes elements up to the given column
     void RemoveBefore(unsigned firstKeptColumn);
@@ -188,8 +305,27 @@ struct EncoderPacketWindow
     // Reset lane sums from the given start element
     void ResetSums(unsigned elementStart);
 
+    // Clear the sums for a lane so they start accumulating from the given element
+    void ClearLaneSums(unsigned laneIndex, unsigned elementStart);
+
+    // Store the prefix sums for a lane at the start of the given subwindow
+    bool CheckpointLaneSums(unsigned laneIndex, unsigned subwindowIndex);
+
+    // Restart the sums for a lane from the given start element, using the
+    // checkpoint of its subwindow rather than accumulating from scratch.
+    // Precondition: The lane checkpoint for the subwindow is valid and
+    // elementStart <= NextElement
+    bool RestartLaneSums(unsigned laneIndex, unsigned elementStart);
+
+    // Accumulate all of the running sums for a lane up to the given element
+    void AccumulateLaneSums(unsigned laneIndex, unsigned elementEnd);
+
     // Get running sums for a lane
-    const GrowingAlignedDataBuffer* GetSum(unsigned laneIndex, unsigned sumIndex, unsigned elementEnd);
+    const GrowingAlignedDataBuffer* GetSum(unsigned laneIndex, unsigned sumIndex, unsigned elementEnd)
+    {
+        AccumulateLaneSums(laneIndex, elementEnd);
+        return &Lanes[laneIndex].Sum[sumIndex];
+    }
 
     // Returns the number of elements that have not been acknowledged yet
     unsigned GetUnacknowledgedCount()
@@ -206,13 +342,27 @@ struct EncoderPacketWindow
 
     // Precondition: FirstUsedElement >= kSubwindowSize
     void RemoveElements();
+
+    // Shrink the longest packet lengths to cover only the elements that are
+    // still in flight, starting from FirstUnremovedElement
+    void UpdateLongestPacket();
 };
 
 
 //------------------------------------------------------------------------------
 // EncoderAcknowledgementState
 
-// State related to the last received acknowledgement
+// A lost column queued for retransmission
+struct EncoderRetransmit
+{
+    // Lost column
+    unsigned Column;
+
+    // Timestamp at which the column was last resent to this receiver, or 0
+    uint64_t LastSendMsec;
+};
+
+// State related to the last acknowledgement received from one receiver
 struct EncoderAcknowledgementState
 {
     pktalloc::Allocator* TheAllocator = nullptr;
@@ -239,32 +389,80 @@ struct EncoderAcknowledgementState
     // Next column expected by receiver
     unsigned NextColumnExpected = 0;
 
+    // Set once the first acknowledgement has been received
+    bool Acknowledged = false;
+
+
+    // Lost columns still in the window, in the order they should be resent.
+    // This is a ring of RetransmitSize columns ordered by LastSendMsec, oldest
+    // first.  Resent columns move to the back, which keeps it in order because
+    // they were just sent, so only the front ever needs to be checked
+    EncoderRetransmit* Retransmits = nullptr;
+    unsigned RetransmitCapacity = 0;
+    unsigned RetransmitSize  = 0;
+    unsigned RetransmitHead  = 0;
+    unsigned RetransmitCount = 0;
+
+    // Columns that were resent before the latest acknowledgement, in column
+    // order, used to carry their send times over to the new queue
+    EncoderRetransmit* Resent = nullptr;
+    unsigned ResentCapacity = 0;
 
-    // Returns true if retransmit is needed
-    bool IsRetransmitNeeded() const
-    {
-        return LossCount > 0;
-    }
 
     // Returns true if there are any negative acknowledgements
     bool HasNegativeAcknowledgements() const
     {
-        return DataBytes > 0;
+        return RetransmitCount > 0;
     }
 
     // Acknowledgement
     bool OnAcknowledgementData(const uint8_t* data, unsigned bytes);
     bool DecodeNextRange();
 
-    // Get next loss column
-    // Returns false if no more columns to read. Call RestartLossIterator() to restart the iteration
-    bool GetNextLossColumn(unsigned& columnOut);
+    // Queue the lost columns of the current loss range that are in the window
+    bool QueueLossRange();
+
+    // Copy the queued columns that have been resent into Resent, in column order.
+    // Returns the number of columns copied, or -1 on allocation failure
+    int SaveResent();
+
+    // Restore the send times saved by SaveResent() for the columns still lost
+    void RestoreResent(unsigned resentCount);
+
+    // Precondition: RetransmitCount > 0
+    EncoderRetransmit& GetRetransmitFront()
+    {
+        SIAMESE_DEBUG_ASSERT(RetransmitCount > 0);
+        return Retransmits[RetransmitHead];
+    }
+
+    // Drop the front column from the queue
+    void PopRetransmit()
+    {
+        SIAMESE_DEBUG_ASSERT(RetransmitCount > 0);
+        if (++RetransmitHead >= RetransmitSize)
+            RetransmitHead = 0;
+        --RetransmitCount;
+    }
 
-    // Reset the loss iterator to the start so we read through them all again
-    void RestartLossIterator();
+    // Move the front column to the back of the queue after resending it
+    void RequeueRetransmit(uint64_t nowMsec)
+    {
+        const unsigned column = GetRetransmitFront().Column;
+        PopRetransmit();
+        unsigned back = RetransmitHead + RetransmitCount;
+        if (back >= RetransmitSize)
+            back -= RetransmitSize;
+        Retransmits[back].Column       = column;
+        Retransmits[back].LastSendMsec = nowMsec;
+        ++RetransmitCount;
+    }
 
     // Clear the ack data
     void Clear();
+
+    // Return the buffers to the allocator
+    void Free();
 };
 
 
@@ -275,31 +473,105 @@ struct EncoderAcknowledgementState
 static const unsigned kEncoderRemoveThreshold = 2 * kSubwindowSize;
 static_assert(kEncoderRemoveThreshold % kSubwindowSize == 0, "It removes on window boundaries");
 
+// Bytes of workspace for all the packets in a batch to generate together from
+// the lane sums, which should fit in L1 cache alongside the sum data
+static const unsigned kEncodeBatchCacheBytes = 32 * 1024;
+
+// Smallest chunk of each packet to generate at a time, to amortize call overhead
+static const unsigned kEncodeBatchMinChunkBytes = 512;
+
 class Encoder
 {
 public:
     Encoder();
+    ~Encoder();
 
     // Add an original data packet to the encoder
     SiameseResult Add(SiameseOriginalPacket& packet)
     {
-        return Window.Add(packet);
+        return AddPacket(packet, nullptr, 0, nullptr, nullptr);
     }
 
-    // Remove original data packet up to the given column
-    void RemoveBefore(unsigned firstKeptColumn)
+    // Add an original data packet gathered from vecs to the encoder
+    SiameseResult AddV(SiameseOriginalPacket& packet, const SiameseIOVec* vecs, unsigned vecCount)
     {
-        Window.RemoveBefore(firstKeptColumn);
+        return AddPacket(packet, vecs, vecCount, nullptr, nullptr);
     }
 
+    // Add an original data packet to the encoder without copying it
+    SiameseResult AddOwned(SiameseOriginalPacket& packet, SiameseReleaseCallback release, void* releaseContext);
+
+    // Fold new packets into running sums as they are added rather than on encode
+    void SetEagerSums(bool enabled)
+    {
+        std::unique_lock<std::mutex> locker = LockPreEncode();
+        Window.EagerSums = enabled;
+    }
+
+    // Keep depth recovery packets ready on a worker thread, or stop it if depth is 0.
+    // Precondition: depth <= SIAMESE_MAX_PRE_ENCODE
+    SiameseResult SetPreEncode(unsigned depth);
+
+    // Remove original data packet up to the given column
+    void RemoveBefore(unsigned firstKeptColumn);
+
+    // Add another receiver that acknowledges the same window.
+    // Returns null on allocation failure, or if the default receiver has been used
+    EncoderAcknowledgementState* AddReceiver();
+
+    // Remove a receiver returned by AddReceiver()
+    void RemoveReceiver(EncoderAcknowledgementState* receiver);
+
+    // For the following functions, receiver is the receiver returned by
+    // AddReceiver(), or null for the default receiver.
+    // The default receiver returns Siamese_InvalidInput while other receivers exist
+
     // Process an acknowledgement from the decoder
-    SiameseResult Acknowledge(const uint8_t* data, unsigned bytes);
+    SiameseResult Acknowledge(EncoderAcknowledgementState* receiver, const uint8_t* data, unsigned bytes);
 
     // Retransmit an original packet in response to a NACK
-    SiameseResult Retransmit(unsigned retransmitMsec, SiameseOriginalPacket& originalOut);
+    SiameseResult Retransmit(
+        EncoderAcknowledgementState* receiver,
+        unsigned retransmitMsec,
+        SiameseOriginalPacket& originalOut)
+    {
+        std::unique_lock<std::mutex> locker = LockPreEncode();
+        EncoderAcknowledgementState* state = GetReceiverState(receiver);
+        if (!state)
+            return Siamese_InvalidInput;
+        return FindRetransmit(*state, retransmitMsec, siamese::GetTimeMsec(), SIAMESE_MAX_PACKET_BYTES, originalOut);
+    }
+
+    // Retransmit every eligible original packet, each at most once
+    SiameseResult RetransmitBatch(
+        EncoderAcknowledgementState* receiver,
+        unsigned retransmitMsec,
+        SiameseOriginalPacket* originalsOut,
+        unsigned maxCount,
+        unsigned& countOut);
+
+    // Retransmit an original packet into buffer after headroom bytes
+    SiameseResult RetransmitInto(
+        EncoderAcknowledgementState* receiver,
+        unsigned retransmitMsec,
+        uint8_t* buffer,
+        unsigned capacity,
+        unsigned headroom,
+        unsigned& packetNumOut,
+        unsigned& bytesOut);
 
     // Generate the next recovery packet for the data
-    SiameseResult Encode(SiameseRecoveryPacket& recoveryOut);
+    SiameseResult Encode(SiameseRecoveryPacket& recoveryOut)
+    {
+        return EncodeBatch(&recoveryOut, 1);
+    }
+
+    // Generate the next count recovery packets together.
+    // Precondition: 1 <= count <= SIAMESE_MAX_ENCODE_BATCH
+    SiameseResult EncodeBatch(SiameseRecoveryPacket* recoveryOut, unsigned count);
+
+    // Generate the next recovery packet into buffer after headroom bytes
+    SiameseResult EncodeInto(uint8_t* buffer, unsigned capacity, unsigned headroom, unsigned& bytesOut);
 
     // Get a packet in the set
     SiameseResult Get(SiameseOriginalPacket& packet);
@@ -307,10 +579,12 @@ public:
     // Allocate/Free memory block
     SIAMESE_FORCE_INLINE uint8_t* Allocate(unsigned bytes)
     {
+        std::unique_lock<std::mutex> locker = LockPreEncode();
         return TheAllocator.Allocate(bytes);
     }
     SIAMESE_FORCE_INLINE void Free(uint8_t *ptr)
     {
+        std::unique_lock<std::mutex> locker = LockPreEncode();
         TheAllocator.Free(ptr);
     }
 
@@ -318,6 +592,16 @@ public:
     SiameseResult GetStatistics(uint64_t* statsOut, unsigned statsCount);
 
 protected:
+    // A recovery packet generated ahead of time by the worker
+    struct PreEncodedPacket
+    {
+        // Owns the packet data
+        GrowingAlignedDataBuffer Buffer;
+
+        // Packet to hand out, pointing into Buffer
+        SiameseRecoveryPacket Packet;
+    };
+
     // When the allocator goes out of scope all our buffer allocations are freed
     pktalloc::Allocator TheAllocator;
 
@@ -327,11 +611,15 @@ protected:
     // Set of encoded packets in the sliding window
     EncoderPacketWindow Window;
 
-    // Acknowledgement state
+    // Acknowledgement state of the default receiver
     EncoderAcknowledgementState Ack;
 
-    // Keeps a copy of the last recovery packet to speed up generating the next one
-    GrowingAlignedDataBuffer RecoveryPacket;
+    // Acknowledgement state of other receivers sharing the window
+    std::vector<EncoderAcknowledgementState*> Receivers;
+
+    // Keeps a copy of the last recovery packets to speed up generating the next ones.
+    // Each packet in a batch gets its own buffer so they are all valid at once
+    GrowingAlignedDataBuffer RecoveryPackets[SIAMESE_MAX_ENCODE_BATCH];
 
     // Next row to generate for Siamese rows
     unsigned NextRow = 0;
@@ -344,17 +632,122 @@ protected:
     unsigned NextCauchyRow = 0;
 #endif // SIAMESE_ENABLE_CAUCHY
 
+    // Number of recovery packets the worker keeps ready, or 0 if not pre-encoding
+    unsigned PreEncodeDepth = 0;
+
+    // Ring of packets ready to hand out, oldest first
+    PreEncodedPacket PreEncoded[SIAMESE_MAX_PRE_ENCODE];
+    unsigned PreEncodedHead  = 0;
+    unsigned PreEncodedCount = 0;
+
+    // Held by the worker while it generates a packet, and by all other
+    // methods while the worker is running
+    std::mutex PreEncodeLock;
+
+    // Signaled when the worker has more work to do or should stop
+    std::condition_variable PreEncodeCondition;
+
+    // Set to stop the worker
+    bool PreEncodeTerminated = false;
+
+    // Set while new data is waiting to be added, so the worker gives up the
+    // packet it is generating rather than holding up the application
+    std::atomic<bool> PreEncodeInterrupted{ false };
+
+    // Worker thread generating packets ahead of time
+    std::thread PreEncodeThread;
+
+
+    // Lock the encoder if the worker is running, or return an empty lock
+    std::unique_lock<std::mutex> LockPreEncode()
+    {
+        if (!PreEncodeThread.joinable())
+            return std::unique_lock<std::mutex>();
+        return std::unique_lock<std::mutex>(PreEncodeLock);
+    }
+
+    // Lock the encoder to add data, interrupting the packet the worker is generating
+    std::unique_lock<std::mutex> LockPreEncodeForAdd()
+    {
+        if (!PreEncodeThread.joinable())
+            return std::unique_lock<std::mutex>();
+        PreEncodeInterrupted = true;
+        std::unique_lock<std::mutex> locker(PreEncodeLock);
+        PreEncodeInterrupted = false;
+        return locker;
+    }
+
+    // Returns true if the worker should give up the packet it is generating
+    bool IsPreEncodeInterrupted(bool preEncode) const
+    {
+        return preEncode && PreEncodeInterrupted.load(std::memory_order_relaxed);
+    }
 
-    // Normal case of generating recovery packet
-    void AddDenseColumns(unsigned row, uint8_t* productWorkspace);
-    void AddLightColumns(unsigned row, uint8_t* productWorkspace);
+    // Worker thread loop
+    void PreEncodeLoop();
+
+    // Stop the worker thread and discard any ready packets
+    void StopPreEncode();
+
+    // Discard ready packets that have not been handed out.
+    // Precondition: The encoder is locked
+    void DiscardPreEncoded();
+
+    // Add an original data packet, then discard ready packets that do not protect it
+    SiameseResult AddPacket(
+        SiameseOriginalPacket& packet,
+        const SiameseIOVec* vecs,
+        unsigned vecCount,
+        SiameseReleaseCallback release,
+        void* releaseContext);
+
+    // Returns the state of the given receiver, or null if the default receiver
+    // is requested while receivers from AddReceiver() exist
+    EncoderAcknowledgementState* GetReceiverState(EncoderAcknowledgementState* receiver)
+    {
+        if (receiver)
+            return receiver;
+        return Receivers.empty() ? &Ack : nullptr;
+    }
 
-    // Generate output for the case of a single input packet
-    SiameseResult GenerateSinglePacket(SiameseRecoveryPacket& packet);
+    // Remove data that every receiver has acknowledged
+    void RemoveAcknowledged();
+
+    // Find the next original packet to retransmit in response to a NACK.
+    // Returns Siamese_InvalidInput if it is longer than maxBytes
+    SiameseResult FindRetransmit(
+        EncoderAcknowledgementState& receiver,
+        unsigned retransmitMsec,
+        uint64_t nowMsec,
+        unsigned maxBytes,
+        SiameseOriginalPacket& originalOut);
+
+    // Generate the next count recovery packets into buffers[0..count-1].
+    // If dest is not null, a single packet is generated in place at dest when possible,
+    // which must have room for the longest packet plus kMaxRecoveryMetadataBytes.
+    // If preEncode is true, the packets are being generated on the worker thread,
+    // which must not modify or remove the original packets.
+    // Returns Siamese_NeedMoreData if the worker was interrupted to add new data
+    SiameseResult GenerateRecovery(
+        SiameseRecoveryPacket* packets,
+        unsigned count,
+        GrowingAlignedDataBuffer* buffers,
+        uint8_t* dest,
+        bool preEncode);
+
+    // Normal case of generating recovery packets.
+    // Each row i accumulates into recovery[i] and productWorkspace[i].
+    // Returns false if the worker was interrupted before finishing
+    bool AddDenseColumns(const unsigned* rows, uint8_t* const* recovery, uint8_t* const* productWorkspace, unsigned count, bool preEncode);
+    bool AddLightColumns(unsigned row, uint8_t* recovery, uint8_t* productWorkspace, bool preEncode);
+
+    // Generate output for the case of a single input packet.
+    // If copy is true or the original belongs to the application, the packet is copied into buffer
+    SiameseResult GenerateSinglePacket(SiameseRecoveryPacket& packet, GrowingAlignedDataBuffer& buffer, bool copy);
 
 #ifdef SIAMESE_ENABLE_CAUCHY
     // Generate output for the case of a small number of input packets
-    SiameseResult GenerateCauchyPacket(SiameseRecoveryPacket& packet);
+    SiameseResult GenerateCauchyPacket(SiameseRecoveryPacket& packet, uint8_t* recovery);
 #endif // SIAMESE_ENABLE_CAUCHY
 };
 
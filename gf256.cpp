@@ -28,19 +28,29 @@
 
 #include "gf256.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 
 //------------------------------------------------------------------------------
 // Self-Test
 //
-// This is executed during initialization to make sure the library is working
+// This is executed the first time each instruction set is selected to make
+// sure its kernels are working.  The tables are checked at compile time.
 
-static const unsigned kTestBufferBytes = 32 + 16 + 8 + 4 + 2 + 1;
-static const unsigned kTestBufferAllocated = 64;
+// Large enough to exercise the unrolled loops and every tail of the widest kernels
+static const unsigned kTestBufferBytes = 256 + 128 + 64 + 32 + 16 + 8 + 4 + 2 + 1;
+static const unsigned kTestBufferAllocated = 512;
 struct SelfTestBuffersT
 {
     GF256_ALIGNED uint8_t A[kTestBufferAllocated];
     GF256_ALIGNED uint8_t B[kTestBufferAllocated];
     GF256_ALIGNED uint8_t C[kTestBufferAllocated];
+    GF256_ALIGNED uint8_t D[kTestBufferAllocated];
 };
 static GF256_ALIGNED SelfTestBuffersT m_SelfTestBuffers;
 
@@ -55,32 +65,11 @@ static bool gf256_self_test()
     if ((uintptr_t)m_SelfTestBuffers.C % GF256_ALIGN_BYTES != 0)
         return false;
 
-    // Check multiplication/division
-    for (unsigned i = 0; i < 256; ++i)
-    {
-        for (unsigned j = 0; j < 256; ++j)
-        {
-            uint8_t prod = gf256_mul((uint8_t)i, (uint8_t)j);
-            if (i != 0 && j != 0)
-            {
-                uint8_t div1 = gf256_div(prod, (uint8_t)i);
-                if (div1 != j)
-                    return false;
-                uint8_t div2 = gf256_div(prod, (uint8_t)j);
-                if (div2 != i)
-                    return false;
-            }
-            else if (prod != 0)
-                return false;
-            if (j == 1 && prod != i)
-                return false;
-        }
-    }
-
     // Check for overruns
     m_SelfTestBuffers.A[kTestBufferBytes] = 0x5a;
     m_SelfTestBuffers.B[kTestBufferBytes] = 0x5a;
     m_SelfTestBuffers.C[kTestBufferBytes] = 0x5a;
+    m_SelfTestBuffers.D[kTestBufferBytes] = 0x5a;
 
     // Test gf256_add_mem()
     for (unsigned i = 0; i < kTestBufferBytes; ++i)
@@ -129,6 +118,28 @@ static bool gf256_self_test()
         if (m_SelfTestBuffers.A[i] != (expectedMulAdd ^ 0xff))
             return false;
 
+    // Test gf256_add_mem_stream()
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+    {
+        m_SelfTestBuffers.A[i] = 0x1f;
+        m_SelfTestBuffers.B[i] = 0xf7;
+    }
+    gf256_add_mem_stream(m_SelfTestBuffers.A, m_SelfTestBuffers.B, kTestBufferBytes);
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+        if (m_SelfTestBuffers.A[i] != (0x1f ^ 0xf7))
+            return false;
+
+    // Test gf256_muladd_mem_stream()
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+    {
+        m_SelfTestBuffers.A[i] = 0xff;
+        m_SelfTestBuffers.B[i] = 0xaa;
+    }
+    gf256_muladd_mem_stream(m_SelfTestBuffers.A, 0x6c, m_SelfTestBuffers.B, kTestBufferBytes);
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+        if (m_SelfTestBuffers.A[i] != (expectedMulAdd ^ 0xff))
+            return false;
+
     // Test gf256_mul_mem()
     for (unsigned i = 0; i < kTestBufferBytes; ++i)
     {
@@ -141,12 +152,56 @@ static bool gf256_self_test()
         if (m_SelfTestBuffers.A[i] != expectedMul)
             return false;
 
+    // Test gf256_muladd_multi() with sources of different lengths
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+    {
+        m_SelfTestBuffers.A[i] = 0x0f;
+        m_SelfTestBuffers.B[i] = 0x55;
+        m_SelfTestBuffers.C[i] = 0xc3;
+    }
+    const uint8_t multiCoeffs[3] = { 0x6c, 1, 0xa2 };
+    const void* multiSrcs[3] = { m_SelfTestBuffers.B, m_SelfTestBuffers.C, m_SelfTestBuffers.C };
+    const unsigned multiLens[3] = { kTestBufferBytes, kTestBufferBytes / 3, kTestBufferBytes - 1 };
+    gf256_muladd_multi(m_SelfTestBuffers.A, multiCoeffs, multiSrcs, multiLens, 3);
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+    {
+        uint8_t expected = 0x0f ^ gf256_mul(0x55, 0x6c);
+        if (i < kTestBufferBytes / 3)
+            expected ^= 0xc3;
+        if (i < kTestBufferBytes - 1)
+            expected ^= gf256_mul(0xc3, 0xa2);
+        if (m_SelfTestBuffers.A[i] != expected)
+            return false;
+    }
+
+    // Test gf256_add_muladd2_mem()
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+    {
+        m_SelfTestBuffers.A[i] = 0x0f;
+        m_SelfTestBuffers.B[i] = 0x55;
+        m_SelfTestBuffers.C[i] = 0xc3;
+        m_SelfTestBuffers.D[i] = 0x9e;
+    }
+    gf256_add_muladd2_mem(m_SelfTestBuffers.A,
+        m_SelfTestBuffers.B, 0x6c,
+        m_SelfTestBuffers.C, 0xa2,
+        m_SelfTestBuffers.D, kTestBufferBytes);
+    const uint8_t expectedProd1 = 0x55 ^ gf256_mul(0x9e, 0x6c);
+    const uint8_t expectedProd2 = 0xc3 ^ gf256_mul(0x9e, 0xa2);
+    for (unsigned i = 0; i < kTestBufferBytes; ++i)
+        if (m_SelfTestBuffers.A[i] != (0x0f ^ 0x9e) ||
+            m_SelfTestBuffers.B[i] != expectedProd1 ||
+            m_SelfTestBuffers.C[i] != expectedProd2)
+            return false;
+
     if (m_SelfTestBuffers.A[kTestBufferBytes] != 0x5a)
         return false;
     if (m_SelfTestBuffers.B[kTestBufferBytes] != 0x5a)
         return false;
     if (m_SelfTestBuffers.C[kTestBufferBytes] != 0x5a)
         return false;
+    if (m_SelfTestBuffers.D[kTestBufferBytes] != 0x5a)
+        return false;
 
     return true;
 }
@@ -185,10 +240,26 @@ static bool gf256_self_test()
 #ifdef GF256_TRY_AVX2
 static bool CpuHasAVX2 = false;
 #endif
+#ifdef GF256_TRY_AVX512
+static bool CpuHasAVX512 = false;
+#endif
+#ifdef GF256_TRY_GFNI
+static bool CpuHasGFNI = false;
+#endif
 static bool CpuHasSSSE3 = false;
 
 #define CPUID_EBX_AVX2    0x00000020
+#define CPUID_EBX_AVX512F 0x00010000
+#define CPUID_EBX_AVX512BW 0x40000000
 #define CPUID_ECX_SSSE3   0x00000200
+#define CPUID_ECX_GFNI    0x00000100 /* Leaf 7 */
+#define CPUID_ECX_XSAVE   0x04000000
+#define CPUID_ECX_OSXSAVE 0x08000000
+#define CPUID_ECX_AVX     0x10000000
+
+#define XCR0_SSE          0x00000002
+#define XCR0_AVX          0x00000004
+#define XCR0_AVX512       0x000000e0 /* Opmask, ZMM_Hi256, Hi16_ZMM */
 
 static void _cpuid(unsigned int cpu_info[4U], const unsigned int cpu_info_type)
 {
@@ -227,6 +298,19 @@ static void _cpuid(unsigned int cpu_info[4U], const unsigned int cpu_info_type)
 #endif
 }
 
+// Returns the XCR0 register, which indicates which register state the OS saves
+static uint32_t _xgetbv0()
+{
+#if defined(_MSC_VER)
+    return (uint32_t)_xgetbv(0);
+#else
+    uint32_t xcr0_lo, xcr0_hi;
+    __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" /* XGETBV */
+                          : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0U));
+    return xcr0_lo;
+#endif
+}
+
 #endif // defined(GF256_TARGET_MOBILE)
 
 
@@ -254,8 +338,27 @@ static void gf256_architecture_init()
     CpuHasSSSE3 = ((cpu_info[2] & CPUID_ECX_SSSE3) != 0);
 
 #if defined(GF256_TRY_AVX2)
+    // The OS must also save the upper halves of the YMM registers
+    uint32_t xcr0 = 0;
+    const unsigned kOSXSAVE = CPUID_ECX_XSAVE | CPUID_ECX_OSXSAVE | CPUID_ECX_AVX;
+    if ((cpu_info[2] & kOSXSAVE) == kOSXSAVE)
+        xcr0 = _xgetbv0();
+    const bool osSavesYMM = (xcr0 & (XCR0_SSE | XCR0_AVX)) == (XCR0_SSE | XCR0_AVX);
+
     _cpuid(cpu_info, 7);
-    CpuHasAVX2 = ((cpu_info[1] & CPUID_EBX_AVX2) != 0);
+    CpuHasAVX2 = osSavesYMM && ((cpu_info[1] & CPUID_EBX_AVX2) != 0);
+
+#if defined(GF256_TRY_AVX512)
+    // The OS must also save the opmask registers and the full ZMM registers
+    const bool osSavesZMM = osSavesYMM && (xcr0 & XCR0_AVX512) == XCR0_AVX512;
+    const unsigned kAVX512 = CPUID_EBX_AVX512F | CPUID_EBX_AVX512BW;
+    CpuHasAVX512 = CpuHasAVX2 && osSavesZMM && ((cpu_info[1] & kAVX512) == kAVX512);
+#endif // GF256_TRY_AVX512
+
+#if defined(GF256_TRY_GFNI)
+    // The GFNI kernels use the VEX encoding, so they also need AVX2
+    CpuHasGFNI = CpuHasAVX2 && ((cpu_info[2] & CPUID_ECX_GFNI) != 0);
+#endif // GF256_TRY_GFNI
 #endif // GF256_TRY_AVX2
 
     // When AVX2 and SSSE3 are unavailable, Siamese takes 4x longer to decode
@@ -268,45 +371,32 @@ static void gf256_architecture_init()
 }
 
 
-//------------------------------------------------------------------------------
-// Context Object
-
-// Context object for GF(2^^8) math
-GF256_ALIGNED gf256_ctx GF256Ctx;
-static bool Initialized = false;
-
-
 //------------------------------------------------------------------------------
 // Generator Polynomial
 
 // There are only 16 irreducible polynomials for GF(2^^8)
 static const int GF256_GEN_POLY_COUNT = 16;
-static const uint8_t GF256_GEN_POLY[GF256_GEN_POLY_COUNT] = {
+static constexpr uint8_t GF256_GEN_POLY[GF256_GEN_POLY_COUNT] = {
     0x8e, 0x95, 0x96, 0xa6, 0xaf, 0xb1, 0xb2, 0xb4,
     0xb8, 0xc3, 0xc6, 0xd4, 0xe1, 0xe7, 0xf3, 0xfa
 };
 
 static const int kDefaultPolynomialIndex = 3;
 
-// Select which polynomial to use
-static void gf256_poly_init(int polynomialIndex)
-{
-    if (polynomialIndex < 0 || polynomialIndex >= GF256_GEN_POLY_COUNT)
-        polynomialIndex = kDefaultPolynomialIndex;
-
-    GF256Ctx.Polynomial = (GF256_GEN_POLY[polynomialIndex] << 1) | 1;
-}
-
 
 //------------------------------------------------------------------------------
 // Exponential and Log Tables
+//
+// The tables are generated by the compiler so that GF256Ctx is placed in
+// read-only memory, which every process using the library shares, and so
+// that gf256_init() does not need to build them.
 
 // Construct EXP and LOG tables from polynomial
-static void gf256_explog_init()
+static constexpr void gf256_explog_init(gf256_ctx& ctx)
 {
-    unsigned poly = GF256Ctx.Polynomial;
-    uint8_t* exptab = GF256Ctx.GF256_EXP_TABLE;
-    uint16_t* logtab = GF256Ctx.GF256_LOG_TABLE;
+    const unsigned poly = ctx.Polynomial;
+    uint8_t* exptab = ctx.GF256_EXP_TABLE;
+    uint16_t* logtab = ctx.GF256_LOG_TABLE;
 
     logtab[0] = 512;
     exptab[0] = 1;
@@ -324,69 +414,37 @@ static void gf256_explog_init()
     for (unsigned jj = 256; jj < 2 * 255; ++jj)
         exptab[jj] = exptab[jj % 255];
     exptab[2 * 255] = 1;
-    for (unsigned jj = 2 * 255 + 1; jj < 4 * 255; ++jj)
+    for (unsigned jj = 2 * 255 + 1; jj < 512 * 2 + 1; ++jj)
         exptab[jj] = 0;
 }
 
-
-//------------------------------------------------------------------------------
-// Multiply and Divide Tables
-
-// Initialize MUL and DIV tables using LOG and EXP tables
-static void gf256_muldiv_init()
+// Returns x * y using the EXP and LOG tables, like gf256_mul()
+static constexpr uint8_t gf256_ctx_mul(const gf256_ctx& ctx, unsigned x, unsigned y)
 {
-    // Allocate table memory 65KB x 2
-    uint8_t* m = GF256Ctx.GF256_MUL_TABLE;
-    uint8_t* d = GF256Ctx.GF256_DIV_TABLE;
-
-    // Unroll y = 0 subtable
-    for (int x = 0; x < 256; ++x)
-        m[x] = d[x] = 0;
-
-    // For each other y value:
-    for (int y = 1; y < 256; ++y)
-    {
-        // Calculate log(y) for mult and 255 - log(y) for div
-        const uint8_t log_y = static_cast<uint8_t>(GF256Ctx.GF256_LOG_TABLE[y]);
-        const uint8_t log_yn = 255 - log_y;
-
-        // Next subtable
-        m += 256, d += 256;
-
-        // Unroll x = 0
-        m[0] = 0, d[0] = 0;
-
-        // Calculate x * y, x / y
-        for (int x = 1; x < 256; ++x)
-        {
-            uint16_t log_x = GF256Ctx.GF256_LOG_TABLE[x];
-
-            m[x] = GF256Ctx.GF256_EXP_TABLE[log_x + log_y];
-            d[x] = GF256Ctx.GF256_EXP_TABLE[log_x + log_yn];
-        }
-    }
+    return ctx.GF256_EXP_TABLE[ctx.GF256_LOG_TABLE[x] + ctx.GF256_LOG_TABLE[y]];
 }
 
 
 //------------------------------------------------------------------------------
 // Inverse Table
 
-// Initialize INV table using DIV table
-static void gf256_inv_init()
+// Initialize INV table using LOG and EXP tables
+static constexpr void gf256_inv_init(gf256_ctx& ctx)
 {
-    for (int x = 0; x < 256; ++x)
-        GF256Ctx.GF256_INV_TABLE[x] = gf256_div(1, static_cast<uint8_t>(x));
+    ctx.GF256_INV_TABLE[0] = 0;
+    for (unsigned x = 1; x < 256; ++x)
+        ctx.GF256_INV_TABLE[x] = ctx.GF256_EXP_TABLE[255 - ctx.GF256_LOG_TABLE[x]];
 }
 
 
 //------------------------------------------------------------------------------
 // Square Table
 
-// Initialize SQR table using MUL table
-static void gf256_sqr_init()
+// Initialize SQR table using LOG and EXP tables
+static constexpr void gf256_sqr_init(gf256_ctx& ctx)
 {
-    for (int x = 0; x < 256; ++x)
-        GF256Ctx.GF256_SQR_TABLE[x] = gf256_mul(static_cast<uint8_t>(x), static_cast<uint8_t>(x));
+    for (unsigned x = 0; x < 256; ++x)
+        ctx.GF256_SQR_TABLE[x] = gf256_ctx_mul(ctx, x, x);
 }
 
 
@@ -413,6 +471,7 @@ static void gf256_sqr_init()
         z = TABLE_LO_y(x[0..3]) xor TABLE_HI_y(x[4..7])
 
     This means that we need 16 * 2 * 256 = 8192 bytes for precomputed tables.
+    The AVX2 and AVX-512 kernels broadcast each table into every 128-bit lane.
 
     Computing z[] = x[] * y can be performed 16 bytes at a time by using the
     128-bit register operations supported by modern processors.
@@ -481,50 +540,91 @@ static void gf256_sqr_init()
         Computes the bitwise XOR of the 128-bit value in a and the 128-bit value in b.
 */
 
-// Initialize the multiplication tables using gf256_mul()
-static void gf256_mul_mem_init()
-{
-    // Reuse aligned self test buffers to load table data
-    uint8_t* lo = m_SelfTestBuffers.A;
-    uint8_t* hi = m_SelfTestBuffers.B;
 
-    for (int y = 0; y < 256; ++y)
+// Initialize the multiplication tables using LOG and EXP tables
+static constexpr void gf256_mul_mem_init(gf256_ctx& ctx)
+{
+    for (unsigned y = 0; y < 256; ++y)
     {
         // TABLE_LO_Y maps 0..15 to 8-bit partial product based on y.
-        for (unsigned char x = 0; x < 16; ++x)
+        for (unsigned x = 0; x < 16; ++x)
         {
-            lo[x] = gf256_mul(x, static_cast<uint8_t>( y ));
-            hi[x] = gf256_mul(x << 4, static_cast<uint8_t>( y ));
+            ctx.MM128.TABLE_LO_Y[y][x] = gf256_ctx_mul(ctx, x, y);
+            ctx.MM128.TABLE_HI_Y[y][x] = gf256_ctx_mul(ctx, x << 4, y);
         }
 
-#if defined(GF256_TRY_NEON)
-        if (CpuHasNeon)
-        {
-            vst1q_u8(GF256Ctx.MM128_TABLE_LO_Y + y, vld1q_u8(lo));
-            vst1q_u8(GF256Ctx.MM128_TABLE_LO_Y + y, vst1q_u8(hi));
-        }
-#elif !defined(GF256_TARGET_MOBILE)
-        const GF256_M128 table_lo = _mm_loadu_si128((GF256_M128*)lo);
-        const GF256_M128 table_hi = _mm_loadu_si128((GF256_M128*)hi);
-        _mm_storeu_si128(GF256Ctx.MM128.TABLE_LO_Y + y, table_lo);
-        _mm_storeu_si128(GF256Ctx.MM128.TABLE_HI_Y + y, table_hi);
-# ifdef GF256_TRY_AVX2
-        if (CpuHasAVX2)
+#ifdef GF256_TRY_GFNI
+        // gf2p8affineqb computes output bit i as the parity of x AND the
+        // matrix byte (7 - i).  Bit j of that byte is bit i of y * 2^j,
+        // so the matrix works for whichever polynomial was selected
+        uint64_t matrix = 0;
+        for (unsigned i = 0; i < 8; ++i)
         {
-            const GF256_M256 table_lo2 = _mm256_broadcastsi128_si256(table_lo);
-            const GF256_M256 table_hi2 = _mm256_broadcastsi128_si256(table_hi);
-            _mm256_storeu_si256(GF256Ctx.MM256.TABLE_LO_Y + y, table_lo2);
-            _mm256_storeu_si256(GF256Ctx.MM256.TABLE_HI_Y + y, table_hi2);
+            unsigned row = 0;
+            for (unsigned j = 0; j < 8; ++j)
+                row |= ((gf256_ctx_mul(ctx, 1u << j, y) >> i) & 1) << j;
+            matrix |= static_cast<uint64_t>(row) << ((7 - i) * 8);
         }
-# endif // GF256_TRY_AVX2
-#endif // GF256_TARGET_MOBILE
+        ctx.GFNI.AFFINE_Y[y] = matrix;
+#endif // GF256_TRY_GFNI
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// Context Object
+
+static constexpr gf256_ctx gf256_make_ctx(int polynomialIndex)
+{
+    gf256_ctx ctx{};
+
+    ctx.Polynomial = (GF256_GEN_POLY[polynomialIndex] << 1) | 1;
+    gf256_explog_init(ctx);
+    gf256_inv_init(ctx);
+    gf256_sqr_init(ctx);
+    gf256_mul_mem_init(ctx);
+
+    return ctx;
+}
+
+// Context object for GF(2^^8) math
+GF256_ALIGNED constexpr gf256_ctx GF256Ctx = gf256_make_ctx(kDefaultPolynomialIndex);
+
+// Returns true if the tables describe a field
+static constexpr bool gf256_check_tables(const gf256_ctx& ctx)
+{
+    for (unsigned x = 1; x < 256; ++x)
+    {
+        // Every nonzero element must be a power of the generator
+        if (ctx.GF256_EXP_TABLE[ctx.GF256_LOG_TABLE[x]] != x)
+            return false;
+        if (gf256_ctx_mul(ctx, x, 0) != 0 || gf256_ctx_mul(ctx, 0, x) != 0)
+            return false;
+        if (gf256_ctx_mul(ctx, x, 1) != x)
+            return false;
+        if (gf256_ctx_mul(ctx, x, ctx.GF256_INV_TABLE[x]) != 1)
+            return false;
+        if (ctx.GF256_SQR_TABLE[x] != gf256_ctx_mul(ctx, x, x))
+            return false;
     }
+
+    // Multiplication must distribute over the low and high 4 bits of x
+    for (unsigned y = 0; y < 256; ++y)
+        for (unsigned x = 0; x < 256; ++x)
+            if ((ctx.MM128.TABLE_LO_Y[y][x & 15] ^ ctx.MM128.TABLE_HI_Y[y][x >> 4]) != gf256_ctx_mul(ctx, x, y))
+                return false;
+
+    return true;
 }
 
+static_assert(gf256_check_tables(GF256Ctx), "GF(2^^8) tables are invalid");
+
 
 //------------------------------------------------------------------------------
 // Initialization
 
+static bool Initialized = false;
+
 static unsigned char LittleEndianTestData[4] = { 4, 3, 2, 1 };
 static bool IsLittleEndian()
 {
@@ -545,165 +645,53 @@ extern "C" int gf256_init_(int version)
         return -2; // Architecture is not supported (code won't work without mods).
 
     gf256_architecture_init();
-    gf256_poly_init(kDefaultPolynomialIndex);
-    gf256_explog_init();
-    gf256_muldiv_init();
-    gf256_inv_init();
-    gf256_sqr_init();
-    gf256_mul_mem_init();
 
-    if (!gf256_self_test())
-        return -3; // Self-test failed (perhaps untested configuration)
+    // Select the fastest instruction set whose kernels pass the self-test.
+    // The others are only tested if they are selected later
+    for (int isa = GF256_ISA_COUNT - 1; isa >= GF256_ISA_PORTABLE; --isa)
+        if (gf256_set_isa(isa) == 0)
+            return 0;
 
-    return 0;
+    return -3; // Self-test failed (perhaps untested configuration)
 }
 
 
 //------------------------------------------------------------------------------
-// Operations
-
-extern "C" void gf256_add_mem(void * GF256_RESTRICT vx,
-                              const void * GF256_RESTRICT vy, int bytes)
-{
-    GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<GF256_M128 *>(vx);
-    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128 *>(vy);
-
-#if defined(GF256_TARGET_MOBILE)
-# if defined(GF256_TRY_NEON)
-    // Handle multiples of 64 bytes
-    if (CpuHasNeon)
-    {
-        while (bytes >= 64)
-        {
-            GF256_M128 x0 = vld1q_u8(x16);
-            GF256_M128 x1 = vld1q_u8(x16 + 1);
-            GF256_M128 x2 = vld1q_u8(x16 + 2);
-            GF256_M128 x3 = vld1q_u8(x16 + 3);
-            GF256_M128 y0 = vld1q_u8(y16);
-            GF256_M128 y1 = vld1q_u8(y16 + 1);
-            GF256_M128 y2 = vld1q_u8(y16 + 2);
-            GF256_M128 y3 = vld1q_u8(y16 + 3);
-
-            vst1q_u8(x16,     veorq_u8(x0, y0));
-            vst1q_u8(x16 + 1, veorq_u8(x1, y1));
-            vst1q_u8(x16 + 2, veorq_u8(x2, y2));
-            vst1q_u8(x16 + 3, veorq_u8(x3, y3));
-
-            bytes -= 64, x16 += 4, y16 += 4;
-        }
-
-        // Handle multiples of 16 bytes
-        while (bytes >= 16)
-        {
-            GF256_M128 x0 = vld1q_u8(x16);
-            GF256_M128 y0 = vld1q_u8(y16);
-
-            vst1q_u8(x16, veorq_u8(x0, y0));
-
-            bytes -= 16, ++x16, ++y16;
-        }
-    }
-    else
-# endif // GF256_TRY_NEON
-    {
-        uint64_t * GF256_RESTRICT x8 = reinterpret_cast<uint64_t *>(x16);
-        const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(y16);
-
-        const unsigned count = (unsigned)bytes / 8;
-        for (unsigned ii = 0; ii < count; ++ii)
-            x8[ii] ^= y8[ii];
-
-        x16 = reinterpret_cast<GF256_M128 *>(x8 + count);
-        y16 = reinterpret_cast<const GF256_M128 *>(y8 + count);
-    }
-#else // GF256_TARGET_MOBILE
-# if defined(GF256_TRY_AVX2)
-    if (CpuHasAVX2)
-    {
-        GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<GF256_M256 *>(x16);
-        const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(y16);
-
-        while (bytes >= 128)
-        {
-            GF256_M256 x0 = _mm256_loadu_si256(x32);
-            GF256_M256 y0 = _mm256_loadu_si256(y32);
-            x0 = _mm256_xor_si256(x0, y0);
-            GF256_M256 x1 = _mm256_loadu_si256(x32 + 1);
-            GF256_M256 y1 = _mm256_loadu_si256(y32 + 1);
-            x1 = _mm256_xor_si256(x1, y1);
-            GF256_M256 x2 = _mm256_loadu_si256(x32 + 2);
-            GF256_M256 y2 = _mm256_loadu_si256(y32 + 2);
-            x2 = _mm256_xor_si256(x2, y2);
-            GF256_M256 x3 = _mm256_loadu_si256(x32 + 3);
-            GF256_M256 y3 = _mm256_loadu_si256(y32 + 3);
-            x3 = _mm256_xor_si256(x3, y3);
-
-            _mm256_storeu_si256(x32, x0);
-            _mm256_storeu_si256(x32 + 1, x1);
-            _mm256_storeu_si256(x32 + 2, x2);
-            _mm256_storeu_si256(x32 + 3, x3);
-
-            bytes -= 128, x32 += 4, y32 += 4;
-        }
-
-        // Handle multiples of 32 bytes
-        while (bytes >= 32)
-        {
-            // x[i] = x[i] xor y[i]
-            _mm256_storeu_si256(x32,
-                _mm256_xor_si256(
-                    _mm256_loadu_si256(x32),
-                    _mm256_loadu_si256(y32)));
-
-            bytes -= 32, ++x32, ++y32;
-        }
+// Kernels
+//
+// Each bulk memory operation is implemented once for each instruction set.
+// The x86 kernels are compiled with target attributes rather than relying on
+// build flags like -mavx2, so a portable build still uses the widest kernels
+// the CPU supports.
+//
+// Special cases for y = 0 and y = 1 are handled by the exported functions at
+// the bottom of this file, so the multiply kernels can assume y >= 2.
 
-        x16 = reinterpret_cast<GF256_M128 *>(x32);
-        y16 = reinterpret_cast<const GF256_M128 *>(y32);
-    }
-    else
-# endif // GF256_TRY_AVX2
-    {
-        while (bytes >= 64)
-        {
-            GF256_M128 x0 = _mm_loadu_si128(x16);
-            GF256_M128 y0 = _mm_loadu_si128(y16);
-            x0 = _mm_xor_si128(x0, y0);
-            GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
-            GF256_M128 y1 = _mm_loadu_si128(y16 + 1);
-            x1 = _mm_xor_si128(x1, y1);
-            GF256_M128 x2 = _mm_loadu_si128(x16 + 2);
-            GF256_M128 y2 = _mm_loadu_si128(y16 + 2);
-            x2 = _mm_xor_si128(x2, y2);
-            GF256_M128 x3 = _mm_loadu_si128(x16 + 3);
-            GF256_M128 y3 = _mm_loadu_si128(y16 + 3);
-            x3 = _mm_xor_si128(x3, y3);
-
-            _mm_storeu_si128(x16, x0);
-            _mm_storeu_si128(x16 + 1, x1);
-            _mm_storeu_si128(x16 + 2, x2);
-            _mm_storeu_si128(x16 + 3, x3);
-
-            bytes -= 64, x16 += 4, y16 += 4;
-        }
-    }
+#if !defined(GF256_TARGET_MOBILE)
+# if defined(_MSC_VER) && !defined(__clang__)
+    // MSVC allows intrinsics for any instruction set without extra flags
+    #define GF256_TARGET_SSSE3
+    #define GF256_TARGET_AVX2
+    #define GF256_TARGET_AVX512
+    #define GF256_TARGET_GFNI_AVX2
+    #define GF256_TARGET_GFNI_AVX512
+# else
+    #define GF256_TARGET_SSSE3 __attribute__((target("ssse3")))
+    #define GF256_TARGET_AVX2 __attribute__((target("avx2")))
+    #define GF256_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512bw")))
+    #define GF256_TARGET_GFNI_AVX2 __attribute__((target("avx2,gfni")))
+    #define GF256_TARGET_GFNI_AVX512 __attribute__((target("avx2,avx512f,avx512bw,gfni")))
+# endif
 #endif // GF256_TARGET_MOBILE
 
-    // Handle multiples of 16 bytes
-    while (bytes >= 16)
-    {
-        // x[i] = x[i] xor y[i]
-        _mm_storeu_si128(x16,
-            _mm_xor_si128(
-                _mm_loadu_si128(x16),
-                _mm_loadu_si128(y16)));
-
-        bytes -= 16, ++x16, ++y16;
-    }
 
-    uint8_t * GF256_RESTRICT x1 = reinterpret_cast<uint8_t *>(x16);
-    const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(y16);
+//------------------------------------------------------------------------------
+// Portable Kernels
 
+// Performs "x[] += y[]" for the final 0..15 bytes
+static GF256_FORCE_INLINE void gf256_add_mem_tail(uint8_t * GF256_RESTRICT x1,
+                                                  const uint8_t * GF256_RESTRICT y1, int bytes)
+{
     // Handle a block of 8 bytes
     const int eight = bytes & 8;
     if (eight)
@@ -734,92 +722,46 @@ extern "C" void gf256_add_mem(void * GF256_RESTRICT vx,
     }
 }
 
-extern "C" void gf256_add2_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
-                               const void * GF256_RESTRICT vy, int bytes)
+// Performs "z[] += x[] + y[]" for the final 0..15 bytes
+static GF256_FORCE_INLINE void gf256_add2_mem_tail(uint8_t * GF256_RESTRICT z1, const uint8_t * GF256_RESTRICT x1,
+                                                   const uint8_t * GF256_RESTRICT y1, int bytes)
 {
-    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128*>(vz);
-    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128*>(vx);
-    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128*>(vy);
-
-#if defined(GF256_TARGET_MOBILE)
-# if defined(GF256_TRY_NEON)
-    // Handle multiples of 64 bytes
-    if (CpuHasNeon)
+    // Handle a block of 8 bytes
+    const int eight = bytes & 8;
+    if (eight)
     {
-        // Handle multiples of 16 bytes
-        while (bytes >= 16)
-        {
-            // z[i] = z[i] xor x[i] xor y[i]
-            vst1q_u8(z16,
-                veorq_u8(
-                    vld1q_u8(z16),
-                    veorq_u8(
-                        vld1q_u8(x16),
-                        vld1q_u8(y16))));
-
-            bytes -= 16, ++x16, ++y16, ++z16;
-        }
+        uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z1);
+        const uint64_t * GF256_RESTRICT x8 = reinterpret_cast<const uint64_t *>(x1);
+        const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(y1);
+        *z8 ^= *x8 ^ *y8;
     }
-    else
-# endif // GF256_TRY_NEON
-    {
-        uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z16);
-        const uint64_t * GF256_RESTRICT x8 = reinterpret_cast<const uint64_t *>(x16);
-        const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(y16);
-
-        const unsigned count = (unsigned)bytes / 8;
-        for (unsigned ii = 0; ii < count; ++ii)
-            z8[ii] ^= x8[ii] ^ y8[ii];
 
-        z16 = reinterpret_cast<GF256_M128 *>(z8 + count);
-        x16 = reinterpret_cast<const GF256_M128 *>(x8 + count);
-        y16 = reinterpret_cast<const GF256_M128 *>(y8 + count);
-    }
-#else // GF256_TARGET_MOBILE
-# if defined(GF256_TRY_AVX2)
-    if (CpuHasAVX2)
+    // Handle a block of 4 bytes
+    const int four = bytes & 4;
+    if (four)
     {
-        GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(z16);
-        const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(x16);
-        const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(y16);
-
-        const unsigned count = bytes / 32;
-        for (unsigned i = 0; i < count; ++i)
-        {
-            _mm256_storeu_si256(z32 + i,
-                _mm256_xor_si256(
-                    _mm256_loadu_si256(z32 + i),
-                    _mm256_xor_si256(
-                        _mm256_loadu_si256(x32 + i),
-                        _mm256_loadu_si256(y32 + i))));
-        }
-
-        bytes -= count * 32;
-        z16 = reinterpret_cast<GF256_M128 *>(z32 + count);
-        x16 = reinterpret_cast<const GF256_M128 *>(x32 + count);
-        y16 = reinterpret_cast<const GF256_M128 *>(y32 + count);
+        uint32_t * GF256_RESTRICT z4 = reinterpret_cast<uint32_t *>(z1 + eight);
+        const uint32_t * GF256_RESTRICT x4 = reinterpret_cast<const uint32_t *>(x1 + eight);
+        const uint32_t * GF256_RESTRICT y4 = reinterpret_cast<const uint32_t *>(y1 + eight);
+        *z4 ^= *x4 ^ *y4;
     }
-# endif // GF256_TRY_AVX2
 
-    // Handle multiples of 16 bytes
-    while (bytes >= 16)
+    // Handle final bytes
+    const int offset = eight + four;
+    switch (bytes & 3)
     {
-        // z[i] = z[i] xor x[i] xor y[i]
-        _mm_storeu_si128(z16,
-            _mm_xor_si128(
-                _mm_loadu_si128(z16),
-                _mm_xor_si128(
-                    _mm_loadu_si128(x16),
-                    _mm_loadu_si128(y16))));
-
-        bytes -= 16, ++x16, ++y16, ++z16;
+    case 3: z1[offset + 2] ^= x1[offset + 2] ^ y1[offset + 2];
+    case 2: z1[offset + 1] ^= x1[offset + 1] ^ y1[offset + 1];
+    case 1: z1[offset] ^= x1[offset] ^ y1[offset];
+    default:
+        break;
     }
-#endif // GF256_TARGET_MOBILE
-
-    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(z16);
-    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(x16);
-    const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(y16);
+}
 
+// Performs "z[] = x[] + y[]" for the final 0..15 bytes
+static GF256_FORCE_INLINE void gf256_addset_mem_tail(uint8_t * GF256_RESTRICT z1, const uint8_t * GF256_RESTRICT x1,
+                                                     const uint8_t * GF256_RESTRICT y1, int bytes)
+{
     // Handle a block of 8 bytes
     const int eight = bytes & 8;
     if (eight)
@@ -827,7 +769,7 @@ extern "C" void gf256_add2_mem(void * GF256_RESTRICT vz, const void * GF256_REST
         uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z1);
         const uint64_t * GF256_RESTRICT x8 = reinterpret_cast<const uint64_t *>(x1);
         const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(y1);
-        *z8 ^= *x8 ^ *y8;
+        *z8 = *x8 ^ *y8;
     }
 
     // Handle a block of 4 bytes
@@ -837,594 +779,3152 @@ extern "C" void gf256_add2_mem(void * GF256_RESTRICT vz, const void * GF256_REST
         uint32_t * GF256_RESTRICT z4 = reinterpret_cast<uint32_t *>(z1 + eight);
         const uint32_t * GF256_RESTRICT x4 = reinterpret_cast<const uint32_t *>(x1 + eight);
         const uint32_t * GF256_RESTRICT y4 = reinterpret_cast<const uint32_t *>(y1 + eight);
-        *z4 ^= *x4 ^ *y4;
+        *z4 = *x4 ^ *y4;
     }
 
     // Handle final bytes
     const int offset = eight + four;
     switch (bytes & 3)
     {
-    case 3: z1[offset + 2] ^= x1[offset + 2] ^ y1[offset + 2];
-    case 2: z1[offset + 1] ^= x1[offset + 1] ^ y1[offset + 1];
-    case 1: z1[offset] ^= x1[offset] ^ y1[offset];
+    case 3: z1[offset + 2] = x1[offset + 2] ^ y1[offset + 2];
+    case 2: z1[offset + 1] = x1[offset + 1] ^ y1[offset + 1];
+    case 1: z1[offset] = x1[offset] ^ y1[offset];
     default:
         break;
     }
 }
 
-extern "C" void gf256_addset_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
-                                 const void * GF256_RESTRICT vy, int bytes)
+// Returns x * y using the 4-bit product tables for y
+static GF256_FORCE_INLINE uint8_t gf256_mul_nibbles(const uint8_t * GF256_RESTRICT table_lo_y,
+                                                    const uint8_t * GF256_RESTRICT table_hi_y, uint8_t x)
 {
-    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128*>(vz);
-    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128*>(vx);
-    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128*>(vy);
+    return table_lo_y[x & 15] ^ table_hi_y[x >> 4];
+}
 
-#if defined(GF256_TARGET_MOBILE)
-# if defined(GF256_TRY_NEON)
-    // Handle multiples of 64 bytes
-    if (CpuHasNeon)
+// Performs "z[] = x[] * y" using the 4-bit product tables for y
+static GF256_FORCE_INLINE void gf256_mul_mem_table(uint8_t * GF256_RESTRICT z1, const uint8_t * GF256_RESTRICT x1,
+                                                   uint8_t y, int bytes)
+{
+    const uint8_t * GF256_RESTRICT table_lo_y = GF256Ctx.MM128.TABLE_LO_Y[y];
+    const uint8_t * GF256_RESTRICT table_hi_y = GF256Ctx.MM128.TABLE_HI_Y[y];
+
+    // Handle blocks of 8 bytes
+    while (bytes >= 8)
     {
-        while (bytes >= 64)
-        {
-            GF256_M128 x0 = vld1q_u8(x16);
-            GF256_M128 x1 = vld1q_u8(x16 + 1);
-            GF256_M128 x2 = vld1q_u8(x16 + 2);
-            GF256_M128 x3 = vld1q_u8(x16 + 3);
-            GF256_M128 y0 = vld1q_u8(y16);
-            GF256_M128 y1 = vld1q_u8(y16 + 1);
-            GF256_M128 y2 = vld1q_u8(y16 + 2);
-            GF256_M128 y3 = vld1q_u8(y16 + 3);
-
-            vst1q_u8(z16,     veorq_u8(x0, y0));
-            vst1q_u8(z16 + 1, veorq_u8(x1, y1));
-            vst1q_u8(z16 + 2, veorq_u8(x2, y2));
-            vst1q_u8(z16 + 3, veorq_u8(x3, y3));
-
-            bytes -= 64, x16 += 4, y16 += 4, z16 += 4;
-        }
+        uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z1);
+        uint64_t word = gf256_mul_nibbles(table_lo_y, table_hi_y, x1[0]);
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[1]) << 8;
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[2]) << 16;
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[3]) << 24;
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[4]) << 32;
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[5]) << 40;
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[6]) << 48;
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[7]) << 56;
+        *z8 = word;
 
-        // Handle multiples of 16 bytes
-        while (bytes >= 16)
-        {
-            // z[i] = x[i] xor y[i]
-            vst1q_u8(z16,
-                veorq_u8(
-                    vld1q_u8(x16),
-                    vld1q_u8(y16)));
+        bytes -= 8, x1 += 8, z1 += 8;
+    }
 
-            bytes -= 16, ++x16, ++y16, ++z16;
-        }
+    // Handle a block of 4 bytes
+    const int four = bytes & 4;
+    if (four)
+    {
+        uint32_t * GF256_RESTRICT z4 = reinterpret_cast<uint32_t *>(z1);
+        uint32_t word = gf256_mul_nibbles(table_lo_y, table_hi_y, x1[0]);
+        word |= (uint32_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[1]) << 8;
+        word |= (uint32_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[2]) << 16;
+        word |= (uint32_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[3]) << 24;
+        *z4 = word;
     }
-    else
-# endif // GF256_TRY_NEON
+
+    // Handle single bytes
+    const int offset = four;
+    switch (bytes & 3)
     {
-        uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z16);
-        const uint64_t * GF256_RESTRICT x8 = reinterpret_cast<const uint64_t *>(x16);
-        const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(y16);
+    case 3: z1[offset + 2] = gf256_mul_nibbles(table_lo_y, table_hi_y, x1[offset + 2]);
+    case 2: z1[offset + 1] = gf256_mul_nibbles(table_lo_y, table_hi_y, x1[offset + 1]);
+    case 1: z1[offset] = gf256_mul_nibbles(table_lo_y, table_hi_y, x1[offset]);
+    default:
+        break;
+    }
+}
 
-        const unsigned count = (unsigned)bytes / 8;
-        for (unsigned ii = 0; ii < count; ++ii)
-            z8[ii] = x8[ii] ^ y8[ii];
+// Performs "z[] += x[] * y" using the 4-bit product tables for y
+static GF256_FORCE_INLINE void gf256_muladd_mem_table(uint8_t * GF256_RESTRICT z1, const uint8_t * GF256_RESTRICT x1,
+                                                      uint8_t y, int bytes)
+{
+    const uint8_t * GF256_RESTRICT table_lo_y = GF256Ctx.MM128.TABLE_LO_Y[y];
+    const uint8_t * GF256_RESTRICT table_hi_y = GF256Ctx.MM128.TABLE_HI_Y[y];
 
-        x16 = reinterpret_cast<const GF256_M128 *>(x8 + count);
-        y16 = reinterpret_cast<const GF256_M128 *>(y8 + count);
-        z16 = reinterpret_cast<GF256_M128 *>(z8 + count);
-    }
-#else // GF256_TARGET_MOBILE
-# if defined(GF256_TRY_AVX2)
-    if (CpuHasAVX2)
+    // Handle blocks of 8 bytes
+    while (bytes >= 8)
     {
-        GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(z16);
-        const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(x16);
-        const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(y16);
-
-        const unsigned count = bytes / 32;
-        for (unsigned i = 0; i < count; ++i)
-        {
-            _mm256_storeu_si256(z32 + i,
-                _mm256_xor_si256(
-                    _mm256_loadu_si256(x32 + i),
-                    _mm256_loadu_si256(y32 + i)));
-        }
+        uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z1);
+        uint64_t word = gf256_mul_nibbles(table_lo_y, table_hi_y, x1[0]);
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[1]) << 8;
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[2]) << 16;
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[3]) << 24;
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[4]) << 32;
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[5]) << 40;
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[6]) << 48;
+        word |= (uint64_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[7]) << 56;
+        *z8 ^= word;
 
-        bytes -= count * 32;
-        z16 = reinterpret_cast<GF256_M128 *>(z32 + count);
-        x16 = reinterpret_cast<const GF256_M128 *>(x32 + count);
-        y16 = reinterpret_cast<const GF256_M128 *>(y32 + count);
+        bytes -= 8, x1 += 8, z1 += 8;
     }
-    else
-# endif // GF256_TRY_AVX2
+
+    // Handle a block of 4 bytes
+    const int four = bytes & 4;
+    if (four)
     {
-        // Handle multiples of 64 bytes
-        while (bytes >= 64)
-        {
-            GF256_M128 x0 = _mm_loadu_si128(x16);
-            GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
-            GF256_M128 x2 = _mm_loadu_si128(x16 + 2);
-            GF256_M128 x3 = _mm_loadu_si128(x16 + 3);
-            GF256_M128 y0 = _mm_loadu_si128(y16);
-            GF256_M128 y1 = _mm_loadu_si128(y16 + 1);
-            GF256_M128 y2 = _mm_loadu_si128(y16 + 2);
-            GF256_M128 y3 = _mm_loadu_si128(y16 + 3);
-
-            _mm_storeu_si128(z16,     _mm_xor_si128(x0, y0));
-            _mm_storeu_si128(z16 + 1, _mm_xor_si128(x1, y1));
-            _mm_storeu_si128(z16 + 2, _mm_xor_si128(x2, y2));
-            _mm_storeu_si128(z16 + 3, _mm_xor_si128(x3, y3));
-
-            bytes -= 64, x16 += 4, y16 += 4, z16 += 4;
-        }
+        uint32_t * GF256_RESTRICT z4 = reinterpret_cast<uint32_t *>(z1);
+        uint32_t word = gf256_mul_nibbles(table_lo_y, table_hi_y, x1[0]);
+        word |= (uint32_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[1]) << 8;
+        word |= (uint32_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[2]) << 16;
+        word |= (uint32_t)gf256_mul_nibbles(table_lo_y, table_hi_y, x1[3]) << 24;
+        *z4 ^= word;
     }
 
-    // Handle multiples of 16 bytes
-    while (bytes >= 16)
+    // Handle single bytes
+    const int offset = four;
+    switch (bytes & 3)
     {
-        // z[i] = x[i] xor y[i]
-        _mm_storeu_si128(z16,
-            _mm_xor_si128(
-                _mm_loadu_si128(x16),
-                _mm_loadu_si128(y16)));
-
-        bytes -= 16, ++x16, ++y16, ++z16;
+    case 3: z1[offset + 2] ^= gf256_mul_nibbles(table_lo_y, table_hi_y, x1[offset + 2]);
+    case 2: z1[offset + 1] ^= gf256_mul_nibbles(table_lo_y, table_hi_y, x1[offset + 1]);
+    case 1: z1[offset] ^= gf256_mul_nibbles(table_lo_y, table_hi_y, x1[offset]);
+    default:
+        break;
     }
-#endif // GF256_TARGET_MOBILE
-
-    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(z16);
-    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(x16);
-    const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(y16);
+}
 
+// Swaps the final 0..15 bytes of two buffers
+static GF256_FORCE_INLINE void gf256_memswap_tail(uint8_t * GF256_RESTRICT x1,
+                                                  uint8_t * GF256_RESTRICT y1, int bytes)
+{
     // Handle a block of 8 bytes
     const int eight = bytes & 8;
     if (eight)
     {
-        uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z1);
-        const uint64_t * GF256_RESTRICT x8 = reinterpret_cast<const uint64_t *>(x1);
-        const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(y1);
-        *z8 = *x8 ^ *y8;
+        uint64_t * GF256_RESTRICT x8 = reinterpret_cast<uint64_t *>(x1);
+        uint64_t * GF256_RESTRICT y8 = reinterpret_cast<uint64_t *>(y1);
+
+        uint64_t temp = *x8;
+        *x8 = *y8;
+        *y8 = temp;
     }
 
     // Handle a block of 4 bytes
     const int four = bytes & 4;
     if (four)
     {
-        uint32_t * GF256_RESTRICT z4 = reinterpret_cast<uint32_t *>(z1 + eight);
-        const uint32_t * GF256_RESTRICT x4 = reinterpret_cast<const uint32_t *>(x1 + eight);
-        const uint32_t * GF256_RESTRICT y4 = reinterpret_cast<const uint32_t *>(y1 + eight);
-        *z4 = *x4 ^ *y4;
+        uint32_t * GF256_RESTRICT x4 = reinterpret_cast<uint32_t *>(x1 + eight);
+        uint32_t * GF256_RESTRICT y4 = reinterpret_cast<uint32_t *>(y1 + eight);
+
+        uint32_t temp = *x4;
+        *x4 = *y4;
+        *y4 = temp;
     }
 
     // Handle final bytes
     const int offset = eight + four;
+    uint8_t temp;
     switch (bytes & 3)
     {
-    case 3: z1[offset + 2] = x1[offset + 2] ^ y1[offset + 2];
-    case 2: z1[offset + 1] = x1[offset + 1] ^ y1[offset + 1];
-    case 1: z1[offset] = x1[offset] ^ y1[offset];
+    case 3: temp = x1[offset + 2]; x1[offset + 2] = y1[offset + 2]; y1[offset + 2] = temp;
+    case 2: temp = x1[offset + 1]; x1[offset + 1] = y1[offset + 1]; y1[offset + 1] = temp;
+    case 1: temp = x1[offset]; x1[offset] = y1[offset]; y1[offset] = temp;
     default:
         break;
     }
 }
 
-extern "C" void gf256_mul_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx, uint8_t y, int bytes)
+static void gf256_add_mem_portable(void * GF256_RESTRICT vx,
+                                   const void * GF256_RESTRICT vy, int bytes)
 {
-    // Use a single if-statement to handle special cases
-    if (y <= 1)
-    {
-        if (y == 0)
-            memset(vz, 0, bytes);
-        else if (vz != vx)
-            memcpy(vz, vx, bytes);
-        return;
-    }
+    uint64_t * GF256_RESTRICT x8 = reinterpret_cast<uint64_t *>(vx);
+    const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(vy);
 
-    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(vz);
-    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(vx);
+    const unsigned count = (unsigned)bytes / 8;
+    for (unsigned ii = 0; ii < count; ++ii)
+        x8[ii] ^= y8[ii];
 
-#if defined(GF256_TARGET_MOBILE)
-    if (bytes >= 16 && CpuHasNeon64)
-    {
-        // Partial product tables; see above
-        const GF256_M128 table_lo_y = vld1q_u8(GF256Ctx.MM128.TABLE_LO_Y + y);
-        const GF256_M128 table_hi_y = vld1q_u8(GF256Ctx.MM128.TABLE_HI_Y + y);
+    gf256_add_mem_tail(
+        reinterpret_cast<uint8_t *>(x8 + count),
+        reinterpret_cast<const uint8_t *>(y8 + count),
+        bytes & 7);
+}
 
-        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
-        const GF256_M128 clr_mask = vdupq_n_u8(0x0f);
+static void gf256_add2_mem_portable(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                    const void * GF256_RESTRICT vy, int bytes)
+{
+    uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(vz);
+    const uint64_t * GF256_RESTRICT x8 = reinterpret_cast<const uint64_t *>(vx);
+    const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(vy);
 
-        // Handle multiples of 16 bytes
-        do
-        {
-            // See above comments for details
-            GF256_M128 x0 = vld1q_u8(x16);
-            GF256_M128 l0 = vandq_u8(x0, clr_mask);
-            x0 = vshrq_n_u8(x0, 4);
-            GF256_M128 h0 = vandq_u8(x0, clr_mask);
-            l0 = vqtbl1q_u8(table_lo_y, l0);
-            h0 = vqtbl1q_u8(table_hi_y, h0);
-            vst1q_u8(z16, veorq_u8(l0, h0));
-
-            bytes -= 16, ++x16, ++z16;
-        } while (bytes >= 16);
-    }
-#else
-# if defined(GF256_TRY_AVX2)
-    if (bytes >= 32 && CpuHasAVX2)
-    {
-        // Partial product tables; see above
-        const GF256_M256 table_lo_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_LO_Y + y);
-        const GF256_M256 table_hi_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_HI_Y + y);
+    const unsigned count = (unsigned)bytes / 8;
+    for (unsigned ii = 0; ii < count; ++ii)
+        z8[ii] ^= x8[ii] ^ y8[ii];
 
-        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
-        const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
+    gf256_add2_mem_tail(
+        reinterpret_cast<uint8_t *>(z8 + count),
+        reinterpret_cast<const uint8_t *>(x8 + count),
+        reinterpret_cast<const uint8_t *>(y8 + count),
+        bytes & 7);
+}
 
-        GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(vz);
-        const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+static void gf256_addset_mem_portable(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                      const void * GF256_RESTRICT vy, int bytes)
+{
+    uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(vz);
+    const uint64_t * GF256_RESTRICT x8 = reinterpret_cast<const uint64_t *>(vx);
+    const uint64_t * GF256_RESTRICT y8 = reinterpret_cast<const uint64_t *>(vy);
 
-        // Handle multiples of 32 bytes
-        do
-        {
-            // See above comments for details
-            GF256_M256 x0 = _mm256_loadu_si256(x32);
-            GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
-            x0 = _mm256_srli_epi64(x0, 4);
-            GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
-            l0 = _mm256_shuffle_epi8(table_lo_y, l0);
-            h0 = _mm256_shuffle_epi8(table_hi_y, h0);
-            _mm256_storeu_si256(z32, _mm256_xor_si256(l0, h0));
+    const unsigned count = (unsigned)bytes / 8;
+    for (unsigned ii = 0; ii < count; ++ii)
+        z8[ii] = x8[ii] ^ y8[ii];
 
-            bytes -= 32, ++x32, ++z32;
-        } while (bytes >= 32);
+    gf256_addset_mem_tail(
+        reinterpret_cast<uint8_t *>(z8 + count),
+        reinterpret_cast<const uint8_t *>(x8 + count),
+        reinterpret_cast<const uint8_t *>(y8 + count),
+        bytes & 7);
+}
 
-        z16 = reinterpret_cast<GF256_M128 *>(z32);
-        x16 = reinterpret_cast<const GF256_M128 *>(x32);
-    }
-# endif // GF256_TRY_AVX2
-    if (bytes >= 16 && CpuHasSSSE3)
-    {
-        // Partial product tables; see above
-        const GF256_M128 table_lo_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + y);
-        const GF256_M128 table_hi_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + y);
+static void gf256_mul_mem_portable(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                   uint8_t y, int bytes)
+{
+    gf256_mul_mem_table(
+        reinterpret_cast<uint8_t *>(vz),
+        reinterpret_cast<const uint8_t *>(vx),
+        y,
+        bytes);
+}
 
-        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
-        const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+static void gf256_muladd_mem_portable(void * GF256_RESTRICT vz, uint8_t y,
+                                      const void * GF256_RESTRICT vx, int bytes)
+{
+    gf256_muladd_mem_table(
+        reinterpret_cast<uint8_t *>(vz),
+        reinterpret_cast<const uint8_t *>(vx),
+        y,
+        bytes);
+}
 
-        // Handle multiples of 16 bytes
-        do
-        {
-            // See above comments for details
-            GF256_M128 x0 = _mm_loadu_si128(x16);
-            GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
-            x0 = _mm_srli_epi64(x0, 4);
-            GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
-            l0 = _mm_shuffle_epi8(table_lo_y, l0);
-            h0 = _mm_shuffle_epi8(table_hi_y, h0);
-            _mm_storeu_si128(z16, _mm_xor_si128(l0, h0));
+static void gf256_memswap_portable(void * GF256_RESTRICT vx, void * GF256_RESTRICT vy, int bytes)
+{
+    uint64_t * GF256_RESTRICT x8 = reinterpret_cast<uint64_t *>(vx);
+    uint64_t * GF256_RESTRICT y8 = reinterpret_cast<uint64_t *>(vy);
 
-            bytes -= 16, ++x16, ++z16;
-        } while (bytes >= 16);
+    const unsigned count = (unsigned)bytes / 8;
+    for (unsigned ii = 0; ii < count; ++ii)
+    {
+        const uint64_t temp = x8[ii];
+        x8[ii] = y8[ii];
+        y8[ii] = temp;
     }
-#endif
 
-    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t*>(z16);
-    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t*>(x16);
-    const uint8_t * GF256_RESTRICT table = GF256Ctx.GF256_MUL_TABLE + ((unsigned)y << 8);
+    gf256_memswap_tail(
+        reinterpret_cast<uint8_t *>(x8 + count),
+        reinterpret_cast<uint8_t *>(y8 + count),
+        bytes & 7);
+}
 
-    // Handle blocks of 8 bytes
-    while (bytes >= 8)
+// Kernel signatures used by the multi-source helpers below
+typedef void (*gf256_add_mem_fn)(void * GF256_RESTRICT vx,
+                                 const void * GF256_RESTRICT vy, int bytes);
+typedef void (*gf256_muladd_mem_fn)(void * GF256_RESTRICT vz, uint8_t y,
+                                    const void * GF256_RESTRICT vx, int bytes);
+
+// Returns the length of the longest source
+static unsigned gf256_multi_max_bytes(const unsigned * GF256_RESTRICT lens, unsigned count)
+{
+    unsigned maxBytes = 0;
+    for (unsigned i = 0; i < count; ++i)
+        if (maxBytes < lens[i])
+            maxBytes = lens[i];
+    return maxBytes;
+}
+
+// Accumulates the last (lens[i] % blockBytes) bytes of each source, which the
+// blocked loop skips because they do not fill a whole block
+static void gf256_muladd_multi_tails(
+    uint8_t * GF256_RESTRICT z, const uint8_t * GF256_RESTRICT coeffs,
+    const void * const * GF256_RESTRICT srcs, const unsigned * GF256_RESTRICT lens,
+    unsigned count, unsigned blockBytes, gf256_add_mem_fn add, gf256_muladd_mem_fn muladd)
+{
+    for (unsigned i = 0; i < count; ++i)
     {
-        uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z1);
-        uint64_t word = table[x1[0]];
-        word |= (uint64_t)table[x1[1]] << 8;
-        word |= (uint64_t)table[x1[2]] << 16;
-        word |= (uint64_t)table[x1[3]] << 24;
-        word |= (uint64_t)table[x1[4]] << 32;
-        word |= (uint64_t)table[x1[5]] << 40;
-        word |= (uint64_t)table[x1[6]] << 48;
-        word |= (uint64_t)table[x1[7]] << 56;
-        *z8 = word;
+        const uint8_t y = coeffs[i];
+        const unsigned offset = lens[i] - lens[i] % blockBytes;
+        const int bytes = (int)(lens[i] - offset);
+        if (y == 0 || bytes <= 0)
+            continue;
 
-        bytes -= 8, x1 += 8, z1 += 8;
+        const uint8_t * x = reinterpret_cast<const uint8_t *>(srcs[i]) + offset;
+        if (y == 1)
+            add(z + offset, x, bytes);
+        else
+            muladd(z + offset, y, x, bytes);
     }
+}
 
-    // Handle a block of 4 bytes
-    const int four = bytes & 4;
-    if (four)
+// Walks the destination in cache-sized chunks and accumulates every source into
+// each chunk before moving on.  Used where there are too few registers to hold
+// a destination block
+static void gf256_muladd_multi_chunked(
+    void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+    const void * const * GF256_RESTRICT srcs, const unsigned * GF256_RESTRICT lens,
+    unsigned count, gf256_add_mem_fn add, gf256_muladd_mem_fn muladd)
+{
+    static const unsigned kChunkBytes = 1024;
+
+    uint8_t * GF256_RESTRICT z = reinterpret_cast<uint8_t *>(vz);
+    const unsigned maxBytes = gf256_multi_max_bytes(lens, count);
+
+    for (unsigned offset = 0; offset + kChunkBytes <= maxBytes; offset += kChunkBytes)
     {
-        uint32_t * GF256_RESTRICT z4 = reinterpret_cast<uint32_t *>(z1);
-        uint32_t word = table[x1[0]];
-        word |= (uint32_t)table[x1[1]] << 8;
-        word |= (uint32_t)table[x1[2]] << 16;
-        word |= (uint32_t)table[x1[3]] << 24;
-        *z4 = word;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const uint8_t y = coeffs[i];
+            if (y == 0 || lens[i] < offset + kChunkBytes)
+                continue;
+
+            const uint8_t * x = reinterpret_cast<const uint8_t *>(srcs[i]) + offset;
+            if (y == 1)
+                add(z + offset, x, kChunkBytes);
+            else
+                muladd(z + offset, y, x, kChunkBytes);
+        }
     }
 
-    // Handle single bytes
-    const int offset = four;
-    switch (bytes & 3)
+    gf256_muladd_multi_tails(z, coeffs, srcs, lens, count, kChunkBytes, add, muladd);
+}
+
+static void gf256_muladd_multi_portable(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+                                        const void * const * GF256_RESTRICT srcs,
+                                        const unsigned * GF256_RESTRICT lens, unsigned count)
+{
+    gf256_muladd_multi_chunked(vz, coeffs, srcs, lens, count,
+        gf256_add_mem_portable, gf256_muladd_mem_portable);
+}
+
+// Accumulates the final bytes that do not fill a whole vector
+static void gf256_add_muladd2_tail(
+    uint8_t * GF256_RESTRICT z0,
+    uint8_t * GF256_RESTRICT z1, uint8_t y1,
+    uint8_t * GF256_RESTRICT z2, uint8_t y2,
+    const uint8_t * GF256_RESTRICT x, int bytes,
+    gf256_add_mem_fn add, gf256_muladd_mem_fn muladd)
+{
+    if (bytes <= 0)
+        return;
+    add(z0, x, bytes);
+    muladd(z1, y1, x, bytes);
+    muladd(z2, y2, x, bytes);
+}
+
+// Walks the source in cache-sized chunks so that it is read from memory once
+static void gf256_add_muladd2_chunked(
+    uint8_t * GF256_RESTRICT z0,
+    uint8_t * GF256_RESTRICT z1, uint8_t y1,
+    uint8_t * GF256_RESTRICT z2, uint8_t y2,
+    const uint8_t * GF256_RESTRICT x, int bytes,
+    gf256_add_mem_fn add, gf256_muladd_mem_fn muladd)
+{
+    static const int kChunkBytes = 1024;
+
+    while (bytes >= kChunkBytes)
     {
-    case 3: z1[offset + 2] = table[x1[offset + 2]];
-    case 2: z1[offset + 1] = table[x1[offset + 1]];
-    case 1: z1[offset] = table[x1[offset]];
-    default:
-        break;
+        gf256_add_muladd2_tail(z0, z1, y1, z2, y2, x, kChunkBytes, add, muladd);
+
+        bytes -= kChunkBytes, x += kChunkBytes;
+        z0 += kChunkBytes, z1 += kChunkBytes, z2 += kChunkBytes;
     }
+
+    gf256_add_muladd2_tail(z0, z1, y1, z2, y2, x, bytes, add, muladd);
 }
 
-extern "C" void gf256_muladd_mem(void * GF256_RESTRICT vz, uint8_t y,
-                                 const void * GF256_RESTRICT vx, int bytes)
+static void gf256_add_muladd2_mem_portable(void * GF256_RESTRICT vz0,
+                                           void * GF256_RESTRICT vz1, uint8_t y1,
+                                           void * GF256_RESTRICT vz2, uint8_t y2,
+                                           const void * GF256_RESTRICT vx, int bytes)
 {
-    // Use a single if-statement to handle special cases
-    if (y <= 1)
+    gf256_add_muladd2_chunked(
+        reinterpret_cast<uint8_t *>(vz0),
+        reinterpret_cast<uint8_t *>(vz1), y1,
+        reinterpret_cast<uint8_t *>(vz2), y2,
+        reinterpret_cast<const uint8_t *>(vx), bytes,
+        gf256_add_mem_portable, gf256_muladd_mem_portable);
+}
+
+
+//------------------------------------------------------------------------------
+// Vector Extension Kernels
+//
+// These use GCC vector extensions so the compiler can pick the best byte
+// shuffle for the target, which is much faster than a table lookup per byte
+// on targets that have one.  The XOR kernels are the 64-bit word versions
+// above, which compilers already vectorize well.
+
+#if defined(GF256_TRY_VECTOR_EXT)
+
+typedef uint8_t gf256_v16 __attribute__((vector_size(16)));
+
+// Load the 4-bit partial product tables for y
+static GF256_FORCE_INLINE void gf256_vector_tables(uint8_t y, gf256_v16& table_lo_y, gf256_v16& table_hi_y)
+{
+    memcpy(&table_lo_y, GF256Ctx.MM128.TABLE_LO_Y[y], 16);
+    memcpy(&table_hi_y, GF256Ctx.MM128.TABLE_HI_Y[y], 16);
+}
+
+// Returns x * y using the partial product tables for y
+static GF256_FORCE_INLINE gf256_v16 gf256_vector_mul(gf256_v16 x, gf256_v16 table_lo_y, gf256_v16 table_hi_y)
+{
+    const gf256_v16 l = x & 0x0f;
+    const gf256_v16 h = x >> 4;
+    return __builtin_shuffle(table_lo_y, l) ^ __builtin_shuffle(table_hi_y, h);
+}
+
+static void gf256_mul_mem_vector(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                 uint8_t y, int bytes)
+{
+    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(vx);
+
+    if (bytes >= 16)
     {
-        if (y == 1)
-            gf256_add_mem(vz, vx, bytes);
-        return;
+        gf256_v16 table_lo_y, table_hi_y;
+        gf256_vector_tables(y, table_lo_y, table_hi_y);
+
+        // Handle multiples of 16 bytes
+        do
+        {
+            gf256_v16 x0;
+            memcpy(&x0, x1, 16);
+            const gf256_v16 p0 = gf256_vector_mul(x0, table_lo_y, table_hi_y);
+            memcpy(z1, &p0, 16);
+
+            bytes -= 16, x1 += 16, z1 += 16;
+        } while (bytes >= 16);
     }
 
-    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(vz);
-    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(vx);
+    gf256_mul_mem_table(z1, x1, y, bytes);
+}
 
-#if defined(GF256_TARGET_MOBILE)
-    if (bytes >= 16 && CpuHasNeon64)
-    {
-        // Partial product tables; see above
-        const GF256_M128 table_lo_y = vld1q_u8(GF256Ctx.MM128.TABLE_LO_Y + y);
-        const GF256_M128 table_hi_y = vld1q_u8(GF256Ctx.MM128.TABLE_HI_Y + y);
+static void gf256_muladd_mem_vector(void * GF256_RESTRICT vz, uint8_t y,
+                                    const void * GF256_RESTRICT vx, int bytes)
+{
+    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(vx);
 
-        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
-        const GF256_M128 clr_mask = vdupq_n_u8(0x0f);
+    if (bytes >= 16)
+    {
+        gf256_v16 table_lo_y, table_hi_y;
+        gf256_vector_tables(y, table_lo_y, table_hi_y);
 
         // Handle multiples of 16 bytes
         do
         {
-            // See above comments for details
-            GF256_M128 x0 = vld1q_u8(x16);
-            GF256_M128 l0 = vandq_u8(x0, clr_mask);
-            x0 = vshrq_n_u8(x0, 4);
-            GF256_M128 h0 = vandq_u8(x0, clr_mask);
-            l0 = vqtbl1q_u8(table_lo_y, l0);
-            h0 = vqtbl1q_u8(table_hi_y, h0);
-            const GF256_M128 p0 = veorq_u8(l0, h0);
-            const GF256_M128 z0 = vld1q_u8(z16);
-            vst1q_u8(z16, veorq_u8(p0, z0));
-
-            bytes -= 16, ++x16, ++z16;
+            gf256_v16 x0, z0;
+            memcpy(&x0, x1, 16);
+            memcpy(&z0, z1, 16);
+            z0 ^= gf256_vector_mul(x0, table_lo_y, table_hi_y);
+            memcpy(z1, &z0, 16);
+
+            bytes -= 16, x1 += 16, z1 += 16;
         } while (bytes >= 16);
     }
-#else // GF256_TARGET_MOBILE
-# if defined(GF256_TRY_AVX2)
-    if (bytes >= 32 && CpuHasAVX2)
-    {
-        // Partial product tables; see above
-        const GF256_M256 table_lo_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_LO_Y + y);
-        const GF256_M256 table_hi_y = _mm256_loadu_si256(GF256Ctx.MM256.TABLE_HI_Y + y);
 
-        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
-        const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
+    gf256_muladd_mem_table(z1, x1, y, bytes);
+}
 
-        GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(z16);
-        const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(x16);
+static void gf256_muladd_multi_vector(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+                                      const void * const * GF256_RESTRICT srcs,
+                                      const unsigned * GF256_RESTRICT lens, unsigned count)
+{
+    gf256_muladd_multi_chunked(vz, coeffs, srcs, lens, count,
+        gf256_add_mem_portable, gf256_muladd_mem_vector);
+}
 
-        // On my Reed Solomon codec, the encoder unit test runs in 640 usec without and 550 usec with the optimization (86% of the original time)
+static void gf256_add_muladd2_mem_vector(void * GF256_RESTRICT vz0,
+                                         void * GF256_RESTRICT vz1, uint8_t y1,
+                                         void * GF256_RESTRICT vz2, uint8_t y2,
+                                         const void * GF256_RESTRICT vx, int bytes)
+{
+    gf256_add_muladd2_chunked(
+        reinterpret_cast<uint8_t *>(vz0),
+        reinterpret_cast<uint8_t *>(vz1), y1,
+        reinterpret_cast<uint8_t *>(vz2), y2,
+        reinterpret_cast<const uint8_t *>(vx), bytes,
+        gf256_add_mem_portable, gf256_muladd_mem_vector);
+}
+
+#endif // GF256_TRY_VECTOR_EXT
+
+
+//------------------------------------------------------------------------------
+// ARM NEON Kernels
+
+#if defined(GF256_TRY_NEON)
+
+static void gf256_add_mem_neon(void * GF256_RESTRICT vx,
+                               const void * GF256_RESTRICT vy, int bytes)
+{
+    uint8_t * GF256_RESTRICT x1 = reinterpret_cast<uint8_t *>(vx);
+    const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(vy);
+
+    // Handle multiples of 64 bytes
+    while (bytes >= 64)
+    {
+        GF256_M128 a0 = vld1q_u8(x1);
+        GF256_M128 a1 = vld1q_u8(x1 + 16);
+        GF256_M128 a2 = vld1q_u8(x1 + 32);
+        GF256_M128 a3 = vld1q_u8(x1 + 48);
+        GF256_M128 b0 = vld1q_u8(y1);
+        GF256_M128 b1 = vld1q_u8(y1 + 16);
+        GF256_M128 b2 = vld1q_u8(y1 + 32);
+        GF256_M128 b3 = vld1q_u8(y1 + 48);
+
+        vst1q_u8(x1,      veorq_u8(a0, b0));
+        vst1q_u8(x1 + 16, veorq_u8(a1, b1));
+        vst1q_u8(x1 + 32, veorq_u8(a2, b2));
+        vst1q_u8(x1 + 48, veorq_u8(a3, b3));
+
+        bytes -= 64, x1 += 64, y1 += 64;
+    }
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        vst1q_u8(x1, veorq_u8(vld1q_u8(x1), vld1q_u8(y1)));
+
+        bytes -= 16, x1 += 16, y1 += 16;
+    }
+
+    gf256_add_mem_tail(x1, y1, bytes);
+}
+
+static void gf256_add2_mem_neon(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                const void * GF256_RESTRICT vy, int bytes)
+{
+    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(vx);
+    const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(vy);
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // z[i] = z[i] xor x[i] xor y[i]
+        vst1q_u8(z1,
+            veorq_u8(
+                vld1q_u8(z1),
+                veorq_u8(
+                    vld1q_u8(x1),
+                    vld1q_u8(y1))));
+
+        bytes -= 16, x1 += 16, y1 += 16, z1 += 16;
+    }
+
+    gf256_add2_mem_tail(z1, x1, y1, bytes);
+}
+
+static void gf256_addset_mem_neon(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                  const void * GF256_RESTRICT vy, int bytes)
+{
+    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(vx);
+    const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(vy);
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // z[i] = x[i] xor y[i]
+        vst1q_u8(z1, veorq_u8(vld1q_u8(x1), vld1q_u8(y1)));
+
+        bytes -= 16, x1 += 16, y1 += 16, z1 += 16;
+    }
+
+    gf256_addset_mem_tail(z1, x1, y1, bytes);
+}
+
+// Note: vqtbl1q_u8 requires 64-bit NEON
+static void gf256_mul_mem_neon64(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                 uint8_t y, int bytes)
+{
+    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(vx);
+
+    // Partial product tables; see above
+    const GF256_M128 table_lo_y = vld1q_u8(GF256Ctx.MM128.TABLE_LO_Y[y]);
+    const GF256_M128 table_hi_y = vld1q_u8(GF256Ctx.MM128.TABLE_HI_Y[y]);
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M128 clr_mask = vdupq_n_u8(0x0f);
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // See above comments for details
+        GF256_M128 x0 = vld1q_u8(x1);
+        GF256_M128 l0 = vandq_u8(x0, clr_mask);
+        x0 = vshrq_n_u8(x0, 4);
+        GF256_M128 h0 = vandq_u8(x0, clr_mask);
+        l0 = vqtbl1q_u8(table_lo_y, l0);
+        h0 = vqtbl1q_u8(table_hi_y, h0);
+        vst1q_u8(z1, veorq_u8(l0, h0));
+
+        bytes -= 16, x1 += 16, z1 += 16;
+    }
+
+    gf256_mul_mem_table(z1, x1, y, bytes);
+}
+
+static void gf256_muladd_mem_neon64(void * GF256_RESTRICT vz, uint8_t y,
+                                    const void * GF256_RESTRICT vx, int bytes)
+{
+    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(vx);
+
+    // Partial product tables; see above
+    const GF256_M128 table_lo_y = vld1q_u8(GF256Ctx.MM128.TABLE_LO_Y[y]);
+    const GF256_M128 table_hi_y = vld1q_u8(GF256Ctx.MM128.TABLE_HI_Y[y]);
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M128 clr_mask = vdupq_n_u8(0x0f);
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // See above comments for details
+        GF256_M128 x0 = vld1q_u8(x1);
+        GF256_M128 l0 = vandq_u8(x0, clr_mask);
+        x0 = vshrq_n_u8(x0, 4);
+        GF256_M128 h0 = vandq_u8(x0, clr_mask);
+        l0 = vqtbl1q_u8(table_lo_y, l0);
+        h0 = vqtbl1q_u8(table_hi_y, h0);
+        const GF256_M128 p0 = veorq_u8(l0, h0);
+        const GF256_M128 z0 = vld1q_u8(z1);
+        vst1q_u8(z1, veorq_u8(p0, z0));
+
+        bytes -= 16, x1 += 16, z1 += 16;
+    }
+
+    gf256_muladd_mem_table(z1, x1, y, bytes);
+}
+
+static void gf256_muladd_multi_neon(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+                                    const void * const * GF256_RESTRICT srcs,
+                                    const unsigned * GF256_RESTRICT lens, unsigned count)
+{
+    gf256_muladd_multi_chunked(vz, coeffs, srcs, lens, count,
+        gf256_add_mem_neon, gf256_muladd_mem_portable);
+}
+
+static void gf256_muladd_multi_neon64(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+                                      const void * const * GF256_RESTRICT srcs,
+                                      const unsigned * GF256_RESTRICT lens, unsigned count)
+{
+    gf256_muladd_multi_chunked(vz, coeffs, srcs, lens, count,
+        gf256_add_mem_neon, gf256_muladd_mem_neon64);
+}
+
+static void gf256_add_muladd2_mem_neon(void * GF256_RESTRICT vz0,
+                                       void * GF256_RESTRICT vz1, uint8_t y1,
+                                       void * GF256_RESTRICT vz2, uint8_t y2,
+                                       const void * GF256_RESTRICT vx, int bytes)
+{
+    gf256_add_muladd2_chunked(
+        reinterpret_cast<uint8_t *>(vz0),
+        reinterpret_cast<uint8_t *>(vz1), y1,
+        reinterpret_cast<uint8_t *>(vz2), y2,
+        reinterpret_cast<const uint8_t *>(vx), bytes,
+        gf256_add_mem_neon, gf256_muladd_mem_portable);
+}
+
+static void gf256_add_muladd2_mem_neon64(void * GF256_RESTRICT vz0,
+                                         void * GF256_RESTRICT vz1, uint8_t y1,
+                                         void * GF256_RESTRICT vz2, uint8_t y2,
+                                         const void * GF256_RESTRICT vx, int bytes)
+{
+    gf256_add_muladd2_chunked(
+        reinterpret_cast<uint8_t *>(vz0),
+        reinterpret_cast<uint8_t *>(vz1), y1,
+        reinterpret_cast<uint8_t *>(vz2), y2,
+        reinterpret_cast<const uint8_t *>(vx), bytes,
+        gf256_add_mem_neon, gf256_muladd_mem_neon64);
+}
+
+#endif // GF256_TRY_NEON
+
+
+//------------------------------------------------------------------------------
+// x86 SSSE3 Kernels
+
+#if !defined(GF256_TARGET_MOBILE)
+
+// Loads a 4-bit product table from GF256Ctx.MM128
+static GF256_FORCE_INLINE GF256_M128 gf256_load_table_sse(const uint8_t * GF256_RESTRICT table)
+{
+    return _mm_load_si128(reinterpret_cast<const GF256_M128 *>(table));
+}
+
+// Performs "x[] += y[]" for the final 0..63 bytes
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE void gf256_add_mem_finish_sse(
+    GF256_M128 * GF256_RESTRICT x16,
+    const GF256_M128 * GF256_RESTRICT y16, int bytes)
+{
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // x[i] = x[i] xor y[i]
+        _mm_storeu_si128(x16,
+            _mm_xor_si128(
+                _mm_loadu_si128(x16),
+                _mm_loadu_si128(y16)));
+
+        bytes -= 16, ++x16, ++y16;
+    }
+
+    gf256_add_mem_tail(
+        reinterpret_cast<uint8_t *>(x16),
+        reinterpret_cast<const uint8_t *>(y16),
+        bytes);
+}
+
+// Performs "z[] += x[] + y[]" for the final 0..31 bytes
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE void gf256_add2_mem_finish_sse(
+    GF256_M128 * GF256_RESTRICT z16, const GF256_M128 * GF256_RESTRICT x16,
+    const GF256_M128 * GF256_RESTRICT y16, int bytes)
+{
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // z[i] = z[i] xor x[i] xor y[i]
+        _mm_storeu_si128(z16,
+            _mm_xor_si128(
+                _mm_loadu_si128(z16),
+                _mm_xor_si128(
+                    _mm_loadu_si128(x16),
+                    _mm_loadu_si128(y16))));
+
+        bytes -= 16, ++x16, ++y16, ++z16;
+    }
+
+    gf256_add2_mem_tail(
+        reinterpret_cast<uint8_t *>(z16),
+        reinterpret_cast<const uint8_t *>(x16),
+        reinterpret_cast<const uint8_t *>(y16),
+        bytes);
+}
+
+// Performs "z[] = x[] + y[]" for the final 0..63 bytes
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE void gf256_addset_mem_finish_sse(
+    GF256_M128 * GF256_RESTRICT z16, const GF256_M128 * GF256_RESTRICT x16,
+    const GF256_M128 * GF256_RESTRICT y16, int bytes)
+{
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // z[i] = x[i] xor y[i]
+        _mm_storeu_si128(z16,
+            _mm_xor_si128(
+                _mm_loadu_si128(x16),
+                _mm_loadu_si128(y16)));
+
+        bytes -= 16, ++x16, ++y16, ++z16;
+    }
+
+    gf256_addset_mem_tail(
+        reinterpret_cast<uint8_t *>(z16),
+        reinterpret_cast<const uint8_t *>(x16),
+        reinterpret_cast<const uint8_t *>(y16),
+        bytes);
+}
+
+// Multiplying the final 1..15 bytes by table lookup costs two loads per byte.
+// When the buffer is at least 16 bytes long, the kernels instead multiply the
+// last 16 bytes of x[] with one vector, after shuffling the final bytes to the
+// front, and write out the products with the same 8/4/1 byte accesses as the
+// XOR tails.  Reading back across bytes that were just stored would stall store
+// forwarding when small packets are accumulated into the same buffer, so z[] is
+// never accessed with an overlapping vector.
+
+// Loading 16 bytes at offset 16 - r gives a shuffle that moves the final r
+// bytes of a vector to the front
+static GF256_ALIGNED const uint8_t kRaggedShuffle[32] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
+};
+
+// Returns the products of the 1..15 bytes starting at x16 in the low bytes.
+// The 16 bytes before the end of x[] must be part of the buffer
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE GF256_M128 gf256_ragged_mul_sse(
+    const GF256_M128 * GF256_RESTRICT x16, int bytes,
+    GF256_M128 table_lo_y, GF256_M128 table_hi_y, GF256_M128 clr_mask)
+{
+    GF256_M128 x0 = _mm_loadu_si128(reinterpret_cast<const GF256_M128 *>(
+        reinterpret_cast<const uint8_t *>(x16) + bytes - 16));
+    x0 = _mm_shuffle_epi8(x0, _mm_loadu_si128(reinterpret_cast<const GF256_M128 *>(kRaggedShuffle + 16 - bytes)));
+    GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
+    x0 = _mm_srli_epi64(x0, 4);
+    GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
+    l0 = _mm_shuffle_epi8(table_lo_y, l0);
+    h0 = _mm_shuffle_epi8(table_hi_y, h0);
+    return _mm_xor_si128(l0, h0);
+}
+
+// Performs "z[] = p" for the low 1..15 bytes of p
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE void gf256_ragged_set_sse(
+    uint8_t * GF256_RESTRICT z1, GF256_M128 p, int bytes)
+{
+    if (bytes & 8)
+    {
+        _mm_storel_epi64(reinterpret_cast<GF256_M128 *>(z1), p);
+        p = _mm_srli_si128(p, 8);
+        z1 += 8;
+    }
+    if (bytes & 4)
+    {
+        *reinterpret_cast<uint32_t *>(z1) = static_cast<uint32_t>(_mm_cvtsi128_si32(p));
+        p = _mm_srli_si128(p, 4);
+        z1 += 4;
+    }
+    const uint32_t word = static_cast<uint32_t>(_mm_cvtsi128_si32(p));
+    switch (bytes & 3)
+    {
+    case 3: z1[2] = static_cast<uint8_t>(word >> 16);
+    case 2: z1[1] = static_cast<uint8_t>(word >> 8);
+    case 1: z1[0] = static_cast<uint8_t>(word);
+    default:
+        break;
+    }
+}
+
+// Performs "z[] += p" for the low 1..15 bytes of p
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE void gf256_ragged_add_sse(
+    uint8_t * GF256_RESTRICT z1, GF256_M128 p, int bytes)
+{
+    if (bytes & 8)
+    {
+        GF256_M128 * GF256_RESTRICT z8 = reinterpret_cast<GF256_M128 *>(z1);
+        _mm_storel_epi64(z8, _mm_xor_si128(_mm_loadl_epi64(z8), p));
+        p = _mm_srli_si128(p, 8);
+        z1 += 8;
+    }
+    if (bytes & 4)
+    {
+        *reinterpret_cast<uint32_t *>(z1) ^= static_cast<uint32_t>(_mm_cvtsi128_si32(p));
+        p = _mm_srli_si128(p, 4);
+        z1 += 4;
+    }
+    const uint32_t word = static_cast<uint32_t>(_mm_cvtsi128_si32(p));
+    switch (bytes & 3)
+    {
+    case 3: z1[2] ^= static_cast<uint8_t>(word >> 16);
+    case 2: z1[1] ^= static_cast<uint8_t>(word >> 8);
+    case 1: z1[0] ^= static_cast<uint8_t>(word);
+    default:
+        break;
+    }
+}
+
+// Performs "z[] = x[] * y" for the final 0..31 bytes.
+// Set overlap if the 16 bytes before z16 and x16 are part of the buffers
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE void gf256_mul_mem_finish_sse(
+    GF256_M128 * GF256_RESTRICT z16, const GF256_M128 * GF256_RESTRICT x16,
+    uint8_t y, int bytes, bool overlap)
+{
+    if (bytes <= 0)
+        return;
+    if (bytes < 16 && !overlap)
+    {
+        gf256_mul_mem_table(
+            reinterpret_cast<uint8_t *>(z16),
+            reinterpret_cast<const uint8_t *>(x16),
+            y,
+            bytes);
+        return;
+    }
+
+    // Partial product tables; see above
+    const GF256_M128 table_lo_y = gf256_load_table_sse(GF256Ctx.MM128.TABLE_LO_Y[y]);
+    const GF256_M128 table_hi_y = gf256_load_table_sse(GF256Ctx.MM128.TABLE_HI_Y[y]);
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // See above comments for details
+        GF256_M128 x0 = _mm_loadu_si128(x16);
+        GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
+        x0 = _mm_srli_epi64(x0, 4);
+        GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
+        l0 = _mm_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm_shuffle_epi8(table_hi_y, h0);
+        _mm_storeu_si128(z16, _mm_xor_si128(l0, h0));
+
+        bytes -= 16, ++x16, ++z16;
+    }
+
+    if (bytes > 0)
+    {
+        gf256_ragged_set_sse(
+            reinterpret_cast<uint8_t *>(z16),
+            gf256_ragged_mul_sse(x16, bytes, table_lo_y, table_hi_y, clr_mask),
+            bytes);
+    }
+}
+
+// Performs "z[] += x[] * y" for the final 0..31 bytes.
+// Set overlap if the 16 bytes before z16 and x16 are part of the buffers
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE void gf256_muladd_mem_finish_sse(
+    GF256_M128 * GF256_RESTRICT z16, uint8_t y,
+    const GF256_M128 * GF256_RESTRICT x16, int bytes, bool overlap)
+{
+    if (bytes <= 0)
+        return;
+    if (bytes < 16 && !overlap)
+    {
+        gf256_muladd_mem_table(
+            reinterpret_cast<uint8_t *>(z16),
+            reinterpret_cast<const uint8_t *>(x16),
+            y,
+            bytes);
+        return;
+    }
+
+    // Partial product tables; see above
+    const GF256_M128 table_lo_y = gf256_load_table_sse(GF256Ctx.MM128.TABLE_LO_Y[y]);
+    const GF256_M128 table_hi_y = gf256_load_table_sse(GF256Ctx.MM128.TABLE_HI_Y[y]);
+
+    // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+    const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        // See above comments for details
+        GF256_M128 x0 = _mm_loadu_si128(x16);
+        GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
+        x0 = _mm_srli_epi64(x0, 4);
+        GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
+        l0 = _mm_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm_shuffle_epi8(table_hi_y, h0);
+        const GF256_M128 p0 = _mm_xor_si128(l0, h0);
+        const GF256_M128 z0 = _mm_loadu_si128(z16);
+        _mm_storeu_si128(z16, _mm_xor_si128(p0, z0));
+
+        bytes -= 16, ++x16, ++z16;
+    }
+
+    if (bytes > 0)
+    {
+        gf256_ragged_add_sse(
+            reinterpret_cast<uint8_t *>(z16),
+            gf256_ragged_mul_sse(x16, bytes, table_lo_y, table_hi_y, clr_mask),
+            bytes);
+    }
+}
+
+// Swaps the final 0..31 bytes of two buffers
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE void gf256_memswap_finish_sse(
+    GF256_M128 * GF256_RESTRICT x16,
+    GF256_M128 * GF256_RESTRICT y16, int bytes)
+{
+    // Handle blocks of 16 bytes
+    while (bytes >= 16)
+    {
+        GF256_M128 x0 = _mm_loadu_si128(x16);
+        GF256_M128 y0 = _mm_loadu_si128(y16);
+        _mm_storeu_si128(x16, y0);
+        _mm_storeu_si128(y16, x0);
+
+        bytes -= 16, ++x16, ++y16;
+    }
+
+    gf256_memswap_tail(
+        reinterpret_cast<uint8_t *>(x16),
+        reinterpret_cast<uint8_t *>(y16),
+        bytes);
+}
+
+GF256_TARGET_SSSE3 static void gf256_add_mem_ssse3(void * GF256_RESTRICT vx,
+                                                   const void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<GF256_M128 *>(vx);
+    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128 *>(vy);
+
+    // Handle multiples of 64 bytes
+    while (bytes >= 64)
+    {
+        GF256_M128 x0 = _mm_loadu_si128(x16);
+        GF256_M128 y0 = _mm_loadu_si128(y16);
+        x0 = _mm_xor_si128(x0, y0);
+        GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
+        GF256_M128 y1 = _mm_loadu_si128(y16 + 1);
+        x1 = _mm_xor_si128(x1, y1);
+        GF256_M128 x2 = _mm_loadu_si128(x16 + 2);
+        GF256_M128 y2 = _mm_loadu_si128(y16 + 2);
+        x2 = _mm_xor_si128(x2, y2);
+        GF256_M128 x3 = _mm_loadu_si128(x16 + 3);
+        GF256_M128 y3 = _mm_loadu_si128(y16 + 3);
+        x3 = _mm_xor_si128(x3, y3);
+
+        _mm_storeu_si128(x16, x0);
+        _mm_storeu_si128(x16 + 1, x1);
+        _mm_storeu_si128(x16 + 2, x2);
+        _mm_storeu_si128(x16 + 3, x3);
+
+        bytes -= 64, x16 += 4, y16 += 4;
+    }
+
+    gf256_add_mem_finish_sse(x16, y16, bytes);
+}
+
+GF256_TARGET_SSSE3 static void gf256_add2_mem_ssse3(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                    const void * GF256_RESTRICT vy, int bytes)
+{
+    gf256_add2_mem_finish_sse(
+        reinterpret_cast<GF256_M128 *>(vz),
+        reinterpret_cast<const GF256_M128 *>(vx),
+        reinterpret_cast<const GF256_M128 *>(vy),
+        bytes);
+}
+
+GF256_TARGET_SSSE3 static void gf256_addset_mem_ssse3(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                      const void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(vz);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(vx);
+    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128 *>(vy);
+
+    // Handle multiples of 64 bytes
+    while (bytes >= 64)
+    {
+        GF256_M128 x0 = _mm_loadu_si128(x16);
+        GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
+        GF256_M128 x2 = _mm_loadu_si128(x16 + 2);
+        GF256_M128 x3 = _mm_loadu_si128(x16 + 3);
+        GF256_M128 y0 = _mm_loadu_si128(y16);
+        GF256_M128 y1 = _mm_loadu_si128(y16 + 1);
+        GF256_M128 y2 = _mm_loadu_si128(y16 + 2);
+        GF256_M128 y3 = _mm_loadu_si128(y16 + 3);
+
+        _mm_storeu_si128(z16,     _mm_xor_si128(x0, y0));
+        _mm_storeu_si128(z16 + 1, _mm_xor_si128(x1, y1));
+        _mm_storeu_si128(z16 + 2, _mm_xor_si128(x2, y2));
+        _mm_storeu_si128(z16 + 3, _mm_xor_si128(x3, y3));
+
+        bytes -= 64, x16 += 4, y16 += 4, z16 += 4;
+    }
+
+    gf256_addset_mem_finish_sse(z16, x16, y16, bytes);
+}
+
+GF256_TARGET_SSSE3 static void gf256_mul_mem_ssse3(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                   uint8_t y, int bytes)
+{
+    gf256_mul_mem_finish_sse(
+        reinterpret_cast<GF256_M128 *>(vz),
+        reinterpret_cast<const GF256_M128 *>(vx),
+        y, bytes, false);
+}
+
+GF256_TARGET_SSSE3 static void gf256_muladd_mem_ssse3(void * GF256_RESTRICT vz, uint8_t y,
+                                                      const void * GF256_RESTRICT vx, int bytes)
+{
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(vz);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(vx);
+
+    if (bytes >= 32)
+    {
+        // Partial product tables; see above
+        const GF256_M128 table_lo_y = gf256_load_table_sse(GF256Ctx.MM128.TABLE_LO_Y[y]);
+        const GF256_M128 table_hi_y = gf256_load_table_sse(GF256Ctx.MM128.TABLE_HI_Y[y]);
+
+        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+        const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+
+        // This unroll seems to provide about 7% speed boost when AVX2 is disabled
+        do
+        {
+            bytes -= 32;
+
+            GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
+            GF256_M128 l1 = _mm_and_si128(x1, clr_mask);
+            x1 = _mm_srli_epi64(x1, 4);
+            GF256_M128 h1 = _mm_and_si128(x1, clr_mask);
+            l1 = _mm_shuffle_epi8(table_lo_y, l1);
+            h1 = _mm_shuffle_epi8(table_hi_y, h1);
+            const GF256_M128 z1 = _mm_loadu_si128(z16 + 1);
+
+            GF256_M128 x0 = _mm_loadu_si128(x16);
+            GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
+            x0 = _mm_srli_epi64(x0, 4);
+            GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
+            l0 = _mm_shuffle_epi8(table_lo_y, l0);
+            h0 = _mm_shuffle_epi8(table_hi_y, h0);
+            const GF256_M128 z0 = _mm_loadu_si128(z16);
+
+            const GF256_M128 p1 = _mm_xor_si128(l1, h1);
+            _mm_storeu_si128(z16 + 1, _mm_xor_si128(p1, z1));
+
+            const GF256_M128 p0 = _mm_xor_si128(l0, h0);
+            _mm_storeu_si128(z16, _mm_xor_si128(p0, z0));
+
+            x16 += 2, z16 += 2;
+        } while (bytes >= 32);
+    }
+
+    gf256_muladd_mem_finish_sse(z16, y, x16, bytes, z16 != vz);
+}
+
+GF256_TARGET_SSSE3 static void gf256_memswap_ssse3(void * GF256_RESTRICT vx, void * GF256_RESTRICT vy, int bytes)
+{
+    gf256_memswap_finish_sse(
+        reinterpret_cast<GF256_M128 *>(vx),
+        reinterpret_cast<GF256_M128 *>(vy),
+        bytes);
+}
+
+// Returns z + x * y using the partial product tables for y
+GF256_TARGET_SSSE3 static GF256_FORCE_INLINE GF256_M128 gf256_muladd_sse(
+    GF256_M128 z, GF256_M128 x,
+    GF256_M128 table_lo_y, GF256_M128 table_hi_y, GF256_M128 clr_mask)
+{
+    GF256_M128 l = _mm_and_si128(x, clr_mask);
+    GF256_M128 h = _mm_and_si128(_mm_srli_epi64(x, 4), clr_mask);
+    l = _mm_shuffle_epi8(table_lo_y, l);
+    h = _mm_shuffle_epi8(table_hi_y, h);
+    return _mm_xor_si128(z, _mm_xor_si128(l, h));
+}
+
+// Performs "z[] += x_i[] * y_i" for each source, holding 64 bytes of the
+// destination in registers while all of the sources are accumulated into it
+GF256_TARGET_SSSE3 static void gf256_muladd_multi_ssse3(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+                                                        const void * const * GF256_RESTRICT srcs,
+                                                        const unsigned * GF256_RESTRICT lens, unsigned count)
+{
+    uint8_t * GF256_RESTRICT z = reinterpret_cast<uint8_t *>(vz);
+    const unsigned maxBytes = gf256_multi_max_bytes(lens, count);
+
+    const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+
+    for (unsigned offset = 0; offset + 64 <= maxBytes; offset += 64)
+    {
+        GF256_M128 * z16 = reinterpret_cast<GF256_M128 *>(z + offset);
+        GF256_M128 z0 = _mm_loadu_si128(z16);
+        GF256_M128 z1 = _mm_loadu_si128(z16 + 1);
+        GF256_M128 z2 = _mm_loadu_si128(z16 + 2);
+        GF256_M128 z3 = _mm_loadu_si128(z16 + 3);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const uint8_t y = coeffs[i];
+            if (y == 0 || lens[i] < offset + 64)
+                continue;
+
+            const GF256_M128 * x16 = reinterpret_cast<const GF256_M128 *>(
+                reinterpret_cast<const uint8_t *>(srcs[i]) + offset);
+            const GF256_M128 x0 = _mm_loadu_si128(x16);
+            const GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
+            const GF256_M128 x2 = _mm_loadu_si128(x16 + 2);
+            const GF256_M128 x3 = _mm_loadu_si128(x16 + 3);
+
+            if (y == 1)
+            {
+                z0 = _mm_xor_si128(z0, x0);
+                z1 = _mm_xor_si128(z1, x1);
+                z2 = _mm_xor_si128(z2, x2);
+                z3 = _mm_xor_si128(z3, x3);
+                continue;
+            }
+
+            const GF256_M128 table_lo_y = gf256_load_table_sse(GF256Ctx.MM128.TABLE_LO_Y[y]);
+            const GF256_M128 table_hi_y = gf256_load_table_sse(GF256Ctx.MM128.TABLE_HI_Y[y]);
+            z0 = gf256_muladd_sse(z0, x0, table_lo_y, table_hi_y, clr_mask);
+            z1 = gf256_muladd_sse(z1, x1, table_lo_y, table_hi_y, clr_mask);
+            z2 = gf256_muladd_sse(z2, x2, table_lo_y, table_hi_y, clr_mask);
+            z3 = gf256_muladd_sse(z3, x3, table_lo_y, table_hi_y, clr_mask);
+        }
+
+        _mm_storeu_si128(z16, z0);
+        _mm_storeu_si128(z16 + 1, z1);
+        _mm_storeu_si128(z16 + 2, z2);
+        _mm_storeu_si128(z16 + 3, z3);
+    }
+
+    gf256_muladd_multi_tails(z, coeffs, srcs, lens, count, 64,
+        gf256_add_mem_ssse3, gf256_muladd_mem_ssse3);
+}
+
+// Performs "z0[] += x[]", "z1[] += x[] * y1" and "z2[] += x[] * y2" while
+// reading x[] once.  The nibble indices are shared by both products
+GF256_TARGET_SSSE3 static void gf256_add_muladd2_mem_ssse3(void * GF256_RESTRICT vz0,
+                                                           void * GF256_RESTRICT vz1, uint8_t y1,
+                                                           void * GF256_RESTRICT vz2, uint8_t y2,
+                                                           const void * GF256_RESTRICT vx, int bytes)
+{
+    GF256_M128 * GF256_RESTRICT z0 = reinterpret_cast<GF256_M128 *>(vz0);
+    GF256_M128 * GF256_RESTRICT z1 = reinterpret_cast<GF256_M128 *>(vz1);
+    GF256_M128 * GF256_RESTRICT z2 = reinterpret_cast<GF256_M128 *>(vz2);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(vx);
+
+    if (bytes >= 16)
+    {
+        // Partial product tables; see above
+        const GF256_M128 table_lo_y1 = gf256_load_table_sse(GF256Ctx.MM128.TABLE_LO_Y[y1]);
+        const GF256_M128 table_hi_y1 = gf256_load_table_sse(GF256Ctx.MM128.TABLE_HI_Y[y1]);
+        const GF256_M128 table_lo_y2 = gf256_load_table_sse(GF256Ctx.MM128.TABLE_LO_Y[y2]);
+        const GF256_M128 table_hi_y2 = gf256_load_table_sse(GF256Ctx.MM128.TABLE_HI_Y[y2]);
+
+        const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+
+        do
+        {
+            const GF256_M128 x0 = _mm_loadu_si128(x16);
+            const GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
+            const GF256_M128 h0 = _mm_and_si128(_mm_srli_epi64(x0, 4), clr_mask);
+
+            _mm_storeu_si128(z0, _mm_xor_si128(_mm_loadu_si128(z0), x0));
+            _mm_storeu_si128(z1, _mm_xor_si128(_mm_loadu_si128(z1),
+                _mm_xor_si128(_mm_shuffle_epi8(table_lo_y1, l0), _mm_shuffle_epi8(table_hi_y1, h0))));
+            _mm_storeu_si128(z2, _mm_xor_si128(_mm_loadu_si128(z2),
+                _mm_xor_si128(_mm_shuffle_epi8(table_lo_y2, l0), _mm_shuffle_epi8(table_hi_y2, h0))));
+
+            bytes -= 16, ++x16, ++z0, ++z1, ++z2;
+        } while (bytes >= 16);
+    }
+
+    gf256_add_muladd2_tail(
+        reinterpret_cast<uint8_t *>(z0),
+        reinterpret_cast<uint8_t *>(z1), y1,
+        reinterpret_cast<uint8_t *>(z2), y2,
+        reinterpret_cast<const uint8_t *>(x16), bytes,
+        gf256_add_mem_ssse3, gf256_muladd_mem_ssse3);
+}
+
+#endif // GF256_TARGET_MOBILE
+
+
+//------------------------------------------------------------------------------
+// x86 AVX2 Kernels
+
+#if defined(GF256_TRY_AVX2)
+
+// Loads a 4-bit product table from GF256Ctx.MM128 into both 128-bit lanes
+GF256_TARGET_AVX2 static GF256_FORCE_INLINE GF256_M256 gf256_load_table_avx2(const uint8_t * GF256_RESTRICT table)
+{
+    return _mm256_broadcastsi128_si256(gf256_load_table_sse(table));
+}
+
+GF256_TARGET_AVX2 static void gf256_add_mem_avx2(void * GF256_RESTRICT vx,
+                                                 const void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<GF256_M256 *>(vx);
+    const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(vy);
+
+    while (bytes >= 128)
+    {
+        GF256_M256 x0 = _mm256_loadu_si256(x32);
+        GF256_M256 y0 = _mm256_loadu_si256(y32);
+        x0 = _mm256_xor_si256(x0, y0);
+        GF256_M256 x1 = _mm256_loadu_si256(x32 + 1);
+        GF256_M256 y1 = _mm256_loadu_si256(y32 + 1);
+        x1 = _mm256_xor_si256(x1, y1);
+        GF256_M256 x2 = _mm256_loadu_si256(x32 + 2);
+        GF256_M256 y2 = _mm256_loadu_si256(y32 + 2);
+        x2 = _mm256_xor_si256(x2, y2);
+        GF256_M256 x3 = _mm256_loadu_si256(x32 + 3);
+        GF256_M256 y3 = _mm256_loadu_si256(y32 + 3);
+        x3 = _mm256_xor_si256(x3, y3);
+
+        _mm256_storeu_si256(x32, x0);
+        _mm256_storeu_si256(x32 + 1, x1);
+        _mm256_storeu_si256(x32 + 2, x2);
+        _mm256_storeu_si256(x32 + 3, x3);
+
+        bytes -= 128, x32 += 4, y32 += 4;
+    }
+
+    // Handle multiples of 32 bytes
+    while (bytes >= 32)
+    {
+        // x[i] = x[i] xor y[i]
+        _mm256_storeu_si256(x32,
+            _mm256_xor_si256(
+                _mm256_loadu_si256(x32),
+                _mm256_loadu_si256(y32)));
+
+        bytes -= 32, ++x32, ++y32;
+    }
+
+    gf256_add_mem_finish_sse(
+        reinterpret_cast<GF256_M128 *>(x32),
+        reinterpret_cast<const GF256_M128 *>(y32),
+        bytes);
+}
+
+GF256_TARGET_AVX2 static void gf256_add2_mem_avx2(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                  const void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(vz);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+    const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(vy);
+
+    const unsigned count = bytes / 32;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        _mm256_storeu_si256(z32 + i,
+            _mm256_xor_si256(
+                _mm256_loadu_si256(z32 + i),
+                _mm256_xor_si256(
+                    _mm256_loadu_si256(x32 + i),
+                    _mm256_loadu_si256(y32 + i))));
+    }
+
+    gf256_add2_mem_finish_sse(
+        reinterpret_cast<GF256_M128 *>(z32 + count),
+        reinterpret_cast<const GF256_M128 *>(x32 + count),
+        reinterpret_cast<const GF256_M128 *>(y32 + count),
+        bytes - count * 32);
+}
+
+GF256_TARGET_AVX2 static void gf256_addset_mem_avx2(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                    const void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(vz);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+    const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(vy);
+
+    const unsigned count = bytes / 32;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        _mm256_storeu_si256(z32 + i,
+            _mm256_xor_si256(
+                _mm256_loadu_si256(x32 + i),
+                _mm256_loadu_si256(y32 + i)));
+    }
+
+    gf256_addset_mem_finish_sse(
+        reinterpret_cast<GF256_M128 *>(z32 + count),
+        reinterpret_cast<const GF256_M128 *>(x32 + count),
+        reinterpret_cast<const GF256_M128 *>(y32 + count),
+        bytes - count * 32);
+}
+
+GF256_TARGET_AVX2 static void gf256_mul_mem_avx2(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                 uint8_t y, int bytes)
+{
+    GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(vz);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+
+    if (bytes >= 32)
+    {
+        // Partial product tables; see above
+        const GF256_M256 table_lo_y = gf256_load_table_avx2(GF256Ctx.MM128.TABLE_LO_Y[y]);
+        const GF256_M256 table_hi_y = gf256_load_table_avx2(GF256Ctx.MM128.TABLE_HI_Y[y]);
+
+        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+        const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
+
+        // Handle multiples of 32 bytes
+        do
+        {
+            // See above comments for details
+            GF256_M256 x0 = _mm256_loadu_si256(x32);
+            GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
+            x0 = _mm256_srli_epi64(x0, 4);
+            GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
+            l0 = _mm256_shuffle_epi8(table_lo_y, l0);
+            h0 = _mm256_shuffle_epi8(table_hi_y, h0);
+            _mm256_storeu_si256(z32, _mm256_xor_si256(l0, h0));
+
+            bytes -= 32, ++x32, ++z32;
+        } while (bytes >= 32);
+    }
+
+    gf256_mul_mem_finish_sse(
+        reinterpret_cast<GF256_M128 *>(z32),
+        reinterpret_cast<const GF256_M128 *>(x32),
+        y, bytes, z32 != vz);
+}
+
+GF256_TARGET_AVX2 static void gf256_muladd_mem_avx2(void * GF256_RESTRICT vz, uint8_t y,
+                                                    const void * GF256_RESTRICT vx, int bytes)
+{
+    GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(vz);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+
+    if (bytes >= 32)
+    {
+        // Partial product tables; see above
+        const GF256_M256 table_lo_y = gf256_load_table_avx2(GF256Ctx.MM128.TABLE_LO_Y[y]);
+        const GF256_M256 table_hi_y = gf256_load_table_avx2(GF256Ctx.MM128.TABLE_HI_Y[y]);
+
+        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+        const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
+
+        // On my Reed Solomon codec, the encoder unit test runs in 640 usec without and 550 usec with the optimization (86% of the original time)
         const unsigned count = bytes / 64;
         for (unsigned i = 0; i < count; ++i)
         {
-            // See above comments for details
-            GF256_M256 x0 = _mm256_loadu_si256(x32 + i * 2);
-            GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
-            x0 = _mm256_srli_epi64(x0, 4);
-            const GF256_M256 z0 = _mm256_loadu_si256(z32 + i * 2);
-            GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
-            l0 = _mm256_shuffle_epi8(table_lo_y, l0);
-            h0 = _mm256_shuffle_epi8(table_hi_y, h0);
-            const GF256_M256 p0 = _mm256_xor_si256(l0, h0);
-            _mm256_storeu_si256(z32 + i * 2, _mm256_xor_si256(p0, z0));
+            // See above comments for details
+            GF256_M256 x0 = _mm256_loadu_si256(x32 + i * 2);
+            GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
+            x0 = _mm256_srli_epi64(x0, 4);
+            const GF256_M256 z0 = _mm256_loadu_si256(z32 + i * 2);
+            GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
+            l0 = _mm256_shuffle_epi8(table_lo_y, l0);
+            h0 = _mm256_shuffle_epi8(table_hi_y, h0);
+            const GF256_M256 p0 = _mm256_xor_si256(l0, h0);
+            _mm256_storeu_si256(z32 + i * 2, _mm256_xor_si256(p0, z0));
+
+            GF256_M256 x1 = _mm256_loadu_si256(x32 + i * 2 + 1);
+            GF256_M256 l1 = _mm256_and_si256(x1, clr_mask);
+            x1 = _mm256_srli_epi64(x1, 4);
+            const GF256_M256 z1 = _mm256_loadu_si256(z32 + i * 2 + 1);
+            GF256_M256 h1 = _mm256_and_si256(x1, clr_mask);
+            l1 = _mm256_shuffle_epi8(table_lo_y, l1);
+            h1 = _mm256_shuffle_epi8(table_hi_y, h1);
+            const GF256_M256 p1 = _mm256_xor_si256(l1, h1);
+            _mm256_storeu_si256(z32 + i * 2 + 1, _mm256_xor_si256(p1, z1));
+        }
+        bytes -= count * 64;
+        z32 += count * 2;
+        x32 += count * 2;
+
+        if (bytes >= 32)
+        {
+            GF256_M256 x0 = _mm256_loadu_si256(x32);
+            GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
+            x0 = _mm256_srli_epi64(x0, 4);
+            GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
+            l0 = _mm256_shuffle_epi8(table_lo_y, l0);
+            h0 = _mm256_shuffle_epi8(table_hi_y, h0);
+            const GF256_M256 p0 = _mm256_xor_si256(l0, h0);
+            const GF256_M256 z0 = _mm256_loadu_si256(z32);
+            _mm256_storeu_si256(z32, _mm256_xor_si256(p0, z0));
+
+            bytes -= 32;
+            z32++;
+            x32++;
+        }
+    }
+
+    gf256_muladd_mem_finish_sse(
+        reinterpret_cast<GF256_M128 *>(z32), y,
+        reinterpret_cast<const GF256_M128 *>(x32),
+        bytes, z32 != vz);
+}
+
+GF256_TARGET_AVX2 static void gf256_memswap_avx2(void * GF256_RESTRICT vx, void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<GF256_M256 *>(vx);
+    GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<GF256_M256 *>(vy);
+
+    // Handle blocks of 32 bytes
+    while (bytes >= 32)
+    {
+        GF256_M256 x0 = _mm256_loadu_si256(x32);
+        GF256_M256 y0 = _mm256_loadu_si256(y32);
+        _mm256_storeu_si256(x32, y0);
+        _mm256_storeu_si256(y32, x0);
+
+        bytes -= 32, ++x32, ++y32;
+    }
+
+    gf256_memswap_finish_sse(
+        reinterpret_cast<GF256_M128 *>(x32),
+        reinterpret_cast<GF256_M128 *>(y32),
+        bytes);
+}
+
+// Returns z + x * y using the partial product tables for y
+GF256_TARGET_AVX2 static GF256_FORCE_INLINE GF256_M256 gf256_muladd_avx2(
+    GF256_M256 z, GF256_M256 x,
+    GF256_M256 table_lo_y, GF256_M256 table_hi_y, GF256_M256 clr_mask)
+{
+    GF256_M256 l = _mm256_and_si256(x, clr_mask);
+    GF256_M256 h = _mm256_and_si256(_mm256_srli_epi64(x, 4), clr_mask);
+    l = _mm256_shuffle_epi8(table_lo_y, l);
+    h = _mm256_shuffle_epi8(table_hi_y, h);
+    return _mm256_xor_si256(z, _mm256_xor_si256(l, h));
+}
+
+// Performs "z[] += x_i[] * y_i" for each source, holding 128 bytes of the
+// destination in registers while all of the sources are accumulated into it
+GF256_TARGET_AVX2 static void gf256_muladd_multi_avx2(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+                                                      const void * const * GF256_RESTRICT srcs,
+                                                      const unsigned * GF256_RESTRICT lens, unsigned count)
+{
+    uint8_t * GF256_RESTRICT z = reinterpret_cast<uint8_t *>(vz);
+    const unsigned maxBytes = gf256_multi_max_bytes(lens, count);
+
+    const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
+
+    for (unsigned offset = 0; offset + 128 <= maxBytes; offset += 128)
+    {
+        GF256_M256 * z32 = reinterpret_cast<GF256_M256 *>(z + offset);
+        GF256_M256 z0 = _mm256_loadu_si256(z32);
+        GF256_M256 z1 = _mm256_loadu_si256(z32 + 1);
+        GF256_M256 z2 = _mm256_loadu_si256(z32 + 2);
+        GF256_M256 z3 = _mm256_loadu_si256(z32 + 3);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const uint8_t y = coeffs[i];
+            if (y == 0 || lens[i] < offset + 128)
+                continue;
+
+            const GF256_M256 * x32 = reinterpret_cast<const GF256_M256 *>(
+                reinterpret_cast<const uint8_t *>(srcs[i]) + offset);
+            const GF256_M256 x0 = _mm256_loadu_si256(x32);
+            const GF256_M256 x1 = _mm256_loadu_si256(x32 + 1);
+            const GF256_M256 x2 = _mm256_loadu_si256(x32 + 2);
+            const GF256_M256 x3 = _mm256_loadu_si256(x32 + 3);
+
+            if (y == 1)
+            {
+                z0 = _mm256_xor_si256(z0, x0);
+                z1 = _mm256_xor_si256(z1, x1);
+                z2 = _mm256_xor_si256(z2, x2);
+                z3 = _mm256_xor_si256(z3, x3);
+                continue;
+            }
+
+            const GF256_M256 table_lo_y = gf256_load_table_avx2(GF256Ctx.MM128.TABLE_LO_Y[y]);
+            const GF256_M256 table_hi_y = gf256_load_table_avx2(GF256Ctx.MM128.TABLE_HI_Y[y]);
+            z0 = gf256_muladd_avx2(z0, x0, table_lo_y, table_hi_y, clr_mask);
+            z1 = gf256_muladd_avx2(z1, x1, table_lo_y, table_hi_y, clr_mask);
+            z2 = gf256_muladd_avx2(z2, x2, table_lo_y, table_hi_y, clr_mask);
+            z3 = gf256_muladd_avx2(z3, x3, table_lo_y, table_hi_y, clr_mask);
+        }
+
+        _mm256_storeu_si256(z32, z0);
+        _mm256_storeu_si256(z32 + 1, z1);
+        _mm256_storeu_si256(z32 + 2, z2);
+        _mm256_storeu_si256(z32 + 3, z3);
+    }
+
+    gf256_muladd_multi_tails(z, coeffs, srcs, lens, count, 128,
+        gf256_add_mem_avx2, gf256_muladd_mem_avx2);
+}
+
+// Performs "z0[] += x[]", "z1[] += x[] * y1" and "z2[] += x[] * y2" while
+// reading x[] once.  The nibble indices are shared by both products
+GF256_TARGET_AVX2 static void gf256_add_muladd2_mem_avx2(void * GF256_RESTRICT vz0,
+                                                         void * GF256_RESTRICT vz1, uint8_t y1,
+                                                         void * GF256_RESTRICT vz2, uint8_t y2,
+                                                         const void * GF256_RESTRICT vx, int bytes)
+{
+    GF256_M256 * GF256_RESTRICT z0 = reinterpret_cast<GF256_M256 *>(vz0);
+    GF256_M256 * GF256_RESTRICT z1 = reinterpret_cast<GF256_M256 *>(vz1);
+    GF256_M256 * GF256_RESTRICT z2 = reinterpret_cast<GF256_M256 *>(vz2);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+
+    if (bytes >= 32)
+    {
+        // Partial product tables; see above
+        const GF256_M256 table_lo_y1 = gf256_load_table_avx2(GF256Ctx.MM128.TABLE_LO_Y[y1]);
+        const GF256_M256 table_hi_y1 = gf256_load_table_avx2(GF256Ctx.MM128.TABLE_HI_Y[y1]);
+        const GF256_M256 table_lo_y2 = gf256_load_table_avx2(GF256Ctx.MM128.TABLE_LO_Y[y2]);
+        const GF256_M256 table_hi_y2 = gf256_load_table_avx2(GF256Ctx.MM128.TABLE_HI_Y[y2]);
+
+        const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
+
+        do
+        {
+            const GF256_M256 x0 = _mm256_loadu_si256(x32);
+            const GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
+            const GF256_M256 h0 = _mm256_and_si256(_mm256_srli_epi64(x0, 4), clr_mask);
+
+            _mm256_storeu_si256(z0, _mm256_xor_si256(_mm256_loadu_si256(z0), x0));
+            _mm256_storeu_si256(z1, _mm256_xor_si256(_mm256_loadu_si256(z1),
+                _mm256_xor_si256(_mm256_shuffle_epi8(table_lo_y1, l0), _mm256_shuffle_epi8(table_hi_y1, h0))));
+            _mm256_storeu_si256(z2, _mm256_xor_si256(_mm256_loadu_si256(z2),
+                _mm256_xor_si256(_mm256_shuffle_epi8(table_lo_y2, l0), _mm256_shuffle_epi8(table_hi_y2, h0))));
+
+            bytes -= 32, ++x32, ++z0, ++z1, ++z2;
+        } while (bytes >= 32);
+    }
+
+    gf256_add_muladd2_tail(
+        reinterpret_cast<uint8_t *>(z0),
+        reinterpret_cast<uint8_t *>(z1), y1,
+        reinterpret_cast<uint8_t *>(z2), y2,
+        reinterpret_cast<const uint8_t *>(x32), bytes,
+        gf256_add_mem_avx2, gf256_muladd_mem_avx2);
+}
+
+#endif // GF256_TRY_AVX2
+
+//------------------------------------------------------------------------------
+// x86 AVX-512BW Kernels
+//
+// These process 64 bytes per instruction.  The multiply kernels finish the last
+// 0..63 bytes with one masked load and store, which cannot fault on the bytes
+// masked out, so no bytes are multiplied with table lookups.  The XOR kernels
+// hand the last 0..63 bytes to the AVX2 kernels instead: Their tails are
+// already word-sized, and a masked store does not forward to the next load of
+// the same buffer, which is slower when small packets are summed repeatedly.
+// vpternlogq performs a three-input XOR in a single operation, which saves an
+// instruction per vector in add2 and muladd.
+
+#if defined(GF256_TRY_AVX512)
+
+// Truth table immediate for vpternlogq that computes a ^ b ^ c
+#define GF256_TERNLOG_XOR3 0x96
+
+// Note: The zero-masked forms are used below with all lanes selected because
+// GCC's unmasked intrinsics pass an undefined vector through, which -Wall
+// reports as uninitialized.  They compile to the same instructions.
+
+// Loads a 4-bit product table from GF256Ctx.MM128 into all four 128-bit lanes
+GF256_TARGET_AVX512 static GF256_FORCE_INLINE GF256_M512 gf256_load_table_avx512(const uint8_t * GF256_RESTRICT table)
+{
+    return _mm512_maskz_broadcast_i32x4(0xFFFF, gf256_load_table_sse(table));
+}
+
+// Shifts the high nibble of each byte down, leaving bits for the caller to clear
+GF256_TARGET_AVX512 static GF256_FORCE_INLINE GF256_M512 gf256_srli4_avx512(GF256_M512 x)
+{
+    return _mm512_maskz_srli_epi64(0xFF, x, 4);
+}
+
+// Returns a mask selecting the first 0..63 bytes of a vector
+GF256_TARGET_AVX512 static GF256_FORCE_INLINE __mmask64 gf256_tail_mask_avx512(int bytes)
+{
+    return static_cast<__mmask64>((static_cast<uint64_t>(1) << bytes) - 1);
+}
+
+GF256_TARGET_AVX512 static void gf256_add_mem_avx512(void * GF256_RESTRICT vx,
+                                                     const void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<GF256_M512 *>(vx);
+    const GF256_M512 * GF256_RESTRICT y64 = reinterpret_cast<const GF256_M512 *>(vy);
+
+    while (bytes >= 256)
+    {
+        GF256_M512 x0 = _mm512_loadu_si512(x64);
+        GF256_M512 y0 = _mm512_loadu_si512(y64);
+        x0 = _mm512_xor_si512(x0, y0);
+        GF256_M512 x1 = _mm512_loadu_si512(x64 + 1);
+        GF256_M512 y1 = _mm512_loadu_si512(y64 + 1);
+        x1 = _mm512_xor_si512(x1, y1);
+        GF256_M512 x2 = _mm512_loadu_si512(x64 + 2);
+        GF256_M512 y2 = _mm512_loadu_si512(y64 + 2);
+        x2 = _mm512_xor_si512(x2, y2);
+        GF256_M512 x3 = _mm512_loadu_si512(x64 + 3);
+        GF256_M512 y3 = _mm512_loadu_si512(y64 + 3);
+        x3 = _mm512_xor_si512(x3, y3);
+
+        _mm512_storeu_si512(x64, x0);
+        _mm512_storeu_si512(x64 + 1, x1);
+        _mm512_storeu_si512(x64 + 2, x2);
+        _mm512_storeu_si512(x64 + 3, x3);
+
+        bytes -= 256, x64 += 4, y64 += 4;
+    }
+
+    // Handle multiples of 64 bytes
+    while (bytes >= 64)
+    {
+        // x[i] = x[i] xor y[i]
+        _mm512_storeu_si512(x64,
+            _mm512_xor_si512(
+                _mm512_loadu_si512(x64),
+                _mm512_loadu_si512(y64)));
+
+        bytes -= 64, ++x64, ++y64;
+    }
+
+    gf256_add_mem_avx2(x64, y64, bytes);
+}
+
+GF256_TARGET_AVX512 static void gf256_add2_mem_avx512(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                      const void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(vz);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+    const GF256_M512 * GF256_RESTRICT y64 = reinterpret_cast<const GF256_M512 *>(vy);
+
+    const unsigned count = bytes / 64;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        // z[i] = z[i] xor x[i] xor y[i]
+        _mm512_storeu_si512(z64 + i,
+            _mm512_ternarylogic_epi64(
+                _mm512_loadu_si512(z64 + i),
+                _mm512_loadu_si512(x64 + i),
+                _mm512_loadu_si512(y64 + i),
+                GF256_TERNLOG_XOR3));
+    }
+
+    gf256_add2_mem_avx2(z64 + count, x64 + count, y64 + count, bytes - count * 64);
+}
+
+GF256_TARGET_AVX512 static void gf256_addset_mem_avx512(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                        const void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(vz);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+    const GF256_M512 * GF256_RESTRICT y64 = reinterpret_cast<const GF256_M512 *>(vy);
+
+    const unsigned count = bytes / 64;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        _mm512_storeu_si512(z64 + i,
+            _mm512_xor_si512(
+                _mm512_loadu_si512(x64 + i),
+                _mm512_loadu_si512(y64 + i)));
+    }
+
+    gf256_addset_mem_avx2(z64 + count, x64 + count, y64 + count, bytes - count * 64);
+}
+
+GF256_TARGET_AVX512 static void gf256_mul_mem_avx512(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                     uint8_t y, int bytes)
+{
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(vz);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+
+    // Partial product tables; see above
+    const GF256_M512 table_lo_y = gf256_load_table_avx512(GF256Ctx.MM128.TABLE_LO_Y[y]);
+    const GF256_M512 table_hi_y = gf256_load_table_avx512(GF256Ctx.MM128.TABLE_HI_Y[y]);
+
+    const GF256_M512 clr_mask = _mm512_set1_epi8(0x0f);
+
+    // Handle multiples of 64 bytes
+    while (bytes >= 64)
+    {
+        // See above comments for details
+        GF256_M512 x0 = _mm512_loadu_si512(x64);
+        GF256_M512 l0 = _mm512_and_si512(x0, clr_mask);
+        x0 = gf256_srli4_avx512(x0);
+        GF256_M512 h0 = _mm512_and_si512(x0, clr_mask);
+        l0 = _mm512_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm512_shuffle_epi8(table_hi_y, h0);
+        _mm512_storeu_si512(z64, _mm512_xor_si512(l0, h0));
+
+        bytes -= 64, ++x64, ++z64;
+    }
+
+    if (bytes > 0)
+    {
+        const __mmask64 mask = gf256_tail_mask_avx512(bytes);
+        GF256_M512 x0 = _mm512_maskz_loadu_epi8(mask, x64);
+        GF256_M512 l0 = _mm512_and_si512(x0, clr_mask);
+        x0 = gf256_srli4_avx512(x0);
+        GF256_M512 h0 = _mm512_and_si512(x0, clr_mask);
+        l0 = _mm512_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm512_shuffle_epi8(table_hi_y, h0);
+        _mm512_mask_storeu_epi8(z64, mask, _mm512_xor_si512(l0, h0));
+    }
+}
+
+GF256_TARGET_AVX512 static void gf256_muladd_mem_avx512(void * GF256_RESTRICT vz, uint8_t y,
+                                                        const void * GF256_RESTRICT vx, int bytes)
+{
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(vz);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+
+    // Partial product tables; see above
+    const GF256_M512 table_lo_y = gf256_load_table_avx512(GF256Ctx.MM128.TABLE_LO_Y[y]);
+    const GF256_M512 table_hi_y = gf256_load_table_avx512(GF256Ctx.MM128.TABLE_HI_Y[y]);
+
+    const GF256_M512 clr_mask = _mm512_set1_epi8(0x0f);
+
+    // Interleave two independent blocks to hide the shuffle latency
+    const unsigned count = bytes / 128;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        GF256_M512 x0 = _mm512_loadu_si512(x64 + i * 2);
+        GF256_M512 l0 = _mm512_and_si512(x0, clr_mask);
+        x0 = gf256_srli4_avx512(x0);
+        const GF256_M512 z0 = _mm512_loadu_si512(z64 + i * 2);
+        GF256_M512 h0 = _mm512_and_si512(x0, clr_mask);
+        l0 = _mm512_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm512_shuffle_epi8(table_hi_y, h0);
+        _mm512_storeu_si512(z64 + i * 2, _mm512_ternarylogic_epi64(z0, l0, h0, GF256_TERNLOG_XOR3));
+
+        GF256_M512 x1 = _mm512_loadu_si512(x64 + i * 2 + 1);
+        GF256_M512 l1 = _mm512_and_si512(x1, clr_mask);
+        x1 = gf256_srli4_avx512(x1);
+        const GF256_M512 z1 = _mm512_loadu_si512(z64 + i * 2 + 1);
+        GF256_M512 h1 = _mm512_and_si512(x1, clr_mask);
+        l1 = _mm512_shuffle_epi8(table_lo_y, l1);
+        h1 = _mm512_shuffle_epi8(table_hi_y, h1);
+        _mm512_storeu_si512(z64 + i * 2 + 1, _mm512_ternarylogic_epi64(z1, l1, h1, GF256_TERNLOG_XOR3));
+    }
+    bytes -= count * 128;
+    z64 += count * 2;
+    x64 += count * 2;
+
+    if (bytes >= 64)
+    {
+        GF256_M512 x0 = _mm512_loadu_si512(x64);
+        GF256_M512 l0 = _mm512_and_si512(x0, clr_mask);
+        x0 = gf256_srli4_avx512(x0);
+        GF256_M512 h0 = _mm512_and_si512(x0, clr_mask);
+        l0 = _mm512_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm512_shuffle_epi8(table_hi_y, h0);
+        const GF256_M512 z0 = _mm512_loadu_si512(z64);
+        _mm512_storeu_si512(z64, _mm512_ternarylogic_epi64(z0, l0, h0, GF256_TERNLOG_XOR3));
+
+        bytes -= 64;
+        z64++;
+        x64++;
+    }
+
+    if (bytes > 0)
+    {
+        const __mmask64 mask = gf256_tail_mask_avx512(bytes);
+        GF256_M512 x0 = _mm512_maskz_loadu_epi8(mask, x64);
+        GF256_M512 l0 = _mm512_and_si512(x0, clr_mask);
+        x0 = gf256_srli4_avx512(x0);
+        GF256_M512 h0 = _mm512_and_si512(x0, clr_mask);
+        l0 = _mm512_shuffle_epi8(table_lo_y, l0);
+        h0 = _mm512_shuffle_epi8(table_hi_y, h0);
+        const GF256_M512 z0 = _mm512_maskz_loadu_epi8(mask, z64);
+        _mm512_mask_storeu_epi8(z64, mask, _mm512_ternarylogic_epi64(z0, l0, h0, GF256_TERNLOG_XOR3));
+    }
+}
+
+GF256_TARGET_AVX512 static void gf256_memswap_avx512(void * GF256_RESTRICT vx, void * GF256_RESTRICT vy, int bytes)
+{
+    GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<GF256_M512 *>(vx);
+    GF256_M512 * GF256_RESTRICT y64 = reinterpret_cast<GF256_M512 *>(vy);
+
+    // Handle blocks of 64 bytes
+    while (bytes >= 64)
+    {
+        GF256_M512 x0 = _mm512_loadu_si512(x64);
+        GF256_M512 y0 = _mm512_loadu_si512(y64);
+        _mm512_storeu_si512(x64, y0);
+        _mm512_storeu_si512(y64, x0);
+
+        bytes -= 64, ++x64, ++y64;
+    }
+
+    gf256_memswap_avx2(x64, y64, bytes);
+}
+
+// Returns z + x * y using the partial product tables for y
+GF256_TARGET_AVX512 static GF256_FORCE_INLINE GF256_M512 gf256_muladd_avx512(
+    GF256_M512 z, GF256_M512 x,
+    GF256_M512 table_lo_y, GF256_M512 table_hi_y, GF256_M512 clr_mask)
+{
+    GF256_M512 l = _mm512_and_si512(x, clr_mask);
+    GF256_M512 h = _mm512_and_si512(gf256_srli4_avx512(x), clr_mask);
+    l = _mm512_shuffle_epi8(table_lo_y, l);
+    h = _mm512_shuffle_epi8(table_hi_y, h);
+    return _mm512_ternarylogic_epi64(z, l, h, GF256_TERNLOG_XOR3);
+}
+
+// Performs "z[] += x_i[] * y_i" for each source, holding 256 bytes of the
+// destination in registers while all of the sources are accumulated into it
+GF256_TARGET_AVX512 static void gf256_muladd_multi_avx512(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+                                                          const void * const * GF256_RESTRICT srcs,
+                                                          const unsigned * GF256_RESTRICT lens, unsigned count)
+{
+    uint8_t * GF256_RESTRICT z = reinterpret_cast<uint8_t *>(vz);
+    const unsigned maxBytes = gf256_multi_max_bytes(lens, count);
+
+    const GF256_M512 clr_mask = _mm512_set1_epi8(0x0f);
+
+    for (unsigned offset = 0; offset + 256 <= maxBytes; offset += 256)
+    {
+        GF256_M512 * z64 = reinterpret_cast<GF256_M512 *>(z + offset);
+        GF256_M512 z0 = _mm512_loadu_si512(z64);
+        GF256_M512 z1 = _mm512_loadu_si512(z64 + 1);
+        GF256_M512 z2 = _mm512_loadu_si512(z64 + 2);
+        GF256_M512 z3 = _mm512_loadu_si512(z64 + 3);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const uint8_t y = coeffs[i];
+            if (y == 0 || lens[i] < offset + 256)
+                continue;
+
+            const GF256_M512 * x64 = reinterpret_cast<const GF256_M512 *>(
+                reinterpret_cast<const uint8_t *>(srcs[i]) + offset);
+            const GF256_M512 x0 = _mm512_loadu_si512(x64);
+            const GF256_M512 x1 = _mm512_loadu_si512(x64 + 1);
+            const GF256_M512 x2 = _mm512_loadu_si512(x64 + 2);
+            const GF256_M512 x3 = _mm512_loadu_si512(x64 + 3);
+
+            if (y == 1)
+            {
+                z0 = _mm512_xor_si512(z0, x0);
+                z1 = _mm512_xor_si512(z1, x1);
+                z2 = _mm512_xor_si512(z2, x2);
+                z3 = _mm512_xor_si512(z3, x3);
+                continue;
+            }
+
+            const GF256_M512 table_lo_y = gf256_load_table_avx512(GF256Ctx.MM128.TABLE_LO_Y[y]);
+            const GF256_M512 table_hi_y = gf256_load_table_avx512(GF256Ctx.MM128.TABLE_HI_Y[y]);
+            z0 = gf256_muladd_avx512(z0, x0, table_lo_y, table_hi_y, clr_mask);
+            z1 = gf256_muladd_avx512(z1, x1, table_lo_y, table_hi_y, clr_mask);
+            z2 = gf256_muladd_avx512(z2, x2, table_lo_y, table_hi_y, clr_mask);
+            z3 = gf256_muladd_avx512(z3, x3, table_lo_y, table_hi_y, clr_mask);
+        }
+
+        _mm512_storeu_si512(z64, z0);
+        _mm512_storeu_si512(z64 + 1, z1);
+        _mm512_storeu_si512(z64 + 2, z2);
+        _mm512_storeu_si512(z64 + 3, z3);
+    }
+
+    gf256_muladd_multi_tails(z, coeffs, srcs, lens, count, 256,
+        gf256_add_mem_avx512, gf256_muladd_mem_avx512);
+}
+
+// Performs "z0[] += x[]", "z1[] += x[] * y1" and "z2[] += x[] * y2" while
+// reading x[] once.  The nibble indices are shared by both products
+GF256_TARGET_AVX512 static void gf256_add_muladd2_mem_avx512(void * GF256_RESTRICT vz0,
+                                                             void * GF256_RESTRICT vz1, uint8_t y1,
+                                                             void * GF256_RESTRICT vz2, uint8_t y2,
+                                                             const void * GF256_RESTRICT vx, int bytes)
+{
+    GF256_M512 * GF256_RESTRICT z0 = reinterpret_cast<GF256_M512 *>(vz0);
+    GF256_M512 * GF256_RESTRICT z1 = reinterpret_cast<GF256_M512 *>(vz1);
+    GF256_M512 * GF256_RESTRICT z2 = reinterpret_cast<GF256_M512 *>(vz2);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+
+    if (bytes >= 64)
+    {
+        // Partial product tables; see above
+        const GF256_M512 table_lo_y1 = gf256_load_table_avx512(GF256Ctx.MM128.TABLE_LO_Y[y1]);
+        const GF256_M512 table_hi_y1 = gf256_load_table_avx512(GF256Ctx.MM128.TABLE_HI_Y[y1]);
+        const GF256_M512 table_lo_y2 = gf256_load_table_avx512(GF256Ctx.MM128.TABLE_LO_Y[y2]);
+        const GF256_M512 table_hi_y2 = gf256_load_table_avx512(GF256Ctx.MM128.TABLE_HI_Y[y2]);
+
+        const GF256_M512 clr_mask = _mm512_set1_epi8(0x0f);
+
+        do
+        {
+            const GF256_M512 x0 = _mm512_loadu_si512(x64);
+            const GF256_M512 l0 = _mm512_and_si512(x0, clr_mask);
+            const GF256_M512 h0 = _mm512_and_si512(gf256_srli4_avx512(x0), clr_mask);
+
+            _mm512_storeu_si512(z0, _mm512_xor_si512(_mm512_loadu_si512(z0), x0));
+            _mm512_storeu_si512(z1, _mm512_ternarylogic_epi64(_mm512_loadu_si512(z1),
+                _mm512_shuffle_epi8(table_lo_y1, l0), _mm512_shuffle_epi8(table_hi_y1, h0), GF256_TERNLOG_XOR3));
+            _mm512_storeu_si512(z2, _mm512_ternarylogic_epi64(_mm512_loadu_si512(z2),
+                _mm512_shuffle_epi8(table_lo_y2, l0), _mm512_shuffle_epi8(table_hi_y2, h0), GF256_TERNLOG_XOR3));
+
+            bytes -= 64, ++x64, ++z0, ++z1, ++z2;
+        } while (bytes >= 64);
+    }
+
+    gf256_add_muladd2_tail(
+        reinterpret_cast<uint8_t *>(z0),
+        reinterpret_cast<uint8_t *>(z1), y1,
+        reinterpret_cast<uint8_t *>(z2), y2,
+        reinterpret_cast<const uint8_t *>(x64), bytes,
+        gf256_add_mem_avx512, gf256_muladd_mem_avx512);
+}
+
+#endif // GF256_TRY_AVX512
+
+//------------------------------------------------------------------------------
+// x86 GFNI Kernels
+//
+// gf2p8affineqb multiplies each byte by an 8x8 bit-matrix, which replaces the
+// two nibble table lookups with a single instruction.  Only multiplication is
+// accelerated; the XOR kernels come from the AVX2 or AVX-512BW set.
+
+#if defined(GF256_TRY_GFNI)
+
+GF256_TARGET_GFNI_AVX2 static void gf256_mul_mem_gfni_avx2(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                           uint8_t y, int bytes)
+{
+    GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(vz);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+
+    const GF256_M256 matrix = _mm256_set1_epi64x(static_cast<long long>(GF256Ctx.GFNI.AFFINE_Y[y]));
+
+    // Handle multiples of 32 bytes
+    while (bytes >= 32)
+    {
+        _mm256_storeu_si256(z32,
+            _mm256_gf2p8affine_epi64_epi8(_mm256_loadu_si256(x32), matrix, 0));
+
+        bytes -= 32, ++x32, ++z32;
+    }
+
+    gf256_mul_mem_finish_sse(
+        reinterpret_cast<GF256_M128 *>(z32),
+        reinterpret_cast<const GF256_M128 *>(x32),
+        y, bytes, z32 != vz);
+}
+
+GF256_TARGET_GFNI_AVX2 static void gf256_muladd_mem_gfni_avx2(void * GF256_RESTRICT vz, uint8_t y,
+                                                              const void * GF256_RESTRICT vx, int bytes)
+{
+    GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(vz);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+
+    const GF256_M256 matrix = _mm256_set1_epi64x(static_cast<long long>(GF256Ctx.GFNI.AFFINE_Y[y]));
+
+    while (bytes >= 64)
+    {
+        const GF256_M256 p0 = _mm256_gf2p8affine_epi64_epi8(_mm256_loadu_si256(x32), matrix, 0);
+        const GF256_M256 p1 = _mm256_gf2p8affine_epi64_epi8(_mm256_loadu_si256(x32 + 1), matrix, 0);
+        _mm256_storeu_si256(z32, _mm256_xor_si256(_mm256_loadu_si256(z32), p0));
+        _mm256_storeu_si256(z32 + 1, _mm256_xor_si256(_mm256_loadu_si256(z32 + 1), p1));
+
+        bytes -= 64, x32 += 2, z32 += 2;
+    }
+
+    if (bytes >= 32)
+    {
+        const GF256_M256 p0 = _mm256_gf2p8affine_epi64_epi8(_mm256_loadu_si256(x32), matrix, 0);
+        _mm256_storeu_si256(z32, _mm256_xor_si256(_mm256_loadu_si256(z32), p0));
+
+        bytes -= 32, ++x32, ++z32;
+    }
+
+    gf256_muladd_mem_finish_sse(
+        reinterpret_cast<GF256_M128 *>(z32), y,
+        reinterpret_cast<const GF256_M128 *>(x32),
+        bytes, z32 != vz);
+}
+
+GF256_TARGET_GFNI_AVX512 static void gf256_mul_mem_gfni_avx512(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                                               uint8_t y, int bytes)
+{
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(vz);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+
+    const GF256_M512 matrix = _mm512_set1_epi64(static_cast<long long>(GF256Ctx.GFNI.AFFINE_Y[y]));
+
+    // Handle multiples of 64 bytes
+    while (bytes >= 64)
+    {
+        _mm512_storeu_si512(z64,
+            _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(x64), matrix, 0));
+
+        bytes -= 64, ++x64, ++z64;
+    }
+
+    if (bytes > 0)
+    {
+        const __mmask64 mask = gf256_tail_mask_avx512(bytes);
+        _mm512_mask_storeu_epi8(z64, mask,
+            _mm512_gf2p8affine_epi64_epi8(_mm512_maskz_loadu_epi8(mask, x64), matrix, 0));
+    }
+}
+
+GF256_TARGET_GFNI_AVX512 static void gf256_muladd_mem_gfni_avx512(void * GF256_RESTRICT vz, uint8_t y,
+                                                                  const void * GF256_RESTRICT vx, int bytes)
+{
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(vz);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+
+    const GF256_M512 matrix = _mm512_set1_epi64(static_cast<long long>(GF256Ctx.GFNI.AFFINE_Y[y]));
+
+    while (bytes >= 128)
+    {
+        const GF256_M512 p0 = _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(x64), matrix, 0);
+        const GF256_M512 p1 = _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(x64 + 1), matrix, 0);
+        _mm512_storeu_si512(z64, _mm512_xor_si512(_mm512_loadu_si512(z64), p0));
+        _mm512_storeu_si512(z64 + 1, _mm512_xor_si512(_mm512_loadu_si512(z64 + 1), p1));
+
+        bytes -= 128, x64 += 2, z64 += 2;
+    }
+
+    if (bytes >= 64)
+    {
+        const GF256_M512 p0 = _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(x64), matrix, 0);
+        _mm512_storeu_si512(z64, _mm512_xor_si512(_mm512_loadu_si512(z64), p0));
+
+        bytes -= 64, ++x64, ++z64;
+    }
+
+    if (bytes > 0)
+    {
+        const __mmask64 mask = gf256_tail_mask_avx512(bytes);
+        const GF256_M512 p0 = _mm512_gf2p8affine_epi64_epi8(_mm512_maskz_loadu_epi8(mask, x64), matrix, 0);
+        _mm512_mask_storeu_epi8(z64, mask, _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, z64), p0));
+    }
+}
+
+// Performs "z[] += x_i[] * y_i" for each source, holding 128 bytes of the
+// destination in registers while all of the sources are accumulated into it
+GF256_TARGET_GFNI_AVX2 static void gf256_muladd_multi_gfni_avx2(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+                                                                const void * const * GF256_RESTRICT srcs,
+                                                                const unsigned * GF256_RESTRICT lens, unsigned count)
+{
+    uint8_t * GF256_RESTRICT z = reinterpret_cast<uint8_t *>(vz);
+    const unsigned maxBytes = gf256_multi_max_bytes(lens, count);
+
+    for (unsigned offset = 0; offset + 128 <= maxBytes; offset += 128)
+    {
+        GF256_M256 * z32 = reinterpret_cast<GF256_M256 *>(z + offset);
+        GF256_M256 z0 = _mm256_loadu_si256(z32);
+        GF256_M256 z1 = _mm256_loadu_si256(z32 + 1);
+        GF256_M256 z2 = _mm256_loadu_si256(z32 + 2);
+        GF256_M256 z3 = _mm256_loadu_si256(z32 + 3);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const uint8_t y = coeffs[i];
+            if (y == 0 || lens[i] < offset + 128)
+                continue;
+
+            const GF256_M256 * x32 = reinterpret_cast<const GF256_M256 *>(
+                reinterpret_cast<const uint8_t *>(srcs[i]) + offset);
+            const GF256_M256 x0 = _mm256_loadu_si256(x32);
+            const GF256_M256 x1 = _mm256_loadu_si256(x32 + 1);
+            const GF256_M256 x2 = _mm256_loadu_si256(x32 + 2);
+            const GF256_M256 x3 = _mm256_loadu_si256(x32 + 3);
+
+            if (y == 1)
+            {
+                z0 = _mm256_xor_si256(z0, x0);
+                z1 = _mm256_xor_si256(z1, x1);
+                z2 = _mm256_xor_si256(z2, x2);
+                z3 = _mm256_xor_si256(z3, x3);
+                continue;
+            }
 
-            GF256_M256 x1 = _mm256_loadu_si256(x32 + i * 2 + 1);
-            GF256_M256 l1 = _mm256_and_si256(x1, clr_mask);
-            x1 = _mm256_srli_epi64(x1, 4);
-            const GF256_M256 z1 = _mm256_loadu_si256(z32 + i * 2 + 1);
-            GF256_M256 h1 = _mm256_and_si256(x1, clr_mask);
-            l1 = _mm256_shuffle_epi8(table_lo_y, l1);
-            h1 = _mm256_shuffle_epi8(table_hi_y, h1);
-            const GF256_M256 p1 = _mm256_xor_si256(l1, h1);
-            _mm256_storeu_si256(z32 + i * 2 + 1, _mm256_xor_si256(p1, z1));
+            const GF256_M256 matrix = _mm256_set1_epi64x(static_cast<long long>(GF256Ctx.GFNI.AFFINE_Y[y]));
+            z0 = _mm256_xor_si256(z0, _mm256_gf2p8affine_epi64_epi8(x0, matrix, 0));
+            z1 = _mm256_xor_si256(z1, _mm256_gf2p8affine_epi64_epi8(x1, matrix, 0));
+            z2 = _mm256_xor_si256(z2, _mm256_gf2p8affine_epi64_epi8(x2, matrix, 0));
+            z3 = _mm256_xor_si256(z3, _mm256_gf2p8affine_epi64_epi8(x3, matrix, 0));
+        }
+
+        _mm256_storeu_si256(z32, z0);
+        _mm256_storeu_si256(z32 + 1, z1);
+        _mm256_storeu_si256(z32 + 2, z2);
+        _mm256_storeu_si256(z32 + 3, z3);
+    }
+
+    gf256_muladd_multi_tails(z, coeffs, srcs, lens, count, 128,
+        gf256_add_mem_avx2, gf256_muladd_mem_gfni_avx2);
+}
+
+// Performs "z[] += x_i[] * y_i" for each source, holding 256 bytes of the
+// destination in registers while all of the sources are accumulated into it
+GF256_TARGET_GFNI_AVX512 static void gf256_muladd_multi_gfni_avx512(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+                                                                    const void * const * GF256_RESTRICT srcs,
+                                                                    const unsigned * GF256_RESTRICT lens, unsigned count)
+{
+    uint8_t * GF256_RESTRICT z = reinterpret_cast<uint8_t *>(vz);
+    const unsigned maxBytes = gf256_multi_max_bytes(lens, count);
+
+    for (unsigned offset = 0; offset + 256 <= maxBytes; offset += 256)
+    {
+        GF256_M512 * z64 = reinterpret_cast<GF256_M512 *>(z + offset);
+        GF256_M512 z0 = _mm512_loadu_si512(z64);
+        GF256_M512 z1 = _mm512_loadu_si512(z64 + 1);
+        GF256_M512 z2 = _mm512_loadu_si512(z64 + 2);
+        GF256_M512 z3 = _mm512_loadu_si512(z64 + 3);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const uint8_t y = coeffs[i];
+            if (y == 0 || lens[i] < offset + 256)
+                continue;
+
+            const GF256_M512 * x64 = reinterpret_cast<const GF256_M512 *>(
+                reinterpret_cast<const uint8_t *>(srcs[i]) + offset);
+            const GF256_M512 x0 = _mm512_loadu_si512(x64);
+            const GF256_M512 x1 = _mm512_loadu_si512(x64 + 1);
+            const GF256_M512 x2 = _mm512_loadu_si512(x64 + 2);
+            const GF256_M512 x3 = _mm512_loadu_si512(x64 + 3);
+
+            if (y == 1)
+            {
+                z0 = _mm512_xor_si512(z0, x0);
+                z1 = _mm512_xor_si512(z1, x1);
+                z2 = _mm512_xor_si512(z2, x2);
+                z3 = _mm512_xor_si512(z3, x3);
+                continue;
+            }
+
+            const GF256_M512 matrix = _mm512_set1_epi64(static_cast<long long>(GF256Ctx.GFNI.AFFINE_Y[y]));
+            z0 = _mm512_xor_si512(z0, _mm512_gf2p8affine_epi64_epi8(x0, matrix, 0));
+            z1 = _mm512_xor_si512(z1, _mm512_gf2p8affine_epi64_epi8(x1, matrix, 0));
+            z2 = _mm512_xor_si512(z2, _mm512_gf2p8affine_epi64_epi8(x2, matrix, 0));
+            z3 = _mm512_xor_si512(z3, _mm512_gf2p8affine_epi64_epi8(x3, matrix, 0));
+        }
+
+        _mm512_storeu_si512(z64, z0);
+        _mm512_storeu_si512(z64 + 1, z1);
+        _mm512_storeu_si512(z64 + 2, z2);
+        _mm512_storeu_si512(z64 + 3, z3);
+    }
+
+    gf256_muladd_multi_tails(z, coeffs, srcs, lens, count, 256,
+        gf256_add_mem_avx512, gf256_muladd_mem_gfni_avx512);
+}
+
+// Performs "z0[] += x[]", "z1[] += x[] * y1" and "z2[] += x[] * y2" while
+// reading x[] once
+GF256_TARGET_GFNI_AVX2 static void gf256_add_muladd2_mem_gfni_avx2(void * GF256_RESTRICT vz0,
+                                                                   void * GF256_RESTRICT vz1, uint8_t y1,
+                                                                   void * GF256_RESTRICT vz2, uint8_t y2,
+                                                                   const void * GF256_RESTRICT vx, int bytes)
+{
+    GF256_M256 * GF256_RESTRICT z0 = reinterpret_cast<GF256_M256 *>(vz0);
+    GF256_M256 * GF256_RESTRICT z1 = reinterpret_cast<GF256_M256 *>(vz1);
+    GF256_M256 * GF256_RESTRICT z2 = reinterpret_cast<GF256_M256 *>(vz2);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(vx);
+
+    const GF256_M256 matrix_y1 = _mm256_set1_epi64x(static_cast<long long>(GF256Ctx.GFNI.AFFINE_Y[y1]));
+    const GF256_M256 matrix_y2 = _mm256_set1_epi64x(static_cast<long long>(GF256Ctx.GFNI.AFFINE_Y[y2]));
+
+    while (bytes >= 32)
+    {
+        const GF256_M256 x0 = _mm256_loadu_si256(x32);
+
+        _mm256_storeu_si256(z0, _mm256_xor_si256(_mm256_loadu_si256(z0), x0));
+        _mm256_storeu_si256(z1, _mm256_xor_si256(_mm256_loadu_si256(z1), _mm256_gf2p8affine_epi64_epi8(x0, matrix_y1, 0)));
+        _mm256_storeu_si256(z2, _mm256_xor_si256(_mm256_loadu_si256(z2), _mm256_gf2p8affine_epi64_epi8(x0, matrix_y2, 0)));
+
+        bytes -= 32, ++x32, ++z0, ++z1, ++z2;
+    }
+
+    gf256_add_muladd2_tail(
+        reinterpret_cast<uint8_t *>(z0),
+        reinterpret_cast<uint8_t *>(z1), y1,
+        reinterpret_cast<uint8_t *>(z2), y2,
+        reinterpret_cast<const uint8_t *>(x32), bytes,
+        gf256_add_mem_avx2, gf256_muladd_mem_gfni_avx2);
+}
+
+// Performs "z0[] += x[]", "z1[] += x[] * y1" and "z2[] += x[] * y2" while
+// reading x[] once
+GF256_TARGET_GFNI_AVX512 static void gf256_add_muladd2_mem_gfni_avx512(void * GF256_RESTRICT vz0,
+                                                                       void * GF256_RESTRICT vz1, uint8_t y1,
+                                                                       void * GF256_RESTRICT vz2, uint8_t y2,
+                                                                       const void * GF256_RESTRICT vx, int bytes)
+{
+    GF256_M512 * GF256_RESTRICT z0 = reinterpret_cast<GF256_M512 *>(vz0);
+    GF256_M512 * GF256_RESTRICT z1 = reinterpret_cast<GF256_M512 *>(vz1);
+    GF256_M512 * GF256_RESTRICT z2 = reinterpret_cast<GF256_M512 *>(vz2);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(vx);
+
+    const GF256_M512 matrix_y1 = _mm512_set1_epi64(static_cast<long long>(GF256Ctx.GFNI.AFFINE_Y[y1]));
+    const GF256_M512 matrix_y2 = _mm512_set1_epi64(static_cast<long long>(GF256Ctx.GFNI.AFFINE_Y[y2]));
+
+    while (bytes >= 64)
+    {
+        const GF256_M512 x0 = _mm512_loadu_si512(x64);
+
+        _mm512_storeu_si512(z0, _mm512_xor_si512(_mm512_loadu_si512(z0), x0));
+        _mm512_storeu_si512(z1, _mm512_xor_si512(_mm512_loadu_si512(z1), _mm512_gf2p8affine_epi64_epi8(x0, matrix_y1, 0)));
+        _mm512_storeu_si512(z2, _mm512_xor_si512(_mm512_loadu_si512(z2), _mm512_gf2p8affine_epi64_epi8(x0, matrix_y2, 0)));
+
+        bytes -= 64, ++x64, ++z0, ++z1, ++z2;
+    }
+
+    gf256_add_muladd2_tail(
+        reinterpret_cast<uint8_t *>(z0),
+        reinterpret_cast<uint8_t *>(z1), y1,
+        reinterpret_cast<uint8_t *>(z2), y2,
+        reinterpret_cast<const uint8_t *>(x64), bytes,
+        gf256_add_mem_avx512, gf256_muladd_mem_gfni_avx512);
+}
+
+#endif // GF256_TRY_GFNI
+
+//------------------------------------------------------------------------------
+// x86 Streaming Kernels
+//
+// For buffers larger than the cache, these write the destination with
+// non-temporal stores so that it does not evict data that will be reused,
+// and prefetch the inputs far enough ahead to hide the memory latency.
+// The destination is first aligned to a cache line with the regular kernels,
+// so that each streaming store fills a whole write-combining buffer.
+
+#if !defined(GF256_TARGET_MOBILE)
+
+// Bytes ahead of the current position to prefetch
+static const int kStreamPrefetchBytes = 1024;
+
+// Returns the number of bytes before vz reaches a cache line boundary
+static GF256_FORCE_INLINE int gf256_stream_head(const void * GF256_RESTRICT vz, int bytes)
+{
+    const int head = static_cast<int>((0 - reinterpret_cast<uintptr_t>(vz)) & 63);
+    return head < bytes ? head : bytes;
+}
+
+// Prefetches the next inputs.  The destination is only needed in L1 because
+// it is written back with streaming stores
+static GF256_FORCE_INLINE void gf256_stream_prefetch(const void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx)
+{
+    _mm_prefetch(reinterpret_cast<const char *>(vz) + kStreamPrefetchBytes, _MM_HINT_NTA);
+    _mm_prefetch(reinterpret_cast<const char *>(vx) + kStreamPrefetchBytes, _MM_HINT_T0);
+}
+
+GF256_TARGET_SSSE3 static void gf256_add_mem_stream_ssse3(void * GF256_RESTRICT vx,
+                                                          const void * GF256_RESTRICT vy, int bytes)
+{
+    const int head = gf256_stream_head(vx, bytes);
+    gf256_add_mem_ssse3(vx, vy, head);
+    bytes -= head;
+
+    GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<GF256_M128 *>(reinterpret_cast<uint8_t *>(vx) + head);
+    const GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<const GF256_M128 *>(reinterpret_cast<const uint8_t *>(vy) + head);
+
+    // Handle one cache line at a time
+    while (bytes >= 64)
+    {
+        gf256_stream_prefetch(x16, y16);
+        for (unsigned i = 0; i < 4; ++i)
+            _mm_stream_si128(x16 + i, _mm_xor_si128(_mm_load_si128(x16 + i), _mm_loadu_si128(y16 + i)));
+
+        bytes -= 64, x16 += 4, y16 += 4;
+    }
+    _mm_sfence();
+
+    gf256_add_mem_ssse3(x16, y16, bytes);
+}
+
+GF256_TARGET_SSSE3 static void gf256_muladd_mem_stream_ssse3(void * GF256_RESTRICT vz, uint8_t y,
+                                                             const void * GF256_RESTRICT vx, int bytes)
+{
+    const int head = gf256_stream_head(vz, bytes);
+    gf256_muladd_mem_ssse3(vz, y, vx, head);
+    bytes -= head;
+
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128 *>(reinterpret_cast<uint8_t *>(vz) + head);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128 *>(reinterpret_cast<const uint8_t *>(vx) + head);
+
+    const GF256_M128 table_lo_y = gf256_load_table_sse(GF256Ctx.MM128.TABLE_LO_Y[y]);
+    const GF256_M128 table_hi_y = gf256_load_table_sse(GF256Ctx.MM128.TABLE_HI_Y[y]);
+    const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+
+    // Handle one cache line at a time
+    while (bytes >= 64)
+    {
+        gf256_stream_prefetch(z16, x16);
+        for (unsigned i = 0; i < 4; ++i)
+            _mm_stream_si128(z16 + i, gf256_muladd_sse(_mm_load_si128(z16 + i), _mm_loadu_si128(x16 + i), table_lo_y, table_hi_y, clr_mask));
+
+        bytes -= 64, z16 += 4, x16 += 4;
+    }
+    _mm_sfence();
+
+    gf256_muladd_mem_ssse3(z16, y, x16, bytes);
+}
+
+#if defined(GF256_TRY_AVX2)
+
+GF256_TARGET_AVX2 static void gf256_add_mem_stream_avx2(void * GF256_RESTRICT vx,
+                                                        const void * GF256_RESTRICT vy, int bytes)
+{
+    const int head = gf256_stream_head(vx, bytes);
+    gf256_add_mem_avx2(vx, vy, head);
+    bytes -= head;
+
+    GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<GF256_M256 *>(reinterpret_cast<uint8_t *>(vx) + head);
+    const GF256_M256 * GF256_RESTRICT y32 = reinterpret_cast<const GF256_M256 *>(reinterpret_cast<const uint8_t *>(vy) + head);
+
+    // Handle one cache line at a time
+    while (bytes >= 64)
+    {
+        gf256_stream_prefetch(x32, y32);
+        _mm256_stream_si256(x32, _mm256_xor_si256(_mm256_load_si256(x32), _mm256_loadu_si256(y32)));
+        _mm256_stream_si256(x32 + 1, _mm256_xor_si256(_mm256_load_si256(x32 + 1), _mm256_loadu_si256(y32 + 1)));
+
+        bytes -= 64, x32 += 2, y32 += 2;
+    }
+    _mm_sfence();
+
+    gf256_add_mem_avx2(x32, y32, bytes);
+}
+
+GF256_TARGET_AVX2 static void gf256_muladd_mem_stream_avx2(void * GF256_RESTRICT vz, uint8_t y,
+                                                           const void * GF256_RESTRICT vx, int bytes)
+{
+    const int head = gf256_stream_head(vz, bytes);
+    gf256_muladd_mem_avx2(vz, y, vx, head);
+    bytes -= head;
+
+    GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(reinterpret_cast<uint8_t *>(vz) + head);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(reinterpret_cast<const uint8_t *>(vx) + head);
+
+    const GF256_M256 table_lo_y = gf256_load_table_avx2(GF256Ctx.MM128.TABLE_LO_Y[y]);
+    const GF256_M256 table_hi_y = gf256_load_table_avx2(GF256Ctx.MM128.TABLE_HI_Y[y]);
+    const GF256_M256 clr_mask = _mm256_set1_epi8(0x0f);
+
+    // Handle one cache line at a time
+    while (bytes >= 64)
+    {
+        gf256_stream_prefetch(z32, x32);
+        _mm256_stream_si256(z32, gf256_muladd_avx2(_mm256_load_si256(z32), _mm256_loadu_si256(x32), table_lo_y, table_hi_y, clr_mask));
+        _mm256_stream_si256(z32 + 1, gf256_muladd_avx2(_mm256_load_si256(z32 + 1), _mm256_loadu_si256(x32 + 1), table_lo_y, table_hi_y, clr_mask));
+
+        bytes -= 64, z32 += 2, x32 += 2;
+    }
+    _mm_sfence();
+
+    gf256_muladd_mem_avx2(z32, y, x32, bytes);
+}
+
+#endif // GF256_TRY_AVX2
+
+#if defined(GF256_TRY_AVX512)
+
+GF256_TARGET_AVX512 static void gf256_add_mem_stream_avx512(void * GF256_RESTRICT vx,
+                                                            const void * GF256_RESTRICT vy, int bytes)
+{
+    const int head = gf256_stream_head(vx, bytes);
+    gf256_add_mem_avx512(vx, vy, head);
+    bytes -= head;
+
+    GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<GF256_M512 *>(reinterpret_cast<uint8_t *>(vx) + head);
+    const GF256_M512 * GF256_RESTRICT y64 = reinterpret_cast<const GF256_M512 *>(reinterpret_cast<const uint8_t *>(vy) + head);
+
+    // Handle one cache line at a time
+    while (bytes >= 64)
+    {
+        gf256_stream_prefetch(x64, y64);
+        _mm512_stream_si512(x64, _mm512_xor_si512(_mm512_load_si512(x64), _mm512_loadu_si512(y64)));
+
+        bytes -= 64, ++x64, ++y64;
+    }
+    _mm_sfence();
+
+    gf256_add_mem_avx512(x64, y64, bytes);
+}
+
+GF256_TARGET_AVX512 static void gf256_muladd_mem_stream_avx512(void * GF256_RESTRICT vz, uint8_t y,
+                                                               const void * GF256_RESTRICT vx, int bytes)
+{
+    const int head = gf256_stream_head(vz, bytes);
+    gf256_muladd_mem_avx512(vz, y, vx, head);
+    bytes -= head;
+
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(reinterpret_cast<uint8_t *>(vz) + head);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(reinterpret_cast<const uint8_t *>(vx) + head);
+
+    const GF256_M512 table_lo_y = gf256_load_table_avx512(GF256Ctx.MM128.TABLE_LO_Y[y]);
+    const GF256_M512 table_hi_y = gf256_load_table_avx512(GF256Ctx.MM128.TABLE_HI_Y[y]);
+    const GF256_M512 clr_mask = _mm512_set1_epi8(0x0f);
+
+    // Handle one cache line at a time
+    while (bytes >= 64)
+    {
+        gf256_stream_prefetch(z64, x64);
+        _mm512_stream_si512(z64, gf256_muladd_avx512(_mm512_load_si512(z64), _mm512_loadu_si512(x64), table_lo_y, table_hi_y, clr_mask));
+
+        bytes -= 64, ++z64, ++x64;
+    }
+    _mm_sfence();
+
+    gf256_muladd_mem_avx512(z64, y, x64, bytes);
+}
+
+#endif // GF256_TRY_AVX512
+
+#if defined(GF256_TRY_GFNI)
+
+GF256_TARGET_GFNI_AVX2 static void gf256_muladd_mem_stream_gfni_avx2(void * GF256_RESTRICT vz, uint8_t y,
+                                                                     const void * GF256_RESTRICT vx, int bytes)
+{
+    const int head = gf256_stream_head(vz, bytes);
+    gf256_muladd_mem_gfni_avx2(vz, y, vx, head);
+    bytes -= head;
+
+    GF256_M256 * GF256_RESTRICT z32 = reinterpret_cast<GF256_M256 *>(reinterpret_cast<uint8_t *>(vz) + head);
+    const GF256_M256 * GF256_RESTRICT x32 = reinterpret_cast<const GF256_M256 *>(reinterpret_cast<const uint8_t *>(vx) + head);
+
+    const GF256_M256 matrix = _mm256_set1_epi64x(static_cast<long long>(GF256Ctx.GFNI.AFFINE_Y[y]));
+
+    // Handle one cache line at a time
+    while (bytes >= 64)
+    {
+        gf256_stream_prefetch(z32, x32);
+        const GF256_M256 p0 = _mm256_gf2p8affine_epi64_epi8(_mm256_loadu_si256(x32), matrix, 0);
+        const GF256_M256 p1 = _mm256_gf2p8affine_epi64_epi8(_mm256_loadu_si256(x32 + 1), matrix, 0);
+        _mm256_stream_si256(z32, _mm256_xor_si256(_mm256_load_si256(z32), p0));
+        _mm256_stream_si256(z32 + 1, _mm256_xor_si256(_mm256_load_si256(z32 + 1), p1));
+
+        bytes -= 64, z32 += 2, x32 += 2;
+    }
+    _mm_sfence();
+
+    gf256_muladd_mem_gfni_avx2(z32, y, x32, bytes);
+}
+
+GF256_TARGET_GFNI_AVX512 static void gf256_muladd_mem_stream_gfni_avx512(void * GF256_RESTRICT vz, uint8_t y,
+                                                                         const void * GF256_RESTRICT vx, int bytes)
+{
+    const int head = gf256_stream_head(vz, bytes);
+    gf256_muladd_mem_gfni_avx512(vz, y, vx, head);
+    bytes -= head;
+
+    GF256_M512 * GF256_RESTRICT z64 = reinterpret_cast<GF256_M512 *>(reinterpret_cast<uint8_t *>(vz) + head);
+    const GF256_M512 * GF256_RESTRICT x64 = reinterpret_cast<const GF256_M512 *>(reinterpret_cast<const uint8_t *>(vx) + head);
+
+    const GF256_M512 matrix = _mm512_set1_epi64(static_cast<long long>(GF256Ctx.GFNI.AFFINE_Y[y]));
+
+    // Handle one cache line at a time
+    while (bytes >= 64)
+    {
+        gf256_stream_prefetch(z64, x64);
+        const GF256_M512 p0 = _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(x64), matrix, 0);
+        _mm512_stream_si512(z64, _mm512_xor_si512(_mm512_load_si512(z64), p0));
+
+        bytes -= 64, ++z64, ++x64;
+    }
+    _mm_sfence();
+
+    gf256_muladd_mem_gfni_avx512(z64, y, x64, bytes);
+}
+
+#endif // GF256_TRY_GFNI
+
+#endif // GF256_TARGET_MOBILE
+
+
+//------------------------------------------------------------------------------
+// Kernel Dispatch
+
+struct gf256_kernels
+{
+    void (*AddMem)(void * GF256_RESTRICT vx, const void * GF256_RESTRICT vy, int bytes);
+    void (*Add2Mem)(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                    const void * GF256_RESTRICT vy, int bytes);
+    void (*AddSetMem)(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                      const void * GF256_RESTRICT vy, int bytes);
+    void (*MulMem)(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx, uint8_t y, int bytes);
+    void (*MulAddMem)(void * GF256_RESTRICT vz, uint8_t y, const void * GF256_RESTRICT vx, int bytes);
+    void (*MemSwap)(void * GF256_RESTRICT vx, void * GF256_RESTRICT vy, int bytes);
+    void (*MulAddMulti)(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+                        const void * const * GF256_RESTRICT srcs,
+                        const unsigned * GF256_RESTRICT lens, unsigned count);
+    void (*AddMulAdd2Mem)(void * GF256_RESTRICT vz0,
+                          void * GF256_RESTRICT vz1, uint8_t y1,
+                          void * GF256_RESTRICT vz2, uint8_t y2,
+                          const void * GF256_RESTRICT vx, int bytes);
+    void (*AddMemStream)(void * GF256_RESTRICT vx, const void * GF256_RESTRICT vy, int bytes);
+    void (*MulAddMemStream)(void * GF256_RESTRICT vz, uint8_t y, const void * GF256_RESTRICT vx, int bytes);
+};
+
+// Kernels selected by gf256_init()
+static gf256_kernels Kernels = {
+    gf256_add_mem_portable,
+    gf256_add2_mem_portable,
+    gf256_addset_mem_portable,
+    gf256_mul_mem_portable,
+    gf256_muladd_mem_portable,
+    gf256_memswap_portable,
+    gf256_muladd_multi_portable,
+    gf256_add_muladd2_mem_portable,
+    gf256_add_mem_portable,
+    gf256_muladd_mem_portable
+};
+static int SelectedISA = GF256_ISA_PORTABLE;
+
+// Self-test result for each instruction set: 0 = not run, 1 = passed, -1 = failed
+static int SelfTestResult[GF256_ISA_COUNT];
+
+extern "C" int gf256_get_isa()
+{
+    return SelectedISA;
+}
+
+extern "C" int gf256_isa_supported(int isa)
+{
+    if (isa < 0 || isa >= GF256_ISA_COUNT || SelfTestResult[isa] < 0)
+        return 0;
+
+#if defined(GF256_FORCE_PORTABLE)
+    if (isa != GF256_ISA_PORTABLE && isa != GF256_ISA_VECTOR)
+        return 0;
+#endif // GF256_FORCE_PORTABLE
+
+    switch (isa)
+    {
+    case GF256_ISA_PORTABLE:
+        return 1;
+#if defined(GF256_TRY_VECTOR_EXT)
+    case GF256_ISA_VECTOR:
+        return 1;
+#endif // GF256_TRY_VECTOR_EXT
+#if defined(GF256_TRY_NEON)
+    case GF256_ISA_NEON:
+        return CpuHasNeon ? 1 : 0;
+#endif // GF256_TRY_NEON
+#if !defined(GF256_TARGET_MOBILE)
+    case GF256_ISA_SSSE3:
+        return CpuHasSSSE3 ? 1 : 0;
+# if defined(GF256_TRY_AVX2)
+    case GF256_ISA_AVX2:
+        return CpuHasAVX2 ? 1 : 0;
+# endif // GF256_TRY_AVX2
+# if defined(GF256_TRY_AVX512)
+    case GF256_ISA_AVX512:
+        return CpuHasAVX512 ? 1 : 0;
+# endif // GF256_TRY_AVX512
+# if defined(GF256_TRY_GFNI)
+    case GF256_ISA_GFNI:
+        return CpuHasGFNI ? 1 : 0;
+# endif // GF256_TRY_GFNI
+#endif // GF256_TARGET_MOBILE
+    default:
+        break;
+    }
+    return 0;
+}
+
+extern "C" int gf256_set_isa(int isa)
+{
+    if (!gf256_isa_supported(isa))
+        return -1;
+
+    gf256_kernels kernels = {
+        gf256_add_mem_portable,
+        gf256_add2_mem_portable,
+        gf256_addset_mem_portable,
+        gf256_mul_mem_portable,
+        gf256_muladd_mem_portable,
+        gf256_memswap_portable,
+        gf256_muladd_multi_portable,
+        gf256_add_muladd2_mem_portable,
+        nullptr,
+        nullptr
+    };
+
+    switch (isa)
+    {
+#if defined(GF256_TRY_VECTOR_EXT)
+    case GF256_ISA_VECTOR:
+        kernels.MulMem = gf256_mul_mem_vector;
+        kernels.MulAddMem = gf256_muladd_mem_vector;
+        kernels.MulAddMulti = gf256_muladd_multi_vector;
+        kernels.AddMulAdd2Mem = gf256_add_muladd2_mem_vector;
+        break;
+#endif // GF256_TRY_VECTOR_EXT
+#if defined(GF256_TRY_NEON)
+    case GF256_ISA_NEON:
+        kernels.AddMem = gf256_add_mem_neon;
+        kernels.Add2Mem = gf256_add2_mem_neon;
+        kernels.AddSetMem = gf256_addset_mem_neon;
+        kernels.MulAddMulti = gf256_muladd_multi_neon;
+        kernels.AddMulAdd2Mem = gf256_add_muladd2_mem_neon;
+        if (CpuHasNeon64)
+        {
+            kernels.MulMem = gf256_mul_mem_neon64;
+            kernels.MulAddMem = gf256_muladd_mem_neon64;
+            kernels.MulAddMulti = gf256_muladd_multi_neon64;
+            kernels.AddMulAdd2Mem = gf256_add_muladd2_mem_neon64;
         }
-        bytes -= count * 64;
-        z32 += count * 2;
-        x32 += count * 2;
+        break;
+#endif // GF256_TRY_NEON
+#if !defined(GF256_TARGET_MOBILE)
+    case GF256_ISA_SSSE3:
+        kernels.AddMem = gf256_add_mem_ssse3;
+        kernels.Add2Mem = gf256_add2_mem_ssse3;
+        kernels.AddSetMem = gf256_addset_mem_ssse3;
+        kernels.MulMem = gf256_mul_mem_ssse3;
+        kernels.MulAddMem = gf256_muladd_mem_ssse3;
+        kernels.MemSwap = gf256_memswap_ssse3;
+        kernels.MulAddMulti = gf256_muladd_multi_ssse3;
+        kernels.AddMulAdd2Mem = gf256_add_muladd2_mem_ssse3;
+        kernels.AddMemStream = gf256_add_mem_stream_ssse3;
+        kernels.MulAddMemStream = gf256_muladd_mem_stream_ssse3;
+        break;
+# if defined(GF256_TRY_AVX2)
+    case GF256_ISA_AVX2:
+        kernels.AddMem = gf256_add_mem_avx2;
+        kernels.Add2Mem = gf256_add2_mem_avx2;
+        kernels.AddSetMem = gf256_addset_mem_avx2;
+        kernels.MulMem = gf256_mul_mem_avx2;
+        kernels.MulAddMem = gf256_muladd_mem_avx2;
+        kernels.MemSwap = gf256_memswap_avx2;
+        kernels.MulAddMulti = gf256_muladd_multi_avx2;
+        kernels.AddMulAdd2Mem = gf256_add_muladd2_mem_avx2;
+        kernels.AddMemStream = gf256_add_mem_stream_avx2;
+        kernels.MulAddMemStream = gf256_muladd_mem_stream_avx2;
+        break;
+# endif // GF256_TRY_AVX2
+# if defined(GF256_TRY_AVX512)
+    case GF256_ISA_AVX512:
+        kernels.AddMem = gf256_add_mem_avx512;
+        kernels.Add2Mem = gf256_add2_mem_avx512;
+        kernels.AddSetMem = gf256_addset_mem_avx512;
+        kernels.MulMem = gf256_mul_mem_avx512;
+        kernels.MulAddMem = gf256_muladd_mem_avx512;
+        kernels.MemSwap = gf256_memswap_avx512;
+        kernels.MulAddMulti = gf256_muladd_multi_avx512;
+        kernels.AddMulAdd2Mem = gf256_add_muladd2_mem_avx512;
+        kernels.AddMemStream = gf256_add_mem_stream_avx512;
+        kernels.MulAddMemStream = gf256_muladd_mem_stream_avx512;
+        break;
+# endif // GF256_TRY_AVX512
+# if defined(GF256_TRY_GFNI)
+    case GF256_ISA_GFNI:
+        // XOR kernels come from the widest shuffle instruction set
+        kernels.AddMem = gf256_add_mem_avx2;
+        kernels.Add2Mem = gf256_add2_mem_avx2;
+        kernels.AddSetMem = gf256_addset_mem_avx2;
+        kernels.MulMem = gf256_mul_mem_gfni_avx2;
+        kernels.MulAddMem = gf256_muladd_mem_gfni_avx2;
+        kernels.MemSwap = gf256_memswap_avx2;
+        kernels.MulAddMulti = gf256_muladd_multi_gfni_avx2;
+        kernels.AddMulAdd2Mem = gf256_add_muladd2_mem_gfni_avx2;
+        kernels.AddMemStream = gf256_add_mem_stream_avx2;
+        kernels.MulAddMemStream = gf256_muladd_mem_stream_gfni_avx2;
+        if (CpuHasAVX512)
+        {
+            kernels.AddMem = gf256_add_mem_avx512;
+            kernels.Add2Mem = gf256_add2_mem_avx512;
+            kernels.AddSetMem = gf256_addset_mem_avx512;
+            kernels.MulMem = gf256_mul_mem_gfni_avx512;
+            kernels.MulAddMem = gf256_muladd_mem_gfni_avx512;
+            kernels.MemSwap = gf256_memswap_avx512;
+            kernels.MulAddMulti = gf256_muladd_multi_gfni_avx512;
+            kernels.AddMulAdd2Mem = gf256_add_muladd2_mem_gfni_avx512;
+            kernels.AddMemStream = gf256_add_mem_stream_avx512;
+            kernels.MulAddMemStream = gf256_muladd_mem_stream_gfni_avx512;
+        }
+        break;
+# endif // GF256_TRY_GFNI
+#endif // GF256_TARGET_MOBILE
+    default:
+        break;
+    }
 
-        if (bytes >= 32)
+    // Instruction sets without streaming stores use their regular kernels
+    if (!kernels.AddMemStream)
+        kernels.AddMemStream = kernels.AddMem;
+    if (!kernels.MulAddMemStream)
+        kernels.MulAddMemStream = kernels.MulAddMem;
+
+    const gf256_kernels previousKernels = Kernels;
+    const int previousISA = SelectedISA;
+    Kernels = kernels;
+    SelectedISA = isa;
+
+    // Self-test the kernels the first time they are selected
+    if (SelfTestResult[isa] == 0)
+        SelfTestResult[isa] = gf256_self_test() ? 1 : -1;
+
+    if (SelfTestResult[isa] < 0)
+    {
+        Kernels = previousKernels;
+        SelectedISA = previousISA;
+        return -2;
+    }
+
+    return 0;
+}
+
+
+//------------------------------------------------------------------------------
+// Thread Pool
+//
+// Operations larger than ParallelMinBytes are split into stripes that the
+// worker threads and the calling thread claim one at a time, so a slow thread
+// does not hold up the others.  Stripes are small enough that each one stays
+// in cache while its kernel runs.
+
+static const unsigned kParallelStripeBytes = 64 * 1024;
+
+// Operations at least this large use the thread pool
+static const int kParallelDisabled = 0x7fffffff;
+static int ParallelMinBytes = kParallelDisabled;
+
+// Processes bytes [offset, offset + bytes) of an operation
+typedef std::function<void(unsigned offset, unsigned bytes)> gf256_stripe_fn;
+
+struct gf256_thread_pool
+{
+    ~gf256_thread_pool()
+    {
+        Stop();
+    }
+
+    // Returns false if the threads could not be started
+    bool Start(unsigned workerCount)
+    {
+        Stop();
+
+        try
         {
-            GF256_M256 x0 = _mm256_loadu_si256(x32);
-            GF256_M256 l0 = _mm256_and_si256(x0, clr_mask);
-            x0 = _mm256_srli_epi64(x0, 4);
-            GF256_M256 h0 = _mm256_and_si256(x0, clr_mask);
-            l0 = _mm256_shuffle_epi8(table_lo_y, l0);
-            h0 = _mm256_shuffle_epi8(table_hi_y, h0);
-            const GF256_M256 p0 = _mm256_xor_si256(l0, h0);
-            const GF256_M256 z0 = _mm256_loadu_si256(z32);
-            _mm256_storeu_si256(z32, _mm256_xor_si256(p0, z0));
+            for (unsigned i = 0; i < workerCount; ++i)
+                Workers.emplace_back(&gf256_thread_pool::WorkerLoop, this, Generation);
+        }
+        catch (...)
+        {
+            Stop();
+            return false;
+        }
 
-            bytes -= 32;
-            z32++;
-            x32++;
+        return true;
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> locker(WorkLock);
+            Terminating = true;
         }
+        WorkCondition.notify_all();
 
-        z16 = reinterpret_cast<GF256_M128 *>(z32);
-        x16 = reinterpret_cast<const GF256_M128 *>(x32);
+        for (std::thread& worker : Workers)
+            worker.join();
+        Workers.clear();
+        Terminating = false;
     }
-# endif // GF256_TRY_AVX2
-    if (bytes >= 16 && CpuHasSSSE3)
+
+    // Returns false without doing any work if the pool is busy or empty
+    bool Run(unsigned bytes, const gf256_stripe_fn& fn)
     {
-        // Partial product tables; see above
-        const GF256_M128 table_lo_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_LO_Y + y);
-        const GF256_M128 table_hi_y = _mm_loadu_si128(GF256Ctx.MM128.TABLE_HI_Y + y);
+        std::unique_lock<std::mutex> jobLocker(JobLock, std::try_to_lock);
+        if (!jobLocker.owns_lock() || Workers.empty())
+            return false;
 
-        // clr_mask = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
-        const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+        Job = &fn;
+        JobBytes = bytes;
+        StripeCount = (bytes + kParallelStripeBytes - 1) / kParallelStripeBytes;
+        NextStripe = 0;
 
-        // This unroll seems to provide about 7% speed boost when AVX2 is disabled
-        while (bytes >= 32)
         {
-            bytes -= 32;
+            std::lock_guard<std::mutex> locker(WorkLock);
+            BusyWorkers = static_cast<unsigned>(Workers.size());
+            ++Generation;
+        }
+        WorkCondition.notify_all();
 
-            GF256_M128 x1 = _mm_loadu_si128(x16 + 1);
-            GF256_M128 l1 = _mm_and_si128(x1, clr_mask);
-            x1 = _mm_srli_epi64(x1, 4);
-            GF256_M128 h1 = _mm_and_si128(x1, clr_mask);
-            l1 = _mm_shuffle_epi8(table_lo_y, l1);
-            h1 = _mm_shuffle_epi8(table_hi_y, h1);
-            const GF256_M128 z1 = _mm_loadu_si128(z16 + 1);
+        RunStripes();
 
-            GF256_M128 x0 = _mm_loadu_si128(x16);
-            GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
-            x0 = _mm_srli_epi64(x0, 4);
-            GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
-            l0 = _mm_shuffle_epi8(table_lo_y, l0);
-            h0 = _mm_shuffle_epi8(table_hi_y, h0);
-            const GF256_M128 z0 = _mm_loadu_si128(z16);
+        // Wait for every worker to finish with the job before it goes away
+        std::unique_lock<std::mutex> locker(WorkLock);
+        DoneCondition.wait(locker, [this]() { return BusyWorkers == 0; });
+        return true;
+    }
 
-            const GF256_M128 p1 = _mm_xor_si128(l1, h1);
-            _mm_storeu_si128(z16 + 1, _mm_xor_si128(p1, z1));
+private:
+    std::vector<std::thread> Workers;
 
-            const GF256_M128 p0 = _mm_xor_si128(l0, h0);
-            _mm_storeu_si128(z16, _mm_xor_si128(p0, z0));
+    // Held while a job is using the pool
+    std::mutex JobLock;
 
-            x16 += 2, z16 += 2;
+    // Protects Generation, BusyWorkers and Terminating
+    std::mutex WorkLock;
+    std::condition_variable WorkCondition;
+    std::condition_variable DoneCondition;
+    uint64_t Generation = 0;
+    unsigned BusyWorkers = 0;
+    bool Terminating = false;
+
+    // Current job
+    const gf256_stripe_fn* Job = nullptr;
+    unsigned JobBytes = 0;
+    unsigned StripeCount = 0;
+    std::atomic<unsigned> NextStripe{0};
+
+    void RunStripes()
+    {
+        for (;;)
+        {
+            const unsigned stripe = NextStripe++;
+            if (stripe >= StripeCount)
+                break;
+
+            const unsigned offset = stripe * kParallelStripeBytes;
+            unsigned bytes = JobBytes - offset;
+            if (bytes > kParallelStripeBytes)
+                bytes = kParallelStripeBytes;
+
+            (*Job)(offset, bytes);
         }
+    }
 
-        // Handle multiples of 16 bytes
-        while (bytes >= 16)
+    // Runs each job started after seenGeneration
+    void WorkerLoop(uint64_t seenGeneration)
+    {
+        std::unique_lock<std::mutex> locker(WorkLock);
+
+        for (;;)
         {
-            // See above comments for details
-            GF256_M128 x0 = _mm_loadu_si128(x16);
-            GF256_M128 l0 = _mm_and_si128(x0, clr_mask);
-            x0 = _mm_srli_epi64(x0, 4);
-            GF256_M128 h0 = _mm_and_si128(x0, clr_mask);
-            l0 = _mm_shuffle_epi8(table_lo_y, l0);
-            h0 = _mm_shuffle_epi8(table_hi_y, h0);
-            const GF256_M128 p0 = _mm_xor_si128(l0, h0);
-            const GF256_M128 z0 = _mm_loadu_si128(z16);
-            _mm_storeu_si128(z16, _mm_xor_si128(p0, z0));
+            WorkCondition.wait(locker, [&]() { return Terminating || Generation != seenGeneration; });
+            if (Terminating)
+                return;
+            seenGeneration = Generation;
+
+            locker.unlock();
+            RunStripes();
+            locker.lock();
 
-            bytes -= 16, ++x16, ++z16;
+            if (--BusyWorkers == 0)
+                DoneCondition.notify_one();
         }
     }
-#endif // GF256_TARGET_MOBILE
+};
 
-    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t*>(z16);
-    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t*>(x16);
-    const uint8_t * GF256_RESTRICT table = GF256Ctx.GF256_MUL_TABLE + ((unsigned)y << 8);
+static gf256_thread_pool ThreadPool;
 
-    // Handle blocks of 8 bytes
-    while (bytes >= 8)
+extern "C" int gf256_set_parallelism(unsigned threads, unsigned minBytes)
+{
+    ParallelMinBytes = kParallelDisabled;
+
+    if (threads <= 1)
     {
-        uint64_t * GF256_RESTRICT z8 = reinterpret_cast<uint64_t *>(z1);
-        uint64_t word = table[x1[0]];
-        word |= (uint64_t)table[x1[1]] << 8;
-        word |= (uint64_t)table[x1[2]] << 16;
-        word |= (uint64_t)table[x1[3]] << 24;
-        word |= (uint64_t)table[x1[4]] << 32;
-        word |= (uint64_t)table[x1[5]] << 40;
-        word |= (uint64_t)table[x1[6]] << 48;
-        word |= (uint64_t)table[x1[7]] << 56;
-        *z8 ^= word;
+        ThreadPool.Stop();
+        return 0;
+    }
 
-        bytes -= 8, x1 += 8, z1 += 8;
+    if (!ThreadPool.Start(threads - 1))
+        return -1;
+
+    // Splitting makes no sense unless there are at least two stripes
+    if (minBytes < 2 * kParallelStripeBytes)
+        minBytes = 2 * kParallelStripeBytes;
+    if (minBytes < (unsigned)kParallelDisabled)
+        ParallelMinBytes = static_cast<int>(minBytes);
+
+    return 0;
+}
+
+// Accumulates bytes [offset, offset + bytes) of each source into z[]
+static void gf256_muladd_multi_range(uint8_t * GF256_RESTRICT z, const uint8_t * GF256_RESTRICT coeffs,
+                                     const void * const * GF256_RESTRICT srcs,
+                                     const unsigned * GF256_RESTRICT lens, unsigned count,
+                                     unsigned offset, unsigned bytes)
+{
+    static const unsigned kBatchCount = 32;
+    uint8_t batchCoeffs[kBatchCount];
+    const void* batchSrcs[kBatchCount];
+    unsigned batchLens[kBatchCount];
+    unsigned batchCount = 0;
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (lens[i] <= offset)
+            continue;
+        unsigned len = lens[i] - offset;
+        if (len > bytes)
+            len = bytes;
+
+        batchCoeffs[batchCount] = coeffs[i];
+        batchSrcs[batchCount] = reinterpret_cast<const uint8_t *>(srcs[i]) + offset;
+        batchLens[batchCount] = len;
+        if (++batchCount >= kBatchCount)
+        {
+            Kernels.MulAddMulti(z, batchCoeffs, batchSrcs, batchLens, batchCount);
+            batchCount = 0;
+        }
     }
 
-    // Handle a block of 4 bytes
-    const int four = bytes & 4;
-    if (four)
+    if (batchCount > 0)
+        Kernels.MulAddMulti(z, batchCoeffs, batchSrcs, batchLens, batchCount);
+}
+
+
+//------------------------------------------------------------------------------
+// Operations
+
+extern "C" void gf256_add_mem(void * GF256_RESTRICT vx,
+                              const void * GF256_RESTRICT vy, int bytes)
+{
+    if (bytes >= ParallelMinBytes)
     {
-        uint32_t * GF256_RESTRICT z4 = reinterpret_cast<uint32_t *>(z1);
-        uint32_t word = table[x1[0]];
-        word |= (uint32_t)table[x1[1]] << 8;
-        word |= (uint32_t)table[x1[2]] << 16;
-        word |= (uint32_t)table[x1[3]] << 24;
-        *z4 ^= word;
+        uint8_t * GF256_RESTRICT x1 = reinterpret_cast<uint8_t *>(vx);
+        const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(vy);
+        if (ThreadPool.Run(bytes, [=](unsigned offset, unsigned count) {
+            Kernels.AddMem(x1 + offset, y1 + offset, count);
+        }))
+            return;
     }
 
-    // Handle single bytes
-    const int offset = four;
-    switch (bytes & 3)
+    Kernels.AddMem(vx, vy, bytes);
+}
+
+extern "C" void gf256_add2_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                               const void * GF256_RESTRICT vy, int bytes)
+{
+    if (bytes >= ParallelMinBytes)
     {
-    case 3: z1[offset + 2] ^= table[x1[offset + 2]];
-    case 2: z1[offset + 1] ^= table[x1[offset + 1]];
-    case 1: z1[offset] ^= table[x1[offset]];
-    default:
-        break;
+        uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+        const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(vx);
+        const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(vy);
+        if (ThreadPool.Run(bytes, [=](unsigned offset, unsigned count) {
+            Kernels.Add2Mem(z1 + offset, x1 + offset, y1 + offset, count);
+        }))
+            return;
     }
+
+    Kernels.Add2Mem(vz, vx, vy, bytes);
 }
 
-extern "C" void gf256_memswap(void * GF256_RESTRICT vx, void * GF256_RESTRICT vy, int bytes)
+extern "C" void gf256_addset_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx,
+                                 const void * GF256_RESTRICT vy, int bytes)
 {
-#if defined(GF256_TARGET_MOBILE)
-    uint64_t * GF256_RESTRICT x16 = reinterpret_cast<uint64_t *>(vx);
-    uint64_t * GF256_RESTRICT y16 = reinterpret_cast<uint64_t *>(vy);
+    if (bytes >= ParallelMinBytes)
+    {
+        uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+        const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(vx);
+        const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(vy);
+        if (ThreadPool.Run(bytes, [=](unsigned offset, unsigned count) {
+            Kernels.AddSetMem(z1 + offset, x1 + offset, y1 + offset, count);
+        }))
+            return;
+    }
 
-    const unsigned count = (unsigned)bytes / 8;
-    for (unsigned ii = 0; ii < count; ++ii)
+    Kernels.AddSetMem(vz, vx, vy, bytes);
+}
+
+extern "C" void gf256_mul_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx, uint8_t y, int bytes)
+{
+    // Use a single if-statement to handle special cases
+    if (y <= 1)
+    {
+        if (y == 0)
+            memset(vz, 0, bytes);
+        else if (vz != vx)
+            memcpy(vz, vx, bytes);
+        return;
+    }
+
+    if (bytes >= ParallelMinBytes)
     {
-        const uint64_t temp = x16[ii];
-        x16[ii] = y16[ii];
-        y16[ii] = temp;
+        uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+        const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(vx);
+        if (ThreadPool.Run(bytes, [=](unsigned offset, unsigned count) {
+            Kernels.MulMem(z1 + offset, x1 + offset, y, count);
+        }))
+            return;
     }
 
-    x16 += count;
-    y16 += count;
-#else
-    GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<GF256_M128 *>(vx);
-    GF256_M128 * GF256_RESTRICT y16 = reinterpret_cast<GF256_M128 *>(vy);
+    Kernels.MulMem(vz, vx, y, bytes);
+}
 
-    // Handle blocks of 16 bytes
-    while (bytes >= 16)
+extern "C" void gf256_muladd_mem(void * GF256_RESTRICT vz, uint8_t y,
+                                 const void * GF256_RESTRICT vx, int bytes)
+{
+    // Use a single if-statement to handle special cases
+    if (y <= 1)
     {
-        GF256_M128 x0 = _mm_loadu_si128(x16);
-        GF256_M128 y0 = _mm_loadu_si128(y16);
-        _mm_storeu_si128(x16, y0);
-        _mm_storeu_si128(y16, x0);
+        if (y == 1)
+            gf256_add_mem(vz, vx, bytes);
+        return;
+    }
 
-        bytes -= 16, ++x16, ++y16;
+    if (bytes >= ParallelMinBytes)
+    {
+        uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+        const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(vx);
+        if (ThreadPool.Run(bytes, [=](unsigned offset, unsigned count) {
+            Kernels.MulAddMem(z1 + offset, y, x1 + offset, count);
+        }))
+            return;
     }
-#endif
 
-    uint8_t * GF256_RESTRICT x1 = reinterpret_cast<uint8_t *>(x16);
-    uint8_t * GF256_RESTRICT y1 = reinterpret_cast<uint8_t *>(y16);
+    Kernels.MulAddMem(vz, y, vx, bytes);
+}
 
-    // Handle a block of 8 bytes
-    const int eight = bytes & 8;
-    if (eight)
+extern "C" void gf256_add_mem_stream(void * GF256_RESTRICT vx,
+                                     const void * GF256_RESTRICT vy, int bytes)
+{
+    if (bytes >= ParallelMinBytes)
     {
-        uint64_t * GF256_RESTRICT x8 = reinterpret_cast<uint64_t *>(x1);
-        uint64_t * GF256_RESTRICT y8 = reinterpret_cast<uint64_t *>(y1);
+        uint8_t * GF256_RESTRICT x1 = reinterpret_cast<uint8_t *>(vx);
+        const uint8_t * GF256_RESTRICT y1 = reinterpret_cast<const uint8_t *>(vy);
+        if (ThreadPool.Run(bytes, [=](unsigned offset, unsigned count) {
+            Kernels.AddMemStream(x1 + offset, y1 + offset, count);
+        }))
+            return;
+    }
 
-        uint64_t temp = *x8;
-        *x8 = *y8;
-        *y8 = temp;
+    Kernels.AddMemStream(vx, vy, bytes);
+}
+
+extern "C" void gf256_muladd_mem_stream(void * GF256_RESTRICT vz, uint8_t y,
+                                        const void * GF256_RESTRICT vx, int bytes)
+{
+    // Use a single if-statement to handle special cases
+    if (y <= 1)
+    {
+        if (y == 1)
+            gf256_add_mem_stream(vz, vx, bytes);
+        return;
     }
 
-    // Handle a block of 4 bytes
-    const int four = bytes & 4;
-    if (four)
+    if (bytes >= ParallelMinBytes)
     {
-        uint32_t * GF256_RESTRICT x4 = reinterpret_cast<uint32_t *>(x1 + eight);
-        uint32_t * GF256_RESTRICT y4 = reinterpret_cast<uint32_t *>(y1 + eight);
+        uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+        const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(vx);
+        if (ThreadPool.Run(bytes, [=](unsigned offset, unsigned count) {
+            Kernels.MulAddMemStream(z1 + offset, y, x1 + offset, count);
+        }))
+            return;
+    }
 
-        uint32_t temp = *x4;
-        *x4 = *y4;
-        *y4 = temp;
+    Kernels.MulAddMemStream(vz, y, vx, bytes);
+}
+
+extern "C" void gf256_muladd_multi(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+                                   const void * const * GF256_RESTRICT srcs,
+                                   const unsigned * GF256_RESTRICT lens, unsigned count)
+{
+    if (ParallelMinBytes != kParallelDisabled)
+    {
+        const unsigned bytes = gf256_multi_max_bytes(lens, count);
+        uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz);
+        if (bytes >= (unsigned)ParallelMinBytes &&
+            ThreadPool.Run(bytes, [=](unsigned offset, unsigned stripeBytes) {
+                gf256_muladd_multi_range(z1 + offset, coeffs, srcs, lens, count, offset, stripeBytes);
+            }))
+            return;
     }
 
-    // Handle final bytes
-    const int offset = eight + four;
-    uint8_t temp;
-    switch (bytes & 3)
+    Kernels.MulAddMulti(vz, coeffs, srcs, lens, count);
+}
+
+extern "C" void gf256_add_muladd2_mem(void * GF256_RESTRICT vz0,
+                                      void * GF256_RESTRICT vz1, uint8_t y1,
+                                      void * GF256_RESTRICT vz2, uint8_t y2,
+                                      const void * GF256_RESTRICT vx, int bytes)
+{
+    // Kernels assume y1, y2 >= 2
+    if (y1 <= 1 || y2 <= 1)
     {
-    case 3: temp = x1[offset + 2]; x1[offset + 2] = y1[offset + 2]; y1[offset + 2] = temp;
-    case 2: temp = x1[offset + 1]; x1[offset + 1] = y1[offset + 1]; y1[offset + 1] = temp;
-    case 1: temp = x1[offset]; x1[offset] = y1[offset]; y1[offset] = temp;
-    default:
-        break;
+        gf256_add_mem(vz0, vx, bytes);
+        gf256_muladd_mem(vz1, y1, vx, bytes);
+        gf256_muladd_mem(vz2, y2, vx, bytes);
+        return;
+    }
+
+    if (bytes >= ParallelMinBytes)
+    {
+        uint8_t * GF256_RESTRICT z0 = reinterpret_cast<uint8_t *>(vz0);
+        uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t *>(vz1);
+        uint8_t * GF256_RESTRICT z2 = reinterpret_cast<uint8_t *>(vz2);
+        const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t *>(vx);
+        if (ThreadPool.Run(bytes, [=](unsigned offset, unsigned count) {
+            Kernels.AddMulAdd2Mem(z0 + offset, z1 + offset, y1, z2 + offset, y2, x1 + offset, count);
+        }))
+            return;
     }
+
+    Kernels.AddMulAdd2Mem(vz0, vz1, y1, vz2, y2, vx, bytes);
+}
+
+extern "C" void gf256_memswap(void * GF256_RESTRICT vx, void * GF256_RESTRICT vy, int bytes)
+{
+    if (bytes >= ParallelMinBytes)
+    {
+        uint8_t * GF256_RESTRICT x1 = reinterpret_cast<uint8_t *>(vx);
+        uint8_t * GF256_RESTRICT y1 = reinterpret_cast<uint8_t *>(vy);
+        if (ThreadPool.Run(bytes, [=](unsigned offset, unsigned count) {
+            Kernels.MemSwap(x1 + offset, y1 + offset, count);
+        }))
+            return;
+    }
+
+    Kernels.MemSwap(vx, vy, bytes);
 }
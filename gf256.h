@@ -56,9 +56,35 @@
     #define GF256_TARGET_MOBILE
 #endif // ANDROID
 
-#if defined(__AVX2__) || (defined (_MSC_VER) && _MSC_VER >= 1900)
+// GCC vector extensions provide a portable byte shuffle for the multiply
+// kernels on targets without SSSE3 or NEON.  Clang only supports shuffles
+// with constant indices, so it uses the table-based portable kernels
+#if defined(__GNUC__) && !defined(__clang__)
+    #define GF256_TRY_VECTOR_EXT
+#endif
+
+// AVX2 kernels are compiled with target attributes and selected at runtime,
+// so they are available even when the build does not specify -mavx2
+#if !defined(GF256_TARGET_MOBILE) && \
+    (defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1900))
     #define GF256_TRY_AVX2 /* 256-bit */
     #include <immintrin.h>
+#endif
+
+// AVX-512BW kernels are compiled and selected the same way as AVX2
+#if defined(GF256_TRY_AVX2) && (!defined(_MSC_VER) || _MSC_VER >= 1911)
+    #define GF256_TRY_AVX512 /* 512-bit */
+#endif
+
+// GFNI kernels require a compiler that provides the gf2p8affineqb intrinsics
+#if defined(GF256_TRY_AVX512) && \
+    ((defined(__clang__) && __clang_major__ >= 7) || \
+     (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 8) || \
+     (defined(_MSC_VER) && _MSC_VER >= 1920))
+    #define GF256_TRY_GFNI /* Galois Field New Instructions */
+#endif
+
+#if defined(__AVX2__) || (defined (_MSC_VER) && _MSC_VER >= 1900)
     #define GF256_ALIGN_BYTES 32
 #else // __AVX2__
     #define GF256_ALIGN_BYTES 16
@@ -98,6 +124,11 @@
     #define GF256_M256 __m256i
 #endif
 
+#ifdef GF256_TRY_AVX512
+    // Compiler-specific 512-bit SIMD register keyword
+    #define GF256_M512 __m512i
+#endif
+
 // Compiler-specific C++11 restrict keyword
 #define GF256_RESTRICT __restrict
 
@@ -124,7 +155,9 @@ extern "C" {
 //------------------------------------------------------------------------------
 // GF(256) Context
 //
-// The context object stores tables required to perform library calculations
+// The context object stores tables required to perform library calculations.
+// The tables are generated at compile time for the default polynomial, so
+// they live in read-only memory and need no initialization.
 
 #ifdef _MSC_VER
     #pragma warning(push)
@@ -135,22 +168,22 @@ struct gf256_ctx
 {
     // We require memory to be aligned since the SIMD instructions benefit from
     // or require aligned accesses to the table data.
+    // Wider SIMD kernels broadcast these into each 128-bit lane when loading.
     struct
     {
-        GF256_ALIGNED GF256_M128 TABLE_LO_Y[256];
-        GF256_ALIGNED GF256_M128 TABLE_HI_Y[256];
+        // Products of y with 0..15 and with (0..15) << 4
+        GF256_ALIGNED uint8_t TABLE_LO_Y[256][16];
+        GF256_ALIGNED uint8_t TABLE_HI_Y[256][16];
     } MM128;
-#ifdef GF256_TRY_AVX2
+#ifdef GF256_TRY_GFNI
     struct
     {
-        GF256_ALIGNED GF256_M256 TABLE_LO_Y[256];
-        GF256_ALIGNED GF256_M256 TABLE_HI_Y[256];
-    } MM256;
-#endif // GF256_TRY_AVX2
-
-    // Mul/Div/Inv/Sqr tables
-    uint8_t GF256_MUL_TABLE[256 * 256];
-    uint8_t GF256_DIV_TABLE[256 * 256];
+        // 8x8 bit-matrix that multiplies by y, in gf2p8affineqb layout
+        uint64_t AFFINE_Y[256];
+    } GFNI;
+#endif // GF256_TRY_GFNI
+
+    // Inv/Sqr tables
     uint8_t GF256_INV_TABLE[256];
     uint8_t GF256_SQR_TABLE[256];
 
@@ -166,26 +199,20 @@ struct gf256_ctx
     #pragma warning(pop)
 #endif // _MSC_VER
 
-extern gf256_ctx GF256Ctx;
+extern const gf256_ctx GF256Ctx;
 
 
 //------------------------------------------------------------------------------
 // Initialization
 //
-// Initialize a context, filling in the tables.
+// Checks the CPU and selects the bulk memory kernels.
 //
 // Thread-safety / Usage Notes:
 //
-// It is perfectly safe and encouraged to use a gf256_ctx object from multiple
-// threads.  The gf256_init() is relatively expensive and should only be done
-// once, though it will take less than a millisecond.
-//
-// The gf256_ctx object must be aligned to 16 byte boundary.
-// Simply tag the object with GF256_ALIGNED to achieve this.
-//
-// Example:
-//    static GF256_ALIGNED gf256_ctx TheGF256Context;
-//    gf256_init(&TheGF256Context, 0);
+// It is perfectly safe and encouraged to use the GF256Ctx tables from multiple
+// threads.  The tables are constant, so gf256_init() only has to check CPU
+// features and self-test the kernels it selects.  It should be called once
+// before the bulk memory operations are used.
 //
 // Returns 0 on success and other values on failure.
 
@@ -193,6 +220,66 @@ extern int gf256_init_(int version);
 #define gf256_init() gf256_init_(GF256_VERSION)
 
 
+//------------------------------------------------------------------------------
+// Instruction Set Selection
+//
+// gf256_init() checks which instruction sets the CPU supports and selects the
+// fastest one.  The kernels for an instruction set are self-tested the first
+// time it is selected, and one that fails is treated as unsupported.
+// The selection is made once so the bulk memory operations below do not need
+// to check CPU features on each call.
+//
+// Overriding the selection is only intended for testing and benchmarking.
+// It is not thread-safe and should be done before any other calls.
+//
+// Building with GF256_FORCE_PORTABLE defined reports only the portable
+// instruction sets as supported, so they can be tested on any computer.
+
+enum gf256_isa_t
+{
+    GF256_ISA_PORTABLE = 0, // Plain C++ code
+    GF256_ISA_VECTOR   = 1, // GCC vector extensions
+    GF256_ISA_NEON     = 2, // ARM NEON
+    GF256_ISA_SSSE3    = 3, // x86 SSSE3
+    GF256_ISA_AVX2     = 4, // x86 AVX2
+    GF256_ISA_AVX512   = 5, // x86 AVX-512BW
+    GF256_ISA_GFNI     = 6, // x86 GFNI multiplies with AVX2 or AVX-512BW
+
+    GF256_ISA_COUNT
+};
+
+// Returns the instruction set currently used by the bulk memory operations
+extern int gf256_get_isa();
+
+// Returns non-zero if the instruction set is supported on this computer.
+// Must be called after gf256_init().
+// An instruction set whose self-test has failed is reported as unsupported.
+extern int gf256_isa_supported(int isa);
+
+// Select the instruction set used by the bulk memory operations.
+// Returns 0 on success or a negative value if it is not supported or it
+// fails its self-test, in which case the previous selection is kept.
+extern int gf256_set_isa(int isa);
+
+
+//------------------------------------------------------------------------------
+// Parallelism
+//
+// Bulk memory operations on at least minBytes bytes are split into cache-sized
+// stripes that are processed by (threads - 1) worker threads together with the
+// calling thread.  By default every operation runs on the calling thread, and
+// passing threads <= 1 stops the worker threads again.
+//
+// One large operation uses the workers at a time.  Large operations started on
+// other threads meanwhile run on their own thread.
+//
+// Like gf256_set_isa(), this is not thread-safe and should be done while no
+// other calls are in progress.
+//
+// Returns 0 on success or a negative value if the threads could not be started.
+extern int gf256_set_parallelism(unsigned threads, unsigned minBytes);
+
+
 //------------------------------------------------------------------------------
 // Math Operations
 
@@ -203,17 +290,18 @@ static GF256_FORCE_INLINE uint8_t gf256_add(uint8_t x, uint8_t y)
 }
 
 // return x * y
-// For repeated multiplication by a constant, it is faster to put the constant in y.
+// The LOG_TABLE entry for 0 indexes into the zero half of the EXP_TABLE,
+// so multiplying by 0 does not need a branch.
 static GF256_FORCE_INLINE uint8_t gf256_mul(uint8_t x, uint8_t y)
 {
-    return GF256Ctx.GF256_MUL_TABLE[((unsigned)y << 8) + x];
+    return GF256Ctx.GF256_EXP_TABLE[GF256Ctx.GF256_LOG_TABLE[x] + GF256Ctx.GF256_LOG_TABLE[y]];
 }
 
 // return x / y
-// Memory-access optimized for constant divisors in y.
+// Returns 0 for y = 0.
 static GF256_FORCE_INLINE uint8_t gf256_div(uint8_t x, uint8_t y)
 {
-    return GF256Ctx.GF256_DIV_TABLE[((unsigned)y << 8) + x];
+    return gf256_mul(x, GF256Ctx.GF256_INV_TABLE[y]);
 }
 
 // return 1 / x
@@ -252,6 +340,32 @@ extern void gf256_mul_mem(void * GF256_RESTRICT vz,
 extern void gf256_muladd_mem(void * GF256_RESTRICT vz, uint8_t y,
                              const void * GF256_RESTRICT vx, int bytes);
 
+// Performs "x[] += y[]" like gf256_add_mem(), but writes x[] with streaming
+// stores that bypass the cache.  This is faster for buffers larger than the
+// cache, and it avoids evicting other data that will be reused soon
+extern void gf256_add_mem_stream(void * GF256_RESTRICT vx,
+                                 const void * GF256_RESTRICT vy, int bytes);
+
+// Performs "z[] += x[] * y" like gf256_muladd_mem(), but writes z[] with
+// streaming stores that bypass the cache
+extern void gf256_muladd_mem_stream(void * GF256_RESTRICT vz, uint8_t y,
+                                    const void * GF256_RESTRICT vx, int bytes);
+
+// Performs "z[] += x_i[] * y_i" for each of count sources x_i with length lens[i].
+// z[] must be at least as long as the longest source.
+// This is faster than calling gf256_muladd_mem() for each source because the
+// destination is only read and written once instead of once per source.
+extern void gf256_muladd_multi(void * GF256_RESTRICT vz, const uint8_t * GF256_RESTRICT coeffs,
+                               const void * const * GF256_RESTRICT srcs,
+                               const unsigned * GF256_RESTRICT lens, unsigned count);
+
+// Performs "z0[] += x[]", "z1[] += x[] * y1" and "z2[] += x[] * y2" together,
+// reading x[] from memory once instead of three times
+extern void gf256_add_muladd2_mem(void * GF256_RESTRICT vz0,
+                                  void * GF256_RESTRICT vz1, uint8_t y1,
+                                  void * GF256_RESTRICT vz2, uint8_t y2,
+                                  const void * GF256_RESTRICT vx, int bytes);
+
 // Performs "x[] /= y" bulk memory operation
 static GF256_FORCE_INLINE void gf256_div_mem(void * GF256_RESTRICT vz,
                                              const void * GF256_RESTRICT vx, uint8_t y, int bytes)
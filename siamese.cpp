@@ -31,6 +31,27 @@
 #include "SiameseEncoder.h"
 #include "SiameseDecoder.h"
 
+// Returns false if the fragments are invalid, or the total length in bytesOut
+static bool GetIOVecBytes(const SiameseIOVec* vecs, unsigned count, unsigned& bytesOut)
+{
+    if (!vecs || count <= 0)
+        return false;
+
+    uint64_t bytes = 0;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (vecs[i].DataBytes > 0 && !vecs[i].Data)
+            return false;
+        bytes += vecs[i].DataBytes;
+    }
+
+    if (bytes <= 0 || bytes > SIAMESE_MAX_PACKET_BYTES)
+        return false;
+
+    bytesOut = static_cast<unsigned>(bytes);
+    return true;
+}
+
 extern "C" {
 
 
@@ -47,10 +68,24 @@ SIAMESE_EXPORT int siamese_init_(int version)
     if (0 != gf256_init())
         return Siamese_Disabled;
 
+    siamese::InitializeRowSumPlans();
+
     m_Initialized = true;
     return Siamese_Success;
 }
 
+SIAMESE_EXPORT int siamese_set_parallelism(unsigned threads, unsigned minBytes)
+{
+    SIAMESE_DEBUG_ASSERT(m_Initialized); // Must call siamese_init() first
+    if (!m_Initialized)
+        return Siamese_Disabled;
+
+    if (0 != gf256_set_parallelism(threads, minBytes))
+        return Siamese_Disabled;
+
+    return Siamese_Success;
+}
+
 
 //------------------------------------------------------------------------------
 // Encoder API
@@ -84,6 +119,56 @@ SIAMESE_EXPORT int siamese_encoder_add(SiameseEncoder encoder_t, SiameseOriginal
     return encoder->Add(*packet);
 }
 
+SIAMESE_EXPORT int siamese_encoder_addv(
+    SiameseEncoder encoder_t,
+    const SiameseIOVec* vecs,
+    unsigned count,
+    SiameseOriginalPacket* packet)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    unsigned bytes = 0;
+    if (!encoder || !packet || !GetIOVecBytes(vecs, count, bytes))
+        return Siamese_InvalidInput;
+
+    packet->DataBytes = bytes;
+    return encoder->AddV(*packet, vecs, count);
+}
+
+SIAMESE_EXPORT int siamese_encoder_add_owned(
+    SiameseEncoder encoder_t,
+    SiameseOriginalPacket* packet,
+    SiameseReleaseCallback release,
+    void* context)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    if (!encoder || !packet || !packet->Data || !release ||
+        packet->DataBytes <= 0 || packet->DataBytes > SIAMESE_MAX_PACKET_BYTES)
+    {
+        return Siamese_InvalidInput;
+    }
+
+    return encoder->AddOwned(*packet, release, context);
+}
+
+SIAMESE_EXPORT int siamese_encoder_set_eager_sums(SiameseEncoder encoder_t, int enabled)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    if (!encoder)
+        return Siamese_InvalidInput;
+
+    encoder->SetEagerSums(enabled != 0);
+    return Siamese_Success;
+}
+
+SIAMESE_EXPORT int siamese_encoder_set_pre_encode(SiameseEncoder encoder_t, unsigned depth)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    if (!encoder || depth > SIAMESE_MAX_PRE_ENCODE)
+        return Siamese_InvalidInput;
+
+    return encoder->SetPreEncode(depth);
+}
+
 SIAMESE_EXPORT int siamese_encoder_get(SiameseEncoder encoder_t, SiameseOriginalPacket* packet)
 {
     siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
@@ -111,7 +196,7 @@ SIAMESE_EXPORT int siamese_encoder_ack(SiameseEncoder encoder_t, const void* buf
     if (!encoder || !buffer || bytes < 1)
         return Siamese_InvalidInput;
 
-    return encoder->Acknowledge((uint8_t*)buffer, bytes);
+    return encoder->Acknowledge(nullptr, (uint8_t*)buffer, bytes);
 }
 
 SIAMESE_EXPORT int siamese_encoder_retransmit(SiameseEncoder encoder_t, unsigned retransmitMsec, SiameseOriginalPacket* original)
@@ -120,7 +205,118 @@ SIAMESE_EXPORT int siamese_encoder_retransmit(SiameseEncoder encoder_t, unsigned
     if (!encoder || !original)
         return Siamese_InvalidInput;
 
-    return encoder->Retransmit(retransmitMsec, *original);
+    return encoder->Retransmit(nullptr, retransmitMsec, *original);
+}
+
+SIAMESE_EXPORT int siamese_encoder_retransmit_into(
+    SiameseEncoder encoder_t,
+    unsigned retransmitMsec,
+    unsigned char* buffer,
+    unsigned capacity,
+    unsigned headroom,
+    unsigned* packetNumOut,
+    unsigned* bytesOut)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    if (!encoder || !buffer || !packetNumOut || !bytesOut)
+        return Siamese_InvalidInput;
+
+    return encoder->RetransmitInto(nullptr, retransmitMsec, buffer, capacity, headroom, *packetNumOut, *bytesOut);
+}
+
+SIAMESE_EXPORT int siamese_encoder_retransmit_batch(
+    SiameseEncoder encoder_t,
+    unsigned retransmitMsec,
+    SiameseOriginalPacket* originals,
+    unsigned maxCount,
+    unsigned* countOut)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    if (!encoder || !originals || maxCount <= 0 || !countOut)
+        return Siamese_InvalidInput;
+
+    return encoder->RetransmitBatch(nullptr, retransmitMsec, originals, maxCount, *countOut);
+}
+
+SIAMESE_EXPORT SiameseReceiver siamese_encoder_add_receiver(SiameseEncoder encoder_t)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    if (!encoder)
+        return nullptr;
+
+    return reinterpret_cast<SiameseReceiver>(encoder->AddReceiver());
+}
+
+SIAMESE_EXPORT void siamese_encoder_remove_receiver(SiameseEncoder encoder_t, SiameseReceiver receiver_t)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    siamese::EncoderAcknowledgementState* receiver = reinterpret_cast<siamese::EncoderAcknowledgementState*>(receiver_t);
+    if (!encoder || !receiver)
+        return;
+
+    encoder->RemoveReceiver(receiver);
+}
+
+SIAMESE_EXPORT int siamese_encoder_receiver_ack(
+    SiameseEncoder encoder_t,
+    SiameseReceiver receiver_t,
+    const void* buffer,
+    unsigned bytes)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    siamese::EncoderAcknowledgementState* receiver = reinterpret_cast<siamese::EncoderAcknowledgementState*>(receiver_t);
+    if (!encoder || !receiver || !buffer || bytes < 1)
+        return Siamese_InvalidInput;
+
+    return encoder->Acknowledge(receiver, (uint8_t*)buffer, bytes);
+}
+
+SIAMESE_EXPORT int siamese_encoder_receiver_retransmit(
+    SiameseEncoder encoder_t,
+    SiameseReceiver receiver_t,
+    unsigned retransmitMsec,
+    SiameseOriginalPacket* original)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    siamese::EncoderAcknowledgementState* receiver = reinterpret_cast<siamese::EncoderAcknowledgementState*>(receiver_t);
+    if (!encoder || !receiver || !original)
+        return Siamese_InvalidInput;
+
+    return encoder->Retransmit(receiver, retransmitMsec, *original);
+}
+
+SIAMESE_EXPORT int siamese_encoder_receiver_retransmit_into(
+    SiameseEncoder encoder_t,
+    SiameseReceiver receiver_t,
+    unsigned retransmitMsec,
+    unsigned char* buffer,
+    unsigned capacity,
+    unsigned headroom,
+    unsigned* packetNumOut,
+    unsigned* bytesOut)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    siamese::EncoderAcknowledgementState* receiver = reinterpret_cast<siamese::EncoderAcknowledgementState*>(receiver_t);
+    if (!encoder || !receiver || !buffer || !packetNumOut || !bytesOut)
+        return Siamese_InvalidInput;
+
+    return encoder->RetransmitInto(receiver, retransmitMsec, buffer, capacity, headroom, *packetNumOut, *bytesOut);
+}
+
+SIAMESE_EXPORT int siamese_encoder_receiver_retransmit_batch(
+    SiameseEncoder encoder_t,
+    SiameseReceiver receiver_t,
+    unsigned retransmitMsec,
+    SiameseOriginalPacket* originals,
+    unsigned maxCount,
+    unsigned* countOut)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    siamese::EncoderAcknowledgementState* receiver = reinterpret_cast<siamese::EncoderAcknowledgementState*>(receiver_t);
+    if (!encoder || !receiver || !originals || maxCount <= 0 || !countOut)
+        return Siamese_InvalidInput;
+
+    return encoder->RetransmitBatch(receiver, retransmitMsec, originals, maxCount, *countOut);
 }
 
 SIAMESE_EXPORT int siamese_encode(SiameseEncoder encoder_t, SiameseRecoveryPacket* recovery)
@@ -132,6 +328,29 @@ SIAMESE_EXPORT int siamese_encode(SiameseEncoder encoder_t, SiameseRecoveryPacke
     return encoder->Encode(*recovery);
 }
 
+SIAMESE_EXPORT int siamese_encode_into(
+    SiameseEncoder encoder_t,
+    unsigned char* buffer,
+    unsigned capacity,
+    unsigned headroom,
+    unsigned* bytesOut)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    if (!encoder || !buffer || !bytesOut)
+        return Siamese_InvalidInput;
+
+    return encoder->EncodeInto(buffer, capacity, headroom, *bytesOut);
+}
+
+SIAMESE_EXPORT int siamese_encode_batch(SiameseEncoder encoder_t, SiameseRecoveryPacket* recovery, unsigned count)
+{
+    siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
+    if (!encoder || !recovery || count <= 0 || count > SIAMESE_MAX_ENCODE_BATCH)
+        return Siamese_InvalidInput;
+
+    return encoder->EncodeBatch(recovery, count);
+}
+
 SIAMESE_EXPORT void* siamese_encoder_mem_alloc(SiameseEncoder encoder_t, unsigned bytes)
 {
     siamese::Encoder* encoder = reinterpret_cast<siamese::Encoder*>(encoder_t);
@@ -195,6 +414,24 @@ SIAMESE_EXPORT int siamese_decoder_add_original(SiameseDecoder decoder_t, const
     return decoder->AddOriginal(*packet);
 }
 
+SIAMESE_EXPORT int siamese_decoder_add_originalv(
+    SiameseDecoder decoder_t,
+    const SiameseIOVec* vecs,
+    unsigned count,
+    unsigned packetNum)
+{
+    siamese::Decoder* decoder = reinterpret_cast<siamese::Decoder*>(decoder_t);
+    unsigned bytes = 0;
+    if (!decoder || !GetIOVecBytes(vecs, count, bytes) || packetNum > SIAMESE_PACKET_NUM_MAX)
+        return Siamese_InvalidInput;
+
+    SiameseOriginalPacket packet;
+    packet.PacketNum = packetNum;
+    packet.DataBytes = bytes;
+    packet.Data      = nullptr;
+    return decoder->AddOriginalV(packet, vecs, count);
+}
+
 SIAMESE_EXPORT int siamese_decoder_add_recovery(SiameseDecoder decoder_t, const SiameseRecoveryPacket* packet)
 {
     siamese::Decoder* decoder = reinterpret_cast<siamese::Decoder*>(decoder_t);
@@ -127,6 +127,23 @@ SIAMESE_EXPORT int siamese_init_(int version);
 #define siamese_init() siamese_init_(SIAMESE_VERSION)
 
 
+//------------------------------------------------------------------------------
+// Parallelism API
+//
+// Math on packets of at least minBytes bytes is split across the calling
+// thread and (threads - 1) worker threads shared by all codecs, so that
+// encoding and decoding very large packets scales with the number of cores.
+// By default the library does not start any threads.  Pass threads <= 1 to
+// stop the worker threads.
+//
+// This should be called after siamese_init() while no codec calls are in
+// progress on other threads.
+//
+// Returns 0 on success and other values on failure.
+
+SIAMESE_EXPORT int siamese_set_parallelism(unsigned threads, unsigned minBytes);
+
+
 //------------------------------------------------------------------------------
 // Shared Constants/Datatypes
 
@@ -173,6 +190,16 @@ typedef enum SiameseResultT
 // Note that the actual overhead is closer to 6 bytes.
 #define SIAMESE_MAX_ENCODE_OVERHEAD     8
 
+// Number of bytes beyond the largest packet to reserve for siamese_encode_into().
+// This covers the packet length field and the recovery metadata footer
+#define SIAMESE_ENCODE_INTO_OVERHEAD   12
+
+// Maximum number of recovery packets generated by one siamese_encode_batch()
+#define SIAMESE_MAX_ENCODE_BATCH       16
+
+// Maximum number of recovery packets kept ready by siamese_encoder_set_pre_encode()
+#define SIAMESE_MAX_PRE_ENCODE         16
+
 // Minimum number of bytes in an acknowledgement buffer
 #define SIAMESE_ACK_MIN_BYTES          16
 
@@ -191,6 +218,13 @@ struct SiameseRecoveryPacket
     const unsigned char* Data; // Recovery packet data
 };
 
+// Fragment of an original data packet, for the scatter-gather functions
+struct SiameseIOVec
+{
+    unsigned DataBytes;        // Length of fragment in bytes
+    const unsigned char* Data; // Fragment data
+};
+
 
 //------------------------------------------------------------------------------
 // Encoder API
@@ -221,6 +255,109 @@ SIAMESE_EXPORT void siamese_encoder_free(SiameseEncoder encoder);
 */
 SIAMESE_EXPORT int siamese_encoder_add(SiameseEncoder encoder, SiameseOriginalPacket* packet);
 
+/*
+    Add a packet of data gathered from several fragments to the end of the
+    protected set.
+
+    This is the same as siamese_encoder_add() except that the packet data is
+    the concatenation of vecs[0..count-1], which is copied directly into the
+    encoder without first linearizing it.  Fragments may be empty.
+
+    packet->PacketNum will be set to the next packet number.
+    packet->DataBytes will be set to the total length of the packet.
+
+    Returns 0 on success and other codes on error.
+    Returns Siamese_MaxPacketsReached if SIAMESE_MAX_PACKETS are added.
+*/
+SIAMESE_EXPORT int siamese_encoder_addv(
+    SiameseEncoder encoder,
+    const SiameseIOVec* vecs,
+    unsigned count,
+    SiameseOriginalPacket* packet);
+
+// Number of writable bytes required in front of packet data for siamese_encoder_add_owned()
+#define SIAMESE_OWNED_HEADROOM 4
+
+/*
+    Called when the encoder no longer needs a packet passed to
+    siamese_encoder_add_owned().
+
+    context: The context passed to siamese_encoder_add_owned()
+    data: The packet->Data pointer passed to siamese_encoder_add_owned()
+*/
+typedef void (*SiameseReleaseCallback)(void* context, const unsigned char* data);
+
+/*
+    Add a packet of data to the end of the protected set without copying it.
+
+    This is the same as siamese_encoder_add() except that the encoder keeps a
+    pointer to packet->Data instead of copying the data.  The application must
+    not modify or free the data until the release callback is called.
+
+    The SIAMESE_OWNED_HEADROOM bytes in front of packet->Data must be writable
+    and are overwritten with a packet length field.
+
+    The release callback is called once for each packet, when the packet is
+    removed from the encoder or when the encoder is freed.  Packets that are
+    acknowledged or removed via siamese_encoder_remove_before() are released
+    in groups by a later encoder call.  The callback must not call back into
+    the encoder.
+
+    If this function fails, the application keeps ownership of the data and
+    the release callback is not called.
+
+    Returns 0 on success and other codes on error.
+    Returns Siamese_MaxPacketsReached if SIAMESE_MAX_PACKETS are added.
+*/
+SIAMESE_EXPORT int siamese_encoder_add_owned(
+    SiameseEncoder encoder,
+    SiameseOriginalPacket* packet,
+    SiameseReleaseCallback release,
+    void* context);
+
+/*
+    Choose when the encoder folds new packets into its running sums.
+
+    By default this is done by the next siamese_encode() call, which takes
+    longer after a burst of siamese_encoder_add() calls.  When eager sums are
+    enabled, each siamese_encoder_add() call folds in its packet right away, so
+    the time taken by siamese_encode() does not depend on how many packets were
+    added since the last call.  The total work is the same either way.
+
+    Packets are only folded in eagerly while the encoder is generating the
+    sum-based recovery packets used for larger windows of packets.
+
+    enabled: Nonzero to enable eager sums, or zero for the default behavior
+
+    Returns 0 on success and other codes on error.
+*/
+SIAMESE_EXPORT int siamese_encoder_set_eager_sums(SiameseEncoder encoder, int enabled);
+
+/*
+    Keep the next recovery packets ready on a background thread.
+
+    When enabled, the encoder starts a worker thread that generates the next
+    depth recovery packets after each change to the data.  The next calls to
+    siamese_encode(), siamese_encode_batch() and siamese_encode_into() then
+    hand back the finished packets rather than doing the math on the calling
+    thread, so the sender does not wait on the encoder.
+
+    Ready packets are discarded when new data is added with one of the
+    siamese_encoder_add() functions, since they would not protect it.
+
+    All encoder functions may be called from the application thread as usual;
+    they wait for the worker to finish any packet it is generating.  Release
+    callbacks are still called from the application thread.
+
+    depth: Number of packets to keep ready, up to SIAMESE_MAX_PRE_ENCODE.
+    Zero stops the worker thread and returns to the default behavior.
+
+    Returns 0 on success.
+    Returns Siamese_Disabled if the worker thread could not be started.
+    Returns other codes on error.
+*/
+SIAMESE_EXPORT int siamese_encoder_set_pre_encode(SiameseEncoder encoder, unsigned depth);
+
 /*
     Get a packet that was submitted to the codec.
 
@@ -269,6 +406,158 @@ SIAMESE_EXPORT int siamese_encoder_ack(SiameseEncoder encoder, const void* buffe
 */
 SIAMESE_EXPORT int siamese_encoder_retransmit(SiameseEncoder encoder, unsigned retransmitMsec, SiameseOriginalPacket* original);
 
+/*
+    Returns a packet that should be retransmitted, copied into a buffer.
+
+    This is the same as siamese_encoder_retransmit() except that the original
+    data is written to buffer + headroom, so the application can write its own
+    headers into the first headroom bytes and send the buffer as-is.
+
+    capacity: Number of bytes available at buffer.  It must be at least
+    headroom plus the largest packet passed to siamese_encoder_add().
+    headroom: Number of bytes to leave free at the front of the buffer
+    packetNumOut: Set to the packet number of the retransmitted packet
+    bytesOut: Set to the number of bytes written after the headroom
+
+    Returns 0 on success.
+    Returns Siamese_NeedMoreData if there is no data to retransmit.
+    Returns Siamese_InvalidInput if the packet does not fit in the buffer.
+    Returns other codes on error.
+*/
+SIAMESE_EXPORT int siamese_encoder_retransmit_into(
+    SiameseEncoder encoder,
+    unsigned retransmitMsec,
+    unsigned char* buffer,
+    unsigned capacity,
+    unsigned headroom,
+    unsigned* packetNumOut,
+    unsigned* bytesOut);
+
+/*
+    Returns all packets that should be retransmitted right now.
+
+    This is the same as calling siamese_encoder_retransmit() until it stops
+    returning data, but the clock is read once and each lost packet is returned
+    at most once per call.  Use this to collect a burst of retransmissions after
+    an acknowledgement, for example to pass to sendmmsg().
+
+    The packet data remains valid until the next call to any of the functions
+    below, which may move or free the original data:
+    siamese_encoder_add(), siamese_encoder_addv(), siamese_encoder_add_owned(),
+    siamese_encoder_remove_before(), siamese_encoder_ack(),
+    siamese_encoder_receiver_ack(), siamese_encoder_remove_receiver(),
+    siamese_encode(), siamese_encode_batch(), siamese_encode_into() and
+    siamese_encoder_free().
+
+    retransmitMsec: Minimum time between retransmits milliseconds
+    originals: Array of at least maxCount packets to fill in
+    maxCount: Maximum number of packets to return
+    countOut: Set to the number of packets filled in
+
+    Returns 0 on success.
+    Returns Siamese_NeedMoreData if there is no data to retransmit.
+    Returns other codes on error.
+*/
+SIAMESE_EXPORT int siamese_encoder_retransmit_batch(
+    SiameseEncoder encoder,
+    unsigned retransmitMsec,
+    SiameseOriginalPacket* originals,
+    unsigned maxCount,
+    unsigned* countOut);
+
+/*
+    Multiple receivers
+
+    When the same data is sent to several receivers, one encoder can serve all
+    of them.  The window, running sums and recovery packets are shared, so the
+    cost of siamese_encode() does not grow with the number of receivers.  Each
+    receiver keeps its own acknowledgement state and retransmit queue.
+
+    siamese_encoder_ack() and siamese_encoder_retransmit*() act on the default
+    receiver.  Additional receivers are created with
+    siamese_encoder_add_receiver() and passed to the siamese_encoder_receiver_*()
+    functions, which otherwise behave the same as the functions they mirror.
+
+    Original data is removed from the window only once every receiver has
+    acknowledged it.  A receiver added with siamese_encoder_add_receiver()
+    holds all of the data in the window until its first acknowledgement, so a
+    receiver that stops responding should be removed.
+
+    The default receiver cannot be used alongside added receivers.  While any
+    added receiver exists, siamese_encoder_ack() and siamese_encoder_retransmit*()
+    return Siamese_InvalidInput.  Once siamese_encoder_ack() has been called,
+    siamese_encoder_add_receiver() fails.
+*/
+
+// Receiver object type
+typedef struct SiameseReceiverImpl { int impl; }* SiameseReceiver;
+
+/*
+    Add a receiver that acknowledges the data sent by this encoder.
+
+    Returns 0 on failure, or if siamese_encoder_ack() has been called.
+*/
+SIAMESE_EXPORT SiameseReceiver siamese_encoder_add_receiver(SiameseEncoder encoder);
+
+/*
+    Remove a receiver returned by siamese_encoder_add_receiver().
+
+    Data that only this receiver was holding is removed from the window.
+*/
+SIAMESE_EXPORT void siamese_encoder_remove_receiver(SiameseEncoder encoder, SiameseReceiver receiver);
+
+/*
+    Read an acknowledgement from the decoder of the given receiver.
+
+    Same as siamese_encoder_ack().
+*/
+SIAMESE_EXPORT int siamese_encoder_receiver_ack(
+    SiameseEncoder encoder,
+    SiameseReceiver receiver,
+    const void* buffer,
+    unsigned bytes);
+
+/*
+    Returns a packet that should be retransmitted to the given receiver.
+
+    Same as siamese_encoder_retransmit().
+*/
+SIAMESE_EXPORT int siamese_encoder_receiver_retransmit(
+    SiameseEncoder encoder,
+    SiameseReceiver receiver,
+    unsigned retransmitMsec,
+    SiameseOriginalPacket* original);
+
+/*
+    Returns a packet that should be retransmitted to the given receiver,
+    copied into a buffer.
+
+    Same as siamese_encoder_retransmit_into().
+*/
+SIAMESE_EXPORT int siamese_encoder_receiver_retransmit_into(
+    SiameseEncoder encoder,
+    SiameseReceiver receiver,
+    unsigned retransmitMsec,
+    unsigned char* buffer,
+    unsigned capacity,
+    unsigned headroom,
+    unsigned* packetNumOut,
+    unsigned* bytesOut);
+
+/*
+    Returns all packets that should be retransmitted to the given receiver now.
+
+    Same as siamese_encoder_retransmit_batch(), and the packet data is
+    invalidated by the same calls, including calls for other receivers.
+*/
+SIAMESE_EXPORT int siamese_encoder_receiver_retransmit_batch(
+    SiameseEncoder encoder,
+    SiameseReceiver receiver,
+    unsigned retransmitMsec,
+    SiameseOriginalPacket* originals,
+    unsigned maxCount,
+    unsigned* countOut);
+
 /*
     Encode a recovery packet.
 
@@ -288,6 +577,50 @@ SIAMESE_EXPORT int siamese_encoder_retransmit(SiameseEncoder encoder, unsigned r
 */
 SIAMESE_EXPORT int siamese_encode(SiameseEncoder encoder, SiameseRecoveryPacket* recovery);
 
+/*
+    Encode a recovery packet into a buffer.
+
+    This is the same as siamese_encode() except that the recovery packet is
+    generated in place at buffer + headroom rather than in an internal buffer,
+    so the application can write its own headers into the first headroom bytes
+    and send the buffer without copying the recovery data.
+
+    capacity: Number of bytes available at buffer.  It must be at least
+    headroom plus the largest packet passed to siamese_encoder_add() plus
+    SIAMESE_ENCODE_INTO_OVERHEAD.
+    headroom: Number of bytes to leave free at the front of the buffer
+    bytesOut: Set to the number of bytes written after the headroom
+
+    Returns 0 on success.
+    Returns Siamese_NeedMoreData if there is no data to encode.
+    Returns other codes on error.
+*/
+SIAMESE_EXPORT int siamese_encode_into(
+    SiameseEncoder encoder,
+    unsigned char* buffer,
+    unsigned capacity,
+    unsigned headroom,
+    unsigned* bytesOut);
+
+/*
+    Encode several recovery packets at once.
+
+    Fills in recovery[0..count-1] with the same packets that calling
+    siamese_encode() count times in a row would produce, but the running sums
+    shared by consecutive rows are read once for the whole batch rather than
+    once per packet.  Use this when sending a burst of recovery packets.
+
+    The packet data remains valid until the next call to siamese_encode()
+    or siamese_encode_batch().
+
+    count: Number of packets to generate, from 1 to SIAMESE_MAX_ENCODE_BATCH
+
+    Returns 0 on success.
+    Returns Siamese_NeedMoreData if there is no data to encode.
+    Returns other codes on error.
+*/
+SIAMESE_EXPORT int siamese_encode_batch(SiameseEncoder encoder, SiameseRecoveryPacket* recovery, unsigned count);
+
 /*
     Allocates memory in the same pool used by the encoder.
     Typically more efficient than normal allocation.
@@ -330,6 +663,23 @@ SIAMESE_EXPORT void siamese_decoder_free(SiameseDecoder decoder);
 */
 SIAMESE_EXPORT int siamese_decoder_add_original(SiameseDecoder decoder, const SiameseOriginalPacket* packet);
 
+/*
+    Pass original data gathered from several fragments to the decoder.
+
+    This is the same as siamese_decoder_add_original() except that the packet
+    data is the concatenation of vecs[0..count-1], which is copied directly
+    into the decoder without first linearizing it.  Fragments may be empty.
+
+    packetNum: Packet number of the original packet
+
+    Returns 0 on success and other codes on error.
+*/
+SIAMESE_EXPORT int siamese_decoder_add_originalv(
+    SiameseDecoder decoder,
+    const SiameseIOVec* vecs,
+    unsigned count,
+    unsigned packetNum);
+
 /*
     Pass recovery data to the decoder.
 
@@ -0,0 +1,234 @@
+/*
+    Copyright (c) 2017 Christopher A. Taylor.  All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of Siamese nor the names of its contributors may be
+      used to endorse or promote products derived from this software without
+      specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+    Measures the throughput of each gf256 bulk memory operation for every
+    instruction set the host supports, from 16 bytes to 16 MB, with buffers
+    aligned to a cache line and offset by one byte.
+
+    Throughput is bytes of destination processed per second.  Results are
+    printed as one table per instruction set and written as JSON to the file
+    named on the command line (gf256_bench.json by default), so runs can be
+    compared when the kernels change.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <cstring> // memset
+using namespace std;
+
+#include "../gf256.h"
+#include "../SiameseTools.h"
+
+static const unsigned kMinBytes = 16;
+static const unsigned kMaxBytes = 16 * 1024 * 1024;
+static const uint64_t kBytesPerTest = 32ull * 1024 * 1024;
+
+// Unaligned buffers start this many bytes past a cache line
+static const unsigned kUnalignedOffset = 1;
+
+static const char* kIsaNames[GF256_ISA_COUNT] = {
+    "Portable", "Vector", "NEON", "SSSE3", "AVX2", "AVX512", "GFNI"
+};
+
+// Arbitrary multiplier with both nibbles set
+static const uint8_t kY = 0x8e;
+
+struct BenchBuffers
+{
+    uint8_t* Z[3];
+    uint8_t* X;
+};
+
+struct BenchOp
+{
+    const char* Name;
+    void (*Run)(const BenchBuffers& b, int bytes);
+};
+
+static const BenchOp kOps[] = {
+    { "add_mem", [](const BenchBuffers& b, int bytes) {
+        gf256_add_mem(b.Z[0], b.X, bytes);
+    } },
+    { "add2_mem", [](const BenchBuffers& b, int bytes) {
+        gf256_add2_mem(b.Z[0], b.X, b.Z[1], bytes);
+    } },
+    { "addset_mem", [](const BenchBuffers& b, int bytes) {
+        gf256_addset_mem(b.Z[0], b.X, b.Z[1], bytes);
+    } },
+    { "mul_mem", [](const BenchBuffers& b, int bytes) {
+        gf256_mul_mem(b.Z[0], b.X, kY, bytes);
+    } },
+    { "div_mem", [](const BenchBuffers& b, int bytes) {
+        gf256_div_mem(b.Z[0], b.X, kY, bytes);
+    } },
+    { "muladd_mem", [](const BenchBuffers& b, int bytes) {
+        gf256_muladd_mem(b.Z[0], kY, b.X, bytes);
+    } },
+    { "add_muladd2_mem", [](const BenchBuffers& b, int bytes) {
+        gf256_add_muladd2_mem(b.Z[0], b.Z[1], kY, b.Z[2], kY ^ 1, b.X, bytes);
+    } },
+    { "add_mem_stream", [](const BenchBuffers& b, int bytes) {
+        gf256_add_mem_stream(b.Z[0], b.X, bytes);
+    } },
+    { "muladd_mem_stream", [](const BenchBuffers& b, int bytes) {
+        gf256_muladd_mem_stream(b.Z[0], kY, b.X, bytes);
+    } },
+    { "memswap", [](const BenchBuffers& b, int bytes) {
+        gf256_memswap(b.Z[0], b.X, bytes);
+    } },
+};
+static const unsigned kOpCount = sizeof(kOps) / sizeof(kOps[0]);
+
+struct BenchResult
+{
+    int Isa;
+    unsigned Op;
+    unsigned Bytes;
+    bool Aligned;
+    double GBps;
+};
+
+// Returns GB/s for one operation at one size
+static double RunTrials(const BenchOp& op, const BenchBuffers& b, unsigned bytes)
+{
+    const unsigned trials = 1 + (unsigned)(kBytesPerTest / bytes);
+
+    // Warm up the caches and the selected kernels
+    op.Run(b, (int)bytes);
+
+    const uint64_t t0 = siamese::GetTimeUsec();
+    for (unsigned i = 0; i < trials; ++i)
+        op.Run(b, (int)bytes);
+    const uint64_t t1 = siamese::GetTimeUsec();
+
+    const uint64_t totalBytes = (uint64_t)trials * bytes;
+    return totalBytes / (double)(t1 - t0 + 1) / 1000.;
+}
+
+static void WriteJson(const char* path, const vector<BenchResult>& results)
+{
+    ofstream file(path);
+    if (!file)
+    {
+        cout << "Unable to write " << path << endl;
+        return;
+    }
+
+    file << "{\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult& r = results[i];
+        file << "    { \"isa\": \"" << kIsaNames[r.Isa]
+             << "\", \"op\": \"" << kOps[r.Op].Name
+             << "\", \"bytes\": " << r.Bytes
+             << ", \"aligned\": " << (r.Aligned ? "true" : "false")
+             << ", \"gbps\": " << fixed << setprecision(3) << r.GBps
+             << (i + 1 < results.size() ? " },\n" : " }\n");
+    }
+    file << "  ]\n}\n";
+
+    cout << "Wrote " << results.size() << " results to " << path << endl;
+}
+
+int main(int argc, char** argv)
+{
+    if (0 != gf256_init())
+    {
+        cout << "gf256_init failed" << endl;
+        return -1;
+    }
+
+    const char* jsonPath = (argc > 1) ? argv[1] : "gf256_bench.json";
+
+    // Room for a cache line of alignment plus the unaligned offset
+    static const unsigned kPadBytes = 128;
+    vector<uint8_t> storage[4];
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        storage[i].resize(kMaxBytes + kPadBytes);
+        for (size_t j = 0; j < storage[i].size(); ++j)
+            storage[i][j] = static_cast<uint8_t>(j * (i + 3));
+    }
+
+    const int defaultIsa = gf256_get_isa();
+    vector<BenchResult> results;
+
+    for (int isa = 0; isa < GF256_ISA_COUNT; ++isa)
+    {
+        if (!gf256_isa_supported(isa) || 0 != gf256_set_isa(isa))
+            continue;
+
+        for (int aligned = 1; aligned >= 0; --aligned)
+        {
+            BenchBuffers b;
+            uint8_t* starts[4];
+            for (unsigned i = 0; i < 4; ++i)
+            {
+                uint8_t* p = storage[i].data();
+                p += (64 - ((uintptr_t)p & 63)) & 63;
+                starts[i] = aligned ? p : p + kUnalignedOffset;
+            }
+            b.Z[0] = starts[0];
+            b.Z[1] = starts[1];
+            b.Z[2] = starts[2];
+            b.X = starts[3];
+
+            cout << endl << kIsaNames[isa] << (aligned ? ", aligned" : ", unaligned") << " (GB/s)" << endl;
+            cout << setw(10) << "Bytes";
+            for (unsigned op = 0; op < kOpCount; ++op)
+                cout << setw(19) << kOps[op].Name;
+            cout << endl;
+
+            for (unsigned bytes = kMinBytes; bytes <= kMaxBytes; bytes *= 2)
+            {
+                cout << setw(10) << bytes;
+                for (unsigned op = 0; op < kOpCount; ++op)
+                {
+                    BenchResult r;
+                    r.Isa = isa;
+                    r.Op = op;
+                    r.Bytes = bytes;
+                    r.Aligned = aligned != 0;
+                    r.GBps = RunTrials(kOps[op], b, bytes);
+                    results.push_back(r);
+
+                    cout << setw(19) << fixed << setprecision(2) << r.GBps << flush;
+                }
+                cout << endl;
+            }
+        }
+    }
+
+    gf256_set_isa(defaultIsa);
+
+    WriteJson(jsonPath, results);
+    return 0;
+}
@@ -0,0 +1,130 @@
+/*
+    Copyright (c) 2017 Christopher A. Taylor.  All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of Siamese nor the names of its contributors may be
+      used to endorse or promote products derived from this software without
+      specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+    Finds the buffer size where the streaming gf256 kernels become faster.
+
+    Each trial mimics building a recovery packet: a fixed set of sums, which
+    are reused by every trial, is accumulated into the next of a few rotating
+    output buffers.  The regular kernels keep the outputs in cache at the
+    expense of the sums, while the streaming kernels write the outputs around
+    the cache.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstring> // memset
+using namespace std;
+
+#include "../gf256.h"
+#include "../SiameseTools.h"
+
+static const unsigned kMinBytes = 16 * 1024;
+static const unsigned kMaxBytes = 128 * 1024 * 1024;
+static const unsigned kSumCount = 4;
+static const unsigned kOutputCount = 2;
+static const uint64_t kBytesPerTest = 512ull * 1024 * 1024;
+
+// Returns MB/s of sum data accumulated
+static double RunTrials(vector<vector<uint8_t>>& sums, vector<vector<uint8_t>>& outputs,
+                        unsigned bytes, bool streaming)
+{
+    const unsigned trials = 1 + (unsigned)(kBytesPerTest / ((uint64_t)bytes * kSumCount));
+
+    const uint64_t t0 = siamese::GetTimeUsec();
+
+    for (unsigned trial = 0; trial < trials; ++trial)
+    {
+        uint8_t* output = outputs[trial % kOutputCount].data();
+        memset(output, 0, bytes);
+
+        for (unsigned i = 0; i < kSumCount; ++i)
+        {
+            const uint8_t y = static_cast<uint8_t>(i + 1);
+            if (streaming)
+                gf256_muladd_mem_stream(output, y, sums[i].data(), bytes);
+            else
+                gf256_muladd_mem(output, y, sums[i].data(), bytes);
+        }
+    }
+
+    const uint64_t t1 = siamese::GetTimeUsec();
+
+    const uint64_t totalBytes = (uint64_t)trials * bytes * kSumCount;
+    return totalBytes / (double)(t1 - t0 + 1);
+}
+
+int main()
+{
+    if (0 != gf256_init())
+    {
+        cout << "gf256_init failed" << endl;
+        return -1;
+    }
+
+    vector<vector<uint8_t>> sums(kSumCount), outputs(kOutputCount);
+    for (unsigned i = 0; i < kSumCount; ++i)
+    {
+        sums[i].resize(kMaxBytes);
+        for (unsigned j = 0; j < kMaxBytes; ++j)
+            sums[i][j] = static_cast<uint8_t>(j * (i + 3));
+    }
+    for (unsigned i = 0; i < kOutputCount; ++i)
+        outputs[i].resize(kMaxBytes);
+
+    cout << "Instruction set: " << gf256_get_isa() << endl;
+    cout << setw(10) << "Bytes" << setw(14) << "Regular MB/s" << setw(14) << "Stream MB/s" << setw(10) << "Speedup" << endl;
+
+    unsigned crossover = 0;
+    for (unsigned bytes = kMinBytes; bytes <= kMaxBytes; bytes *= 2)
+    {
+        const double regular = RunTrials(sums, outputs, bytes, false);
+        const double streaming = RunTrials(sums, outputs, bytes, true);
+
+        cout << setw(10) << bytes << fixed << setprecision(0)
+             << setw(14) << regular << setw(14) << streaming
+             << setprecision(2) << setw(10) << streaming / regular << endl;
+
+        // Remember the smallest size from which streaming stays faster
+        if (streaming > regular)
+        {
+            if (crossover == 0)
+                crossover = bytes;
+        }
+        else
+            crossover = 0;
+    }
+
+    if (crossover != 0)
+        cout << "Streaming kernels are faster from " << crossover << " bytes" << endl;
+    else
+        cout << "Streaming kernels were not faster at any tested size" << endl;
+
+    return 0;
+}
@@ -30,6 +30,7 @@
 #include <iomanip>
 #include <cassert>
 #include <vector>
+#include <cstring> // memset
 using namespace std;
 
 #include "../PacketAllocator.h"
@@ -29,9 +29,12 @@
 #include <vector>
 #include <string>
 #include <queue>
+#include <map>
+#include <algorithm>
 using namespace std;
 
 #include "../Logger.h"
+#include "../gf256.h"
 #include "../siamese.h"
 #include "../SiameseTools.h"
 #include "../SiameseSerializers.h"
@@ -44,6 +47,7 @@ using namespace std;
 #define TEST_BLOCK
 //#define TEST_STREAMING
 #define TEST_HARQ_STREAM
+#define TEST_API
 
 //#define HARQ_RETRANSMIT_WITH_FEC
 
@@ -58,6 +62,13 @@ static const unsigned kSeed = 1013;
         #define NOMINMAX
     #endif
     #include <windows.h>
+#else
+    #include <thread> // std::this_thread::sleep_for
+    #include <chrono>
+    static void Sleep(unsigned msec)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(msec));
+    }
 #endif
 
 
@@ -1478,22 +1489,1793 @@ void HARQSimulation::Run()
 #endif // TEST_HARQ_STREAM
 
 
-#ifdef ENABLE_UNIT_TEST
+#ifdef TEST_API
 
-int main()
+//------------------------------------------------------------------------------
+// API Tests
+//
+// Each test returns false on failure.
+
+static const unsigned kApiTestMaxPacketBytes = 1300;
+
+// Pick a packet length for the API tests, including short packets
+static unsigned GetApiTestPacketBytes(siamese::PCGRandom& prng)
 {
-    FunctionTimer t_siamese_init("siamese_init");
+    return 2 + (prng.Next() % (kApiTestMaxPacketBytes - 2));
+}
 
-    t_siamese_init.BeginCall();
-    if (0 != siamese_init())
+// Decoder that checks every packet it delivers and tracks which arrived
+class TestReceiver
+{
+public:
+    SiameseDecoder Decoder = nullptr;
+
+    // First packet number that has not been delivered yet
+    unsigned NextExpectedPacket = 0;
+
+    ~TestReceiver()
     {
-        Logger.Error("Failed to initialize");
-        return -1;
+        siamese_decoder_free(Decoder);
     }
-    t_siamese_init.EndCall();
 
-    t_siamese_init.Print(1);
+    bool Initialize()
+    {
+        Decoder = siamese_decoder_create();
+        if (!Decoder)
+        {
+            Logger.Error("Unable to create decoder");
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+        return true;
+    }
+
+    // Receive an original packet
+    bool OnOriginal(const SiameseOriginalPacket& original)
+    {
+        const int result = siamese_decoder_add_original(Decoder, &original);
+        if (result == Siamese_DuplicateData)
+            return true;
+        if (result)
+        {
+            Logger.Error("Unable to add original data to decoder: ", result);
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+        return OnDelivered(original);
+    }
+
+    // Receive an original packet gathered from fragments
+    bool OnOriginalV(const SiameseIOVec* vecs, unsigned count, unsigned packetNum)
+    {
+        int result = siamese_decoder_add_originalv(Decoder, vecs, count, packetNum);
+        if (result == Siamese_DuplicateData)
+            return true;
+        if (result)
+        {
+            Logger.Error("Unable to add original fragments to decoder: ", result);
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+
+        // Check the packet the decoder put together
+        SiameseOriginalPacket original;
+        original.PacketNum = packetNum;
+        result = siamese_decoder_get(Decoder, &original);
+        if (result)
+        {
+            Logger.Error("Unable to get original from decoder: ", result);
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+        return OnDelivered(original);
+    }
+
+    // Receive a recovery packet and deliver anything it recovers
+    bool OnRecovery(const SiameseRecoveryPacket& recovery)
+    {
+        int result = siamese_decoder_add_recovery(Decoder, &recovery);
+        if (result)
+        {
+            Logger.Error("Unable to add recovery data to decoder: ", result);
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+
+        while (siamese_decoder_is_ready(Decoder) == Siamese_Success)
+        {
+            SiameseOriginalPacket* packets = nullptr;
+            unsigned packetCount = 0;
+
+            result = siamese_decode(Decoder, &packets, &packetCount);
+            if (result == Siamese_NeedMoreData)
+                break;
+            if (result)
+            {
+                Logger.Error("Decode returned ", result);
+                SIAMESE_DEBUG_BREAK();
+                return false;
+            }
+
+            for (unsigned i = 0; i < packetCount; ++i)
+                if (!OnDelivered(packets[i]))
+                    return false;
+        }
+        return true;
+    }
+
+    // Send an acknowledgement to the encoder, for the default receiver if receiver is null
+    bool SendAck(SiameseEncoder encoder, SiameseReceiver receiver = nullptr)
+    {
+        uint8_t ack[2000];
+        unsigned usedBytes = 0;
+        int result = siamese_decoder_ack(Decoder, ack, (unsigned)sizeof(ack), 0, &usedBytes);
+        if (result == Siamese_NeedMoreData)
+            return true;
+        if (!result)
+        {
+            if (receiver)
+                result = siamese_encoder_receiver_ack(encoder, receiver, ack, usedBytes);
+            else
+                result = siamese_encoder_ack(encoder, ack, usedBytes);
+        }
+        if (result)
+        {
+            Logger.Error("Acknowledgement failed: ", result);
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+        return true;
+    }
+
+    bool WasDelivered(unsigned packetNum) const
+    {
+        return packetNum < Delivered.size() && Delivered[packetNum];
+    }
+
+protected:
+    std::vector<bool> Delivered;
+
+    bool OnDelivered(const SiameseOriginalPacket& original)
+    {
+        if (!CheckPacket(original.Data, original.DataBytes))
+        {
+            Logger.Error("Packet check failed for ", original.PacketNum, ".DataBytes = ", original.DataBytes);
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+        if (WasDelivered(original.PacketNum))
+        {
+            Logger.Error("Packet ", original.PacketNum, " delivered twice");
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+
+        if (Delivered.size() <= original.PacketNum)
+            Delivered.resize(original.PacketNum + 1, false);
+        Delivered[original.PacketNum] = true;
+
+        while (WasDelivered(NextExpectedPacket))
+            ++NextExpectedPacket;
+        return true;
+    }
+};
+
+// Send recovery packets until the receiver has every packet before packetCount
+static bool RecoverAll(SiameseEncoder encoder, TestReceiver& receiver, unsigned packetCount)
+{
+    // Allow a few more recovery packets than there are packets
+    for (unsigned i = 0; receiver.NextExpectedPacket < packetCount; ++i)
+    {
+        if (i >= packetCount + 10)
+        {
+            Logger.Error("Failed to recover packet ", receiver.NextExpectedPacket);
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+
+        SiameseRecoveryPacket recovery;
+        const int result = siamese_encode(encoder, &recovery);
+        if (result)
+        {
+            Logger.Error("Unable to generate encoded data: ", result);
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+        if (!receiver.OnRecovery(recovery))
+            return false;
+    }
+    return true;
+}
+
+static bool GF256KernelTest()
+{
+    Logger.Info("GF256 kernel test...");
+
+    siamese::PCGRandom prng;
+    prng.Seed(kSeed, 10);
+
+    // Cover every tail length of the widest kernels, with misaligned buffers
+    static const unsigned kMaxBytes = 300;
+    static const unsigned kOffsetCount = 4;
+    static const unsigned kOffsets[kOffsetCount] = { 0, 1, 7, 33 };
+    static const unsigned kBufferBytes = 64 + kMaxBytes + 64;
+    static const unsigned kBufferCount = 3;
+
+    // Results are compared over the whole buffers, so writing outside the data is caught
+    std::vector<uint8_t> sources[kBufferCount], dests[kBufferCount], expected[kBufferCount];
+    for (unsigned k = 0; k < kBufferCount; ++k)
+    {
+        sources[k].resize(kBufferBytes);
+        dests[k].resize(kBufferBytes);
+    }
+
+    const int defaultIsa = gf256_get_isa();
+    bool success = true;
+
+    for (int isa = 0; success && isa < GF256_ISA_COUNT; ++isa)
+    {
+        if (!gf256_isa_supported(isa))
+            continue;
+        if (gf256_set_isa(isa) != 0)
+        {
+            Logger.Error("Unable to select supported GF256 ISA ", isa);
+            SIAMESE_DEBUG_BREAK();
+            success = false;
+            break;
+        }
+
+        for (unsigned bytes = 0; success && bytes <= kMaxBytes; ++bytes)
+        {
+            for (unsigned o = 0; success && o < kOffsetCount; ++o)
+            {
+                const unsigned zOffset = kOffsets[o];
+                const unsigned xOffset = kOffsets[(o + 1) % kOffsetCount];
+
+                const uint8_t* x[kBufferCount];
+                uint8_t* z[kBufferCount];
+                uint8_t* e[kBufferCount];
+                for (unsigned k = 0; k < kBufferCount; ++k)
+                {
+                    for (unsigned i = 0; i < kBufferBytes; ++i)
+                    {
+                        sources[k][i] = (uint8_t)prng.Next();
+                        dests[k][i] = (uint8_t)prng.Next();
+                    }
+                    expected[k] = dests[k];
+                    x[k] = sources[k].data() + xOffset;
+                    z[k] = dests[k].data() + zOffset;
+                    e[k] = expected[k].data() + zOffset;
+                }
+
+                // Note: Coefficients 0 and 1 take special paths, and are picked now and then
+                const uint8_t y[kBufferCount] = {
+                    (uint8_t)prng.Next(), (uint8_t)prng.Next(), (uint8_t)prng.Next()
+                };
+
+                const auto verify = [&](const char* name) -> bool
+                {
+                    for (unsigned k = 0; k < kBufferCount; ++k)
+                    {
+                        if (dests[k] != expected[k])
+                        {
+                            Logger.Error("GF256 ", name, " failed: isa=", isa, " bytes=", bytes, " offset=", zOffset);
+                            SIAMESE_DEBUG_BREAK();
+                            return false;
+                        }
+                    }
+                    return true;
+                };
+
+                for (unsigned i = 0; i < bytes; ++i)
+                    e[0][i] ^= x[0][i];
+                gf256_add_mem(z[0], x[0], bytes);
+                success = verify("add_mem");
+
+                for (unsigned i = 0; success && i < bytes; ++i)
+                    e[0][i] ^= x[0][i] ^ x[1][i];
+                if (success)
+                {
+                    gf256_add2_mem(z[0], x[0], x[1], bytes);
+                    success = verify("add2_mem");
+                }
+
+                for (unsigned i = 0; success && i < bytes; ++i)
+                    e[0][i] = x[0][i] ^ x[1][i];
+                if (success)
+                {
+                    gf256_addset_mem(z[0], x[0], x[1], bytes);
+                    success = verify("addset_mem");
+                }
+
+                for (unsigned i = 0; success && i < bytes; ++i)
+                    e[0][i] = gf256_mul(x[0][i], y[0]);
+                if (success)
+                {
+                    gf256_mul_mem(z[0], x[0], y[0], bytes);
+                    success = verify("mul_mem");
+                }
+
+                for (unsigned i = 0; success && i < bytes; ++i)
+                    e[0][i] ^= gf256_mul(x[0][i], y[0]);
+                if (success)
+                {
+                    gf256_muladd_mem(z[0], y[0], x[0], bytes);
+                    success = verify("muladd_mem");
+                }
+
+                for (unsigned i = 0; success && i < bytes; ++i)
+                    e[0][i] ^= x[0][i];
+                if (success)
+                {
+                    gf256_add_mem_stream(z[0], x[0], bytes);
+                    success = verify("add_mem_stream");
+                }
+
+                for (unsigned i = 0; success && i < bytes; ++i)
+                    e[0][i] ^= gf256_mul(x[0][i], y[0]);
+                if (success)
+                {
+                    gf256_muladd_mem_stream(z[0], y[0], x[0], bytes);
+                    success = verify("muladd_mem_stream");
+                }
+
+                for (unsigned i = 0; success && i < bytes; ++i)
+                {
+                    e[0][i] ^= x[0][i];
+                    e[1][i] ^= gf256_mul(x[0][i], y[1]);
+                    e[2][i] ^= gf256_mul(x[0][i], y[2]);
+                }
+                if (success)
+                {
+                    gf256_add_muladd2_mem(z[0], z[1], y[1], z[2], y[2], x[0], bytes);
+                    success = verify("add_muladd2_mem");
+                }
+
+                // Sources of different lengths, with the longest one at a random position
+                unsigned lens[kBufferCount];
+                const void* srcs[kBufferCount];
+                for (unsigned k = 0; k < kBufferCount; ++k)
+                {
+                    lens[k] = prng.Next() % (bytes + 1);
+                    srcs[k] = x[k];
+                }
+                lens[prng.Next() % kBufferCount] = bytes;
+                for (unsigned k = 0; success && k < kBufferCount; ++k)
+                    for (unsigned i = 0; i < lens[k]; ++i)
+                        e[0][i] ^= gf256_mul(x[k][i], y[k]);
+                if (success)
+                {
+                    gf256_muladd_multi(z[0], y, srcs, lens, kBufferCount);
+                    success = verify("muladd_multi");
+                }
+
+                // Swap between differently aligned destinations
+                uint8_t* swapped = dests[1].data() + xOffset;
+                for (unsigned i = 0; success && i < bytes; ++i)
+                    std::swap(e[0][i], expected[1][xOffset + i]);
+                if (success)
+                {
+                    gf256_memswap(z[0], swapped, bytes);
+                    success = verify("memswap");
+                }
+            }
+        }
+    }
+
+    gf256_set_isa(defaultIsa);
+    return success;
+}
+
+static bool ParallelismTest()
+{
+    Logger.Info("Parallelism test...");
+
+    // Note: minBytes = 0 is raised to the smallest size the workers split
+    if (siamese_set_parallelism(4, 0))
+    {
+        Logger.Error("Unable to start worker threads");
+        SIAMESE_DEBUG_BREAK();
+        return false;
+    }
+
+    siamese::PCGRandom prng;
+    prng.Seed(kSeed, 8);
+
+    // Packets long enough to be split across the workers
+    static const unsigned kMinBytes = 128 * 1024;
+    std::vector<uint8_t> buffer(2 * kMinBytes);
+
+    // Cover both Cauchy and sum-based recovery packets
+    static const unsigned kPacketCounts[2] = { 20, 100 };
+
+    bool success = true;
+
+    for (unsigned trial = 0; success && trial < 2; ++trial)
+    {
+        const unsigned packetCount = kPacketCounts[trial];
+
+        SiameseEncoder encoder = siamese_encoder_create();
+        TestReceiver receiver;
+        success = (encoder != nullptr) && receiver.Initialize();
+
+        for (unsigned i = 0; success && i < packetCount; ++i)
+        {
+            const unsigned bytes = kMinBytes + prng.Next() % kMinBytes;
+            WriteRandomSelfCheckingPacket(prng, buffer.data(), bytes);
+
+            SiameseOriginalPacket original;
+            original.Data      = buffer.data();
+            original.DataBytes = bytes;
+            success = (siamese_encoder_add(encoder, &original) == Siamese_Success);
+
+            // Lose about 10% of the packets
+            if (success && prng.Next() % 10 != 0)
+                success = receiver.OnOriginal(original);
+        }
+
+        success = success && RecoverAll(encoder, receiver, packetCount);
+
+        siamese_encoder_free(encoder);
+    }
+
+    if (!success)
+    {
+        Logger.Error("Parallel encode/decode failed");
+        SIAMESE_DEBUG_BREAK();
+    }
+
+    siamese_set_parallelism(1, 0);
+    return success;
+}
+
+static bool EncodeBatchTest()
+{
+    Logger.Info("Encode batch test...");
+
+    siamese::PCGRandom prng;
+    prng.Seed(kSeed, 12);
+
+    // Cover single packet, Cauchy and sum-based recovery packets
+    static const unsigned kPacketCounts[3] = { 1, 30, 200 };
+    static const unsigned kBatchCounts[3] = { 1, 3, SIAMESE_MAX_ENCODE_BATCH };
+
+    bool success = true;
+
+    for (unsigned trial = 0; success && trial < 3; ++trial)
+    {
+        // Both encoders get the same data, and one generates recovery packets in batches
+        SiameseEncoder single = siamese_encoder_create();
+        SiameseEncoder batched = siamese_encoder_create();
+        success = (single != nullptr) && (batched != nullptr);
+
+        unsigned nextPacketNum = 0;
+
+        for (unsigned round = 0; success && round < 4; ++round)
+        {
+            // Add more data to the window and remove some from the front
+            const unsigned addCount = (round == 0) ? kPacketCounts[trial] : kPacketCounts[trial] / 4;
+            for (unsigned i = 0; success && i < addCount; ++i)
+            {
+                uint8_t buffer[kApiTestMaxPacketBytes];
+                const unsigned bytes = GetApiTestPacketBytes(prng);
+                WriteRandomSelfCheckingPacket(prng, buffer, bytes);
+
+                SiameseOriginalPacket original;
+                original.Data      = buffer;
+                original.DataBytes = bytes;
+                success = (siamese_encoder_add(single, &original) == Siamese_Success) &&
+                    (siamese_encoder_add(batched, &original) == Siamese_Success);
+                ++nextPacketNum;
+            }
+            if (success && round > 0)
+            {
+                const unsigned firstKept = nextPacketNum - kPacketCounts[trial];
+                success = (siamese_encoder_remove_before(single, firstKept) == Siamese_Success) &&
+                    (siamese_encoder_remove_before(batched, firstKept) == Siamese_Success);
+            }
+
+            for (unsigned k = 0; success && k < 3; ++k)
+            {
+                const unsigned count = kBatchCounts[k];
+
+                std::vector<std::vector<uint8_t>> expected(count);
+                for (unsigned i = 0; success && i < count; ++i)
+                {
+                    SiameseRecoveryPacket recovery;
+                    success = (siamese_encode(single, &recovery) == Siamese_Success);
+                    if (success)
+                        expected[i].assign(recovery.Data, recovery.Data + recovery.DataBytes);
+                }
+
+                SiameseRecoveryPacket recovery[SIAMESE_MAX_ENCODE_BATCH];
+                success = success && (siamese_encode_batch(batched, recovery, count) == Siamese_Success);
+
+                for (unsigned i = 0; success && i < count; ++i)
+                {
+                    if (recovery[i].DataBytes != expected[i].size() ||
+                        0 != memcmp(recovery[i].Data, expected[i].data(), recovery[i].DataBytes))
+                    {
+                        Logger.Error("Batch packet ", i, " of ", count, " differs for ", kPacketCounts[trial], " packets");
+                        success = false;
+                    }
+                }
+            }
+        }
+
+        siamese_encoder_free(single);
+        siamese_encoder_free(batched);
+    }
+
+    if (!success)
+    {
+        Logger.Error("Encode batch test failed");
+        SIAMESE_DEBUG_BREAK();
+    }
+    return success;
+}
 
+// Returns true if bytes [begin, end) of buffer are all equal to value
+static bool IsFilled(const std::vector<uint8_t>& buffer, unsigned begin, unsigned end, uint8_t value)
+{
+    for (unsigned i = begin; i < end; ++i)
+        if (buffer[i] != value)
+            return false;
+    return true;
+}
+
+static bool EncodeIntoTest()
+{
+    Logger.Info("Encode into test...");
+
+    siamese::PCGRandom prng;
+    prng.Seed(kSeed, 13);
+
+    static const uint8_t kFill = 0xcc;
+    static const unsigned kHeadrooms[3] = { 0, 5, 64 };
+
+    // Cover single packet, Cauchy and sum-based recovery packets
+    static const unsigned kPacketCounts[3] = { 1, 30, 200 };
+
+    bool success = true;
+
+    for (unsigned trial = 0; success && trial < 3; ++trial)
+    {
+        // Both encoders get the same data, and one generates recovery packets into buffers
+        SiameseEncoder reference = siamese_encoder_create();
+        SiameseEncoder encoder = siamese_encoder_create();
+        success = (reference != nullptr) && (encoder != nullptr);
+
+        unsigned longestBytes = 0;
+
+        for (unsigned i = 0; success && i < kPacketCounts[trial]; ++i)
+        {
+            uint8_t buffer[kApiTestMaxPacketBytes];
+            const unsigned bytes = GetApiTestPacketBytes(prng);
+            WriteRandomSelfCheckingPacket(prng, buffer, bytes);
+            if (longestBytes < bytes)
+                longestBytes = bytes;
+
+            SiameseOriginalPacket original;
+            original.Data      = buffer;
+            original.DataBytes = bytes;
+            success = (siamese_encoder_add(reference, &original) == Siamese_Success) &&
+                (siamese_encoder_add(encoder, &original) == Siamese_Success);
+        }
+
+        for (unsigned k = 0; success && k < 3; ++k)
+        {
+            const unsigned headroom = kHeadrooms[k];
+            const unsigned capacity = headroom + longestBytes + SIAMESE_ENCODE_INTO_OVERHEAD;
+            std::vector<uint8_t> buffer(capacity + 16, kFill);
+            unsigned bytesOut = 0;
+
+            // Buffers that are too small are rejected without using up a packet
+            if (siamese_encode_into(encoder, buffer.data(), headroom + longestBytes, headroom, &bytesOut) != Siamese_InvalidInput ||
+                (headroom > 0 && siamese_encode_into(encoder, buffer.data(), headroom - 1, headroom, &bytesOut) != Siamese_InvalidInput) ||
+                bytesOut != 0 ||
+                !IsFilled(buffer, 0, (unsigned)buffer.size(), kFill))
+            {
+                Logger.Error("Encode into accepted a buffer that was too small");
+                success = false;
+                break;
+            }
+
+            SiameseRecoveryPacket recovery;
+            success = (siamese_encode(reference, &recovery) == Siamese_Success) &&
+                (siamese_encode_into(encoder, buffer.data(), capacity, headroom, &bytesOut) == Siamese_Success);
+
+            if (success &&
+                (bytesOut != recovery.DataBytes ||
+                 0 != memcmp(buffer.data() + headroom, recovery.Data, bytesOut) ||
+                 !IsFilled(buffer, 0, headroom, kFill) ||
+                 !IsFilled(buffer, headroom + bytesOut, (unsigned)buffer.size(), kFill)))
+            {
+                Logger.Error("Encode into wrote the wrong bytes with headroom ", headroom, " for ", kPacketCounts[trial], " packets");
+                success = false;
+            }
+        }
+
+        siamese_encoder_free(reference);
+        siamese_encoder_free(encoder);
+    }
+
+    // Retransmit lost packets into buffers
+    SiameseEncoder encoder = siamese_encoder_create();
+    TestReceiver receiver;
+    success = success && (encoder != nullptr) && receiver.Initialize();
+
+    static const unsigned kPacketCount = 100;
+    std::vector<std::vector<uint8_t>> sent;
+    unsigned lostCount = 0;
+
+    for (unsigned i = 0; success && i < kPacketCount; ++i)
+    {
+        uint8_t buffer[kApiTestMaxPacketBytes];
+        const unsigned bytes = GetApiTestPacketBytes(prng);
+        WriteRandomSelfCheckingPacket(prng, buffer, bytes);
+        sent.emplace_back(buffer, buffer + bytes);
+
+        SiameseOriginalPacket original;
+        original.Data      = buffer;
+        original.DataBytes = bytes;
+        success = (siamese_encoder_add(encoder, &original) == Siamese_Success);
+
+        if (success && i % 7 == 3)
+            ++lostCount;
+        else if (success)
+            success = receiver.OnOriginal(original);
+    }
+
+    success = success && receiver.SendAck(encoder);
+
+    for (unsigned k = 0; success; ++k)
+    {
+        const unsigned headroom = kHeadrooms[k % 3];
+        const unsigned capacity = headroom + kApiTestMaxPacketBytes;
+        std::vector<uint8_t> buffer(capacity + 16, kFill);
+        unsigned packetNum = 0, bytesOut = 0;
+
+        // A buffer that is too small is rejected, and the packet is returned by the next call
+        int result = siamese_encoder_retransmit_into(encoder, 1000, buffer.data(), headroom + 1, headroom, &packetNum, &bytesOut);
+        if (result == Siamese_NeedMoreData)
+            break;
+        if (result != Siamese_InvalidInput || bytesOut != 0 ||
+            !IsFilled(buffer, 0, (unsigned)buffer.size(), kFill))
+        {
+            Logger.Error("Retransmit into accepted a buffer that was too small");
+            success = false;
+            break;
+        }
+
+        result = siamese_encoder_retransmit_into(encoder, 1000, buffer.data(), capacity, headroom, &packetNum, &bytesOut);
+        if (result != Siamese_Success ||
+            packetNum >= kPacketCount ||
+            bytesOut != sent[packetNum].size() ||
+            0 != memcmp(buffer.data() + headroom, sent[packetNum].data(), bytesOut) ||
+            !IsFilled(buffer, 0, headroom, kFill) ||
+            !IsFilled(buffer, headroom + bytesOut, (unsigned)buffer.size(), kFill))
+        {
+            Logger.Error("Retransmit into wrote the wrong bytes with headroom ", headroom);
+            success = false;
+            break;
+        }
+
+        SiameseOriginalPacket original;
+        original.PacketNum = packetNum;
+        original.Data      = buffer.data() + headroom;
+        original.DataBytes = bytesOut;
+        success = receiver.OnOriginal(original);
+    }
+
+    if (success && receiver.NextExpectedPacket != kPacketCount)
+    {
+        Logger.Error("Retransmit into did not resend all ", lostCount, " lost packets");
+        success = false;
+    }
+
+    siamese_encoder_free(encoder);
+
+    if (!success)
+    {
+        Logger.Error("Encode into test failed");
+        SIAMESE_DEBUG_BREAK();
+    }
+    return success;
+}
+
+// Counts release callbacks for packets added with siamese_encoder_add_owned()
+struct OwnedPacketTracker
+{
+    // Buffers including headroom, by packet data pointer
+    std::map<const unsigned char*, std::vector<uint8_t>> Buffers;
+
+    // Number of release callbacks for each packet data pointer
+    std::map<const unsigned char*, unsigned> ReleaseCounts;
+
+    unsigned ReleasedCount = 0;
+
+    static void OnRelease(void* context, const unsigned char* data)
+    {
+        OwnedPacketTracker* tracker = (OwnedPacketTracker*)context;
+        tracker->ReleaseCounts[data]++;
+        tracker->ReleasedCount++;
+    }
+
+    // Add a packet of the given length that the encoder owns until it is released
+    int Add(SiameseEncoder encoder, siamese::PCGRandom& prng, unsigned bytes, SiameseOriginalPacket& original)
+    {
+        std::vector<uint8_t> buffer(SIAMESE_OWNED_HEADROOM + bytes);
+        uint8_t* data = buffer.data() + SIAMESE_OWNED_HEADROOM;
+        if (bytes > 0)
+            WriteRandomSelfCheckingPacket(prng, data, bytes);
+
+        original.Data      = data;
+        original.DataBytes = bytes;
+        const int result = siamese_encoder_add_owned(encoder, &original, &OwnedPacketTracker::OnRelease, this);
+        if (result == Siamese_Success)
+            Buffers[data] = std::move(buffer);
+        return result;
+    }
+
+    // Returns true if every packet added was released exactly once
+    bool AllReleasedOnce() const
+    {
+        if (ReleasedCount != Buffers.size() || ReleaseCounts.size() != Buffers.size())
+            return false;
+        for (const auto& released : ReleaseCounts)
+            if (released.second != 1 || Buffers.find(released.first) == Buffers.end())
+                return false;
+        return true;
+    }
+};
+
+static bool AddOwnedTest()
+{
+    Logger.Info("Add owned test...");
+
+    siamese::PCGRandom prng;
+    prng.Seed(kSeed, 14);
+
+    static const unsigned kPacketCount = 1000;
+
+    bool success = true;
+
+    // Stream with loss, acknowledgements and recovery
+    {
+        OwnedPacketTracker tracker;
+        SiameseEncoder encoder = siamese_encoder_create();
+        TestReceiver receiver;
+        success = (encoder != nullptr) && receiver.Initialize();
+
+        for (unsigned i = 0; success && i < kPacketCount; ++i)
+        {
+            SiameseOriginalPacket original;
+            success = (tracker.Add(encoder, prng, GetApiTestPacketBytes(prng), original) == Siamese_Success);
+
+            if (success && prng.Next() % 10 != 0)
+                success = receiver.OnOriginal(original);
+
+            if (success && i % 8 == 7)
+            {
+                SiameseRecoveryPacket recovery;
+                success = (siamese_encode(encoder, &recovery) == Siamese_Success) &&
+                    receiver.OnRecovery(recovery);
+            }
+
+            if (success && i % 32 == 31)
+                success = receiver.SendAck(encoder);
+        }
+
+        success = success && RecoverAll(encoder, receiver, kPacketCount);
+
+        // Acknowledged packets are released by later encoder calls
+        if (success && tracker.ReleasedCount <= 0)
+        {
+            Logger.Error("No packets were released after they were acknowledged");
+            success = false;
+        }
+
+        siamese_encoder_free(encoder);
+
+        if (success && !tracker.AllReleasedOnce())
+        {
+            Logger.Error("Packets were not released exactly once by acknowledgement and free");
+            success = false;
+        }
+    }
+
+    // Remove everything, then fill the encoder until adding fails
+    if (success)
+    {
+        OwnedPacketTracker tracker;
+        SiameseEncoder encoder = siamese_encoder_create();
+        success = (encoder != nullptr);
+
+        for (unsigned i = 0; success && i < 100; ++i)
+        {
+            SiameseOriginalPacket original;
+            success = (tracker.Add(encoder, prng, GetApiTestPacketBytes(prng), original) == Siamese_Success);
+        }
+
+        SiameseRecoveryPacket recovery;
+        success = success && (siamese_encoder_remove_before(encoder, 100) == Siamese_Success);
+        success = success && (siamese_encode(encoder, &recovery) == Siamese_NeedMoreData);
+
+        if (success && (tracker.ReleasedCount != 100 || !tracker.AllReleasedOnce()))
+        {
+            Logger.Error("Packets were not released after siamese_encoder_remove_before");
+            success = false;
+        }
+
+        // Failed adds are never released
+        SiameseOriginalPacket original;
+        if (success && tracker.Add(encoder, prng, 0, original) != Siamese_InvalidInput)
+        {
+            Logger.Error("Empty owned packet was accepted");
+            success = false;
+        }
+
+        int result = Siamese_Success;
+        for (unsigned i = 0; success && result == Siamese_Success && i <= SIAMESE_MAX_PACKETS; ++i)
+            result = tracker.Add(encoder, prng, 16, original);
+
+        if (success && result != Siamese_MaxPacketsReached)
+        {
+            Logger.Error("Owned packet was accepted beyond SIAMESE_MAX_PACKETS");
+            success = false;
+        }
+
+        siamese_encoder_free(encoder);
+
+        if (success && (tracker.ReleasedCount != tracker.Buffers.size() || !tracker.AllReleasedOnce()))
+        {
+            Logger.Error("Packets were not released exactly once by free");
+            success = false;
+        }
+    }
+
+    if (!success)
+    {
+        Logger.Error("Add owned test failed");
+        SIAMESE_DEBUG_BREAK();
+    }
+    return success;
+}
+
+static const unsigned kMaxTestFragments = 6;
+
+// Split data into fragments for the scatter-gather functions, some of them empty
+static unsigned SplitIntoFragments(siamese::PCGRandom& prng, const uint8_t* data, unsigned bytes, SiameseIOVec* vecs)
+{
+    const unsigned count = 1 + prng.Next() % kMaxTestFragments;
+    unsigned offset = 0;
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        unsigned fragmentBytes = 0;
+        if (i + 1 == count)
+            fragmentBytes = bytes - offset;
+        else if (prng.Next() % 3 != 0)
+            fragmentBytes = prng.Next() % (bytes - offset + 1);
+
+        // Empty fragments may or may not have a data pointer
+        vecs[i].Data      = (fragmentBytes > 0 || i % 2 == 0) ? data + offset : nullptr;
+        vecs[i].DataBytes = fragmentBytes;
+        offset += fragmentBytes;
+    }
+
+    return count;
+}
+
+static bool ScatterGatherTest()
+{
+    Logger.Info("Scatter-gather test...");
+
+    siamese::PCGRandom prng;
+    prng.Seed(kSeed, 15);
+
+    static const unsigned kPacketCount = 500;
+
+    SiameseEncoder encoder = siamese_encoder_create();
+    TestReceiver receiver;
+    bool success = (encoder != nullptr) && receiver.Initialize();
+
+    // Packets made only of empty fragments are rejected
+    if (success)
+    {
+        SiameseIOVec empty[2] = {};
+        SiameseOriginalPacket original;
+        if (siamese_encoder_addv(encoder, empty, 2, &original) != Siamese_InvalidInput ||
+            siamese_decoder_add_originalv(receiver.Decoder, empty, 2, 0) != Siamese_InvalidInput)
+        {
+            Logger.Error("Empty packet was accepted");
+            success = false;
+        }
+    }
+
+    for (unsigned i = 0; success && i < kPacketCount; ++i)
+    {
+        uint8_t buffer[kApiTestMaxPacketBytes];
+        const unsigned bytes = GetApiTestPacketBytes(prng);
+        WriteRandomSelfCheckingPacket(prng, buffer, bytes);
+
+        SiameseIOVec vecs[kMaxTestFragments];
+        unsigned count = SplitIntoFragments(prng, buffer, bytes, vecs);
+
+        SiameseOriginalPacket original;
+        if (siamese_encoder_addv(encoder, vecs, count, &original) != Siamese_Success ||
+            original.PacketNum != i ||
+            original.DataBytes != bytes)
+        {
+            Logger.Error("Unable to add original fragments to encoder");
+            success = false;
+            break;
+        }
+
+        // Check the packet the encoder put together
+        SiameseOriginalPacket stored;
+        stored.PacketNum = i;
+        if (siamese_encoder_get(encoder, &stored) != Siamese_Success ||
+            stored.DataBytes != bytes ||
+            0 != memcmp(stored.Data, buffer, bytes))
+        {
+            Logger.Error("Encoder put together the wrong data for packet ", i);
+            success = false;
+            break;
+        }
+
+        // Lose about 10% of the packets, and split the rest differently for the decoder
+        if (prng.Next() % 10 != 0)
+        {
+            count = SplitIntoFragments(prng, buffer, bytes, vecs);
+            success = receiver.OnOriginalV(vecs, count, i);
+        }
+
+        if (success && i % 8 == 7)
+        {
+            SiameseRecoveryPacket recovery;
+            success = (siamese_encode(encoder, &recovery) == Siamese_Success) &&
+                receiver.OnRecovery(recovery);
+        }
+    }
+
+    success = success && RecoverAll(encoder, receiver, kPacketCount);
+
+    siamese_encoder_free(encoder);
+
+    if (!success)
+    {
+        Logger.Error("Scatter-gather test failed");
+        SIAMESE_DEBUG_BREAK();
+    }
+    return success;
+}
+
+static bool EagerSumsTest()
+{
+    Logger.Info("Eager sums test...");
+
+    siamese::PCGRandom prng;
+    prng.Seed(kSeed, 16);
+
+    // Both encoders get the same data, and one folds packets into its sums as they are added
+    SiameseEncoder lazy = siamese_encoder_create();
+    SiameseEncoder eager = siamese_encoder_create();
+    bool success = (lazy != nullptr) && (eager != nullptr) &&
+        (siamese_encoder_set_eager_sums(eager, 1) == Siamese_Success);
+
+    unsigned nextPacketNum = 0;
+
+    for (unsigned round = 0; success && round < 40; ++round)
+    {
+        // Switch modes while the window still holds data
+        if (round == 15 || round == 25)
+            success = (siamese_encoder_set_eager_sums(eager, round == 25) == Siamese_Success);
+
+        // Add a burst of data so the window grows well past the Cauchy range
+        const unsigned addCount = 1 + prng.Next() % 40;
+        for (unsigned i = 0; success && i < addCount; ++i)
+        {
+            uint8_t buffer[kApiTestMaxPacketBytes];
+            const unsigned bytes = GetApiTestPacketBytes(prng);
+            WriteRandomSelfCheckingPacket(prng, buffer, bytes);
+
+            SiameseOriginalPacket original;
+            original.Data      = buffer;
+            original.DataBytes = bytes;
+            success = (siamese_encoder_add(lazy, &original) == Siamese_Success) &&
+                (siamese_encoder_add(eager, &original) == Siamese_Success);
+            ++nextPacketNum;
+        }
+
+        // Sometimes remove data from the front of the window
+        if (success && round % 4 == 3)
+        {
+            const unsigned firstKept = nextPacketNum - prng.Next() % nextPacketNum / 2;
+            success = (siamese_encoder_remove_before(lazy, firstKept) == Siamese_Success) &&
+                (siamese_encoder_remove_before(eager, firstKept) == Siamese_Success);
+        }
+
+        const unsigned encodeCount = 1 + prng.Next() % 3;
+        for (unsigned i = 0; success && i < encodeCount; ++i)
+        {
+            SiameseRecoveryPacket expected, recovery;
+            success = (siamese_encode(lazy, &expected) == Siamese_Success);
+            std::vector<uint8_t> copy;
+            if (success)
+                copy.assign(expected.Data, expected.Data + expected.DataBytes);
+            success = success && (siamese_encode(eager, &recovery) == Siamese_Success);
+
+            if (success && (recovery.DataBytes != copy.size() ||
+                0 != memcmp(recovery.Data, copy.data(), copy.size())))
+            {
+                Logger.Error("Eager recovery packet differs in round ", round);
+                success = false;
+            }
+        }
+    }
+
+    siamese_encoder_free(lazy);
+    siamese_encoder_free(eager);
+
+    if (!success)
+    {
+        Logger.Error("Eager sums test failed");
+        SIAMESE_DEBUG_BREAK();
+    }
+    return success;
+}
+
+static bool ShrinkRecoveryTest()
+{
+    Logger.Info("Shrink recovery test...");
+
+    siamese::PCGRandom prng;
+    prng.Seed(kSeed, 25);
+
+    // The long packet is sent while sums are running, in the middle of a subwindow.
+    // After it is acknowledged the window is small enough to stop the sums, and then
+    // grows until they restart from the subwindow checkpoint past the long packet
+    static const unsigned kLongPacketNum = 70;
+    static const unsigned kFirstLostPacketNum = 80;
+    static const unsigned kAckPacketCount = 100;
+    static const unsigned kPacketCount = 200;
+    static const unsigned kMaxShortBytes = 200;
+    static const unsigned kMaxShortRecoveryBytes = kMaxShortBytes + SIAMESE_MAX_ENCODE_OVERHEAD;
+
+    SiameseEncoder encoder = siamese_encoder_create();
+    TestReceiver receiver;
+    bool success = (encoder != nullptr) && receiver.Initialize();
+
+    // Note: The last packet always arrives so that every loss is NACKed
+    for (unsigned i = 0; success && i < kPacketCount; ++i)
+    {
+        uint8_t buffer[kApiTestMaxPacketBytes];
+        const unsigned bytes = (i == kLongPacketNum) ? kApiTestMaxPacketBytes : 2 + prng.Next() % (kMaxShortBytes - 1);
+        WriteRandomSelfCheckingPacket(prng, buffer, bytes);
+
+        SiameseOriginalPacket original;
+        original.Data      = buffer;
+        original.DataBytes = bytes;
+        success = (siamese_encoder_add(encoder, &original) == Siamese_Success);
+
+        const bool lost = (i == kFirstLostPacketNum) ||
+            (i > kFirstLostPacketNum && i + 1 < kPacketCount && prng.Next() % 10 == 0);
+        if (success && !lost)
+            success = receiver.OnOriginal(original);
+
+        // Acknowledge everything before the first loss
+        if (success && i + 1 == kAckPacketCount)
+            success = receiver.SendAck(encoder);
+
+        if (success && i > kLongPacketNum && i % 8 == 0)
+        {
+            SiameseRecoveryPacket recovery;
+            success = (siamese_encode(encoder, &recovery) == Siamese_Success);
+
+            // Recovery packets cover the long packet until it is acknowledged, and then shrink
+            const bool longInFlight = (i < kAckPacketCount);
+            if (success && longInFlight && recovery.DataBytes < kApiTestMaxPacketBytes)
+            {
+                Logger.Error("Recovery packet is shorter than the long packet in flight");
+                success = false;
+            }
+            if (success && !longInFlight && recovery.DataBytes > kMaxShortRecoveryBytes)
+            {
+                Logger.Error("Recovery packet is ", recovery.DataBytes, " bytes after the long packet was acknowledged");
+                success = false;
+            }
+
+            // Note: Losses are only recovered after the acknowledgement, so it keeps part of the window
+            success = success && (longInFlight || receiver.OnRecovery(recovery));
+        }
+    }
+
+    // And the shorter recovery packets still recover the short packets
+    success = success && RecoverAll(encoder, receiver, kPacketCount);
+
+    siamese_encoder_free(encoder);
+
+    if (!success)
+    {
+        Logger.Error("Shrink recovery test failed");
+        SIAMESE_DEBUG_BREAK();
+    }
+    return success;
+}
+
+static bool PreEncodeTest()
+{
+    Logger.Info("Pre-encode test...");
+
+    siamese::PCGRandom prng;
+    prng.Seed(kSeed, 17);
+
+    static const unsigned kPacketCount = 20000;
+    static const unsigned kLossRate = 10; // percent
+
+    SiameseEncoder encoder = siamese_encoder_create();
+    if (!encoder)
+    {
+        Logger.Error("Unable to create encoder");
+        SIAMESE_DEBUG_BREAK();
+        return false;
+    }
+
+    TestReceiver receiver;
+    bool success = receiver.Initialize();
+
+    if (success && 0 != siamese_encoder_set_pre_encode(encoder, 4))
+    {
+        Logger.Error("Unable to start pre-encoding");
+        SIAMESE_DEBUG_BREAK();
+        success = false;
+    }
+
+    uint64_t handedOutCount = 0, handedOutBytes = 0;
+
+    const auto sendRecovery = [&](bool lose) -> bool
+    {
+        SiameseRecoveryPacket recovery;
+        const int result = siamese_encode(encoder, &recovery);
+        if (result == Siamese_NeedMoreData)
+            return true;
+        if (result)
+        {
+            Logger.Error("Unable to generate encoded data: ", result);
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+        ++handedOutCount;
+        handedOutBytes += recovery.DataBytes;
+        return lose || receiver.OnRecovery(recovery);
+    };
+
+    for (unsigned i = 0; success && i < kPacketCount; ++i)
+    {
+        uint8_t buffer[kApiTestMaxPacketBytes];
+        const unsigned bytes = GetApiTestPacketBytes(prng);
+        WriteRandomSelfCheckingPacket(prng, buffer, bytes);
+
+        SiameseOriginalPacket original;
+        original.Data      = buffer;
+        original.DataBytes = bytes;
+        if (siamese_encoder_add(encoder, &original))
+        {
+            Logger.Error("Unable to add original data to encoder");
+            SIAMESE_DEBUG_BREAK();
+            success = false;
+            break;
+        }
+
+        if (prng.Next() % 100 >= kLossRate)
+            success = receiver.OnOriginal(original);
+
+        if (success && i % 8 == 0)
+            success = sendRecovery(prng.Next() % 100 < 5);
+
+        if (success && i % 16 == 0)
+            success = receiver.SendAck(encoder);
+        else if (success && i % 100 == 50 && siamese_encoder_remove_before(encoder, receiver.NextExpectedPacket))
+        {
+            Logger.Error("Unable to remove from encoder");
+            SIAMESE_DEBUG_BREAK();
+            success = false;
+        }
+
+        // Give the worker time to get ahead now and then
+        if (i % 500 == 0)
+            Sleep(1);
+    }
+
+    // Send recovery packets until everything has been delivered
+    for (unsigned i = 0; success && receiver.NextExpectedPacket < kPacketCount && i < 1000; ++i)
+    {
+        success = sendRecovery(false);
+        if (success && i % 8 == 0)
+            success = receiver.SendAck(encoder);
+    }
+
+    if (success && receiver.NextExpectedPacket < kPacketCount)
+    {
+        Logger.Error("Failed to deliver packet ", receiver.NextExpectedPacket);
+        SIAMESE_DEBUG_BREAK();
+        success = false;
+    }
+
+    if (success)
+    {
+        // Let the worker fill up with packets that are never handed out
+        Sleep(10);
+
+        uint64_t stats[SiameseEncoderStats_Count];
+        if (siamese_encoder_stats(encoder, stats, SiameseEncoderStats_Count) ||
+            stats[SiameseEncoderStats_RecoveryCount] != handedOutCount ||
+            stats[SiameseEncoderStats_RecoveryBytes] != handedOutBytes)
+        {
+            Logger.Error("Recovery statistics do not match the packets handed out");
+            SIAMESE_DEBUG_BREAK();
+            success = false;
+        }
+    }
+
+    siamese_encoder_free(encoder);
+    return success;
+}
+
+// Returns true if the encoder has data that some receiver still needs
+static bool EncoderHoldsData(SiameseEncoder encoder)
+{
+    SiameseRecoveryPacket recovery;
+    return siamese_encode(encoder, &recovery) != Siamese_NeedMoreData;
+}
+
+// Collect up to maxCount packet numbers returned by siamese_encoder_retransmit()
+static bool CollectRetransmits(SiameseEncoder encoder, unsigned retransmitMsec, std::vector<unsigned>& packetNums,
+    unsigned maxCount = SIAMESE_MAX_PACKETS)
+{
+    packetNums.clear();
+    while (packetNums.size() < maxCount)
+    {
+        SiameseOriginalPacket original;
+        const int result = siamese_encoder_retransmit(encoder, retransmitMsec, &original);
+        if (result == Siamese_NeedMoreData)
+            return true;
+        if (result)
+        {
+            Logger.Error("Retransmit failed: ", result);
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+        packetNums.push_back(original.PacketNum);
+    }
+    return true;
+}
+
+static bool RetransmitOrderTest()
+{
+    Logger.Info("Retransmit order test...");
+
+    siamese::PCGRandom prng;
+    prng.Seed(kSeed, 21);
+
+    static const unsigned kRetransmitMsec = 200;
+
+    SiameseEncoder encoder = siamese_encoder_create();
+    TestReceiver receiver;
+    bool success = (encoder != nullptr) && receiver.Initialize();
+
+    // Add packets, losing the given ones on the way to the receiver
+    const auto send = [&](unsigned count, const std::vector<unsigned>& lost) -> bool
+    {
+        for (unsigned i = 0; i < count; ++i)
+        {
+            uint8_t buffer[kApiTestMaxPacketBytes];
+            const unsigned bytes = GetApiTestPacketBytes(prng);
+            WriteRandomSelfCheckingPacket(prng, buffer, bytes);
+
+            SiameseOriginalPacket original;
+            original.Data      = buffer;
+            original.DataBytes = bytes;
+            if (siamese_encoder_add(encoder, &original) != Siamese_Success)
+                return false;
+            if (std::find(lost.begin(), lost.end(), original.PacketNum) == lost.end() &&
+                !receiver.OnOriginal(original))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const auto expect = [](const std::vector<unsigned>& resent, const std::vector<unsigned>& expected, const char* when) -> bool
+    {
+        if (resent != expected)
+        {
+            Logger.Error("Retransmits ", when, " were out of order or unexpected: ", resent.size(), " returned, ", expected.size(), " expected");
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+        return true;
+    };
+
+    std::vector<unsigned> resent;
+
+    // The first losses are resent in column order, and only some of them are resent for now
+    success = success &&
+        send(100, { 10, 20, 30, 40, 50 }) &&
+        receiver.SendAck(encoder) &&
+        CollectRetransmits(encoder, kRetransmitMsec, resent, 3) &&
+        expect(resent, { 10, 20, 30 }, "after the first NACK");
+
+    // Only the resend of 30 arrives, and new data has more losses.
+    // The resent columns that are NACKed again wait, and the others go first in column order
+    if (success)
+    {
+        SiameseOriginalPacket original;
+        original.PacketNum = 30;
+        success = (siamese_encoder_get(encoder, &original) == Siamese_Success) &&
+            receiver.OnOriginal(original);
+    }
+    success = success &&
+        send(20, { 105, 110 }) &&
+        receiver.SendAck(encoder) &&
+        CollectRetransmits(encoder, kRetransmitMsec, resent) &&
+        expect(resent, { 40, 50, 105, 110 }, "before the interval");
+
+    // After the interval the earlier resends come first
+    if (success)
+    {
+        Sleep(kRetransmitMsec + 50);
+        success = CollectRetransmits(encoder, kRetransmitMsec, resent) &&
+            expect(resent, { 10, 20, 40, 50, 105, 110 }, "after the interval");
+    }
+
+    // A new NACK keeps the send times of the columns it still lists
+    if (success)
+    {
+        SiameseOriginalPacket original;
+        original.PacketNum = 10;
+        success = (siamese_encoder_get(encoder, &original) == Siamese_Success) &&
+            receiver.OnOriginal(original) &&
+            send(10, { 125 }) &&
+            receiver.SendAck(encoder) &&
+            CollectRetransmits(encoder, kRetransmitMsec, resent) &&
+            expect(resent, { 125 }, "after a NACK of resent columns");
+    }
+
+    siamese_encoder_free(encoder);
+
+    if (!success)
+    {
+        Logger.Error("Retransmit order test failed");
+        SIAMESE_DEBUG_BREAK();
+    }
+    return success;
+}
+
+static bool RetransmitBatchTest()
+{
+    Logger.Info("Retransmit batch test...");
+
+    siamese::PCGRandom prng;
+    prng.Seed(kSeed, 22);
+
+    static const unsigned kPacketCount = 200;
+    static const unsigned kMaxCount = 7;
+    static const unsigned kRetransmitMsec = 1000;
+
+    SiameseEncoder encoder = siamese_encoder_create();
+    TestReceiver receiver;
+    bool success = (encoder != nullptr) && receiver.Initialize();
+
+    std::vector<unsigned> lost;
+
+    // Note: The last packet always arrives so that every loss is NACKed
+    for (unsigned i = 0; success && i < kPacketCount; ++i)
+    {
+        uint8_t buffer[kApiTestMaxPacketBytes];
+        const unsigned bytes = GetApiTestPacketBytes(prng);
+        WriteRandomSelfCheckingPacket(prng, buffer, bytes);
+
+        SiameseOriginalPacket original;
+        original.Data      = buffer;
+        original.DataBytes = bytes;
+        success = (siamese_encoder_add(encoder, &original) == Siamese_Success);
+
+        if (success)
+        {
+            if (i + 1 < kPacketCount && prng.Next() % 100 < 15)
+                lost.push_back(original.PacketNum);
+            else
+                success = receiver.OnOriginal(original);
+        }
+    }
+
+    success = success && receiver.SendAck(encoder) && lost.size() > 2 * kMaxCount;
+
+    SiameseOriginalPacket originals[kPacketCount];
+    unsigned count = 0;
+
+    if (success && siamese_encoder_retransmit_batch(encoder, kRetransmitMsec, originals, 0, &count) != Siamese_InvalidInput)
+    {
+        Logger.Error("Retransmit batch accepted maxCount = 0");
+        success = false;
+    }
+
+    // Collect the losses a few at a time: each batch is full until the last one,
+    // and nothing is resent again before the retransmit time has passed
+    std::vector<unsigned> resent;
+    while (success)
+    {
+        const int result = siamese_encoder_retransmit_batch(encoder, kRetransmitMsec, originals, kMaxCount, &count);
+        if (result == Siamese_NeedMoreData)
+            break;
+
+        const unsigned expectedCount = std::min(kMaxCount, (unsigned)(lost.size() - resent.size()));
+        if (result || count != expectedCount)
+        {
+            Logger.Error("Retransmit batch returned ", count, " packets but expected ", expectedCount);
+            success = false;
+            break;
+        }
+
+        for (unsigned i = 0; i < count; ++i)
+            resent.push_back(originals[i].PacketNum);
+    }
+
+    std::sort(resent.begin(), resent.end());
+    if (success && resent != lost)
+    {
+        Logger.Error("Retransmit batches resent ", resent.size(), " packets but ", lost.size(), " were lost");
+        success = false;
+    }
+
+    // With no minimum time every loss is eligible again, but one call returns each at most once
+    if (success)
+    {
+        success = (siamese_encoder_retransmit_batch(encoder, 0, originals, kPacketCount, &count) == Siamese_Success);
+
+        resent.clear();
+        for (unsigned i = 0; success && i < count; ++i)
+            resent.push_back(originals[i].PacketNum);
+        std::sort(resent.begin(), resent.end());
+
+        if (success && resent != lost)
+        {
+            Logger.Error("Retransmit batch returned ", count, " packets but ", lost.size(), " were lost");
+            success = false;
+        }
+
+        // Deliver the batch, after which nothing is left to resend
+        for (unsigned i = 0; success && i < count; ++i)
+            success = receiver.OnOriginal(originals[i]);
+        success = success && receiver.SendAck(encoder) &&
+            receiver.NextExpectedPacket == kPacketCount &&
+            siamese_encoder_retransmit_batch(encoder, 0, originals, kPacketCount, &count) == Siamese_NeedMoreData;
+    }
+
+    siamese_encoder_free(encoder);
+
+    if (!success)
+    {
+        Logger.Error("Retransmit batch test failed");
+        SIAMESE_DEBUG_BREAK();
+    }
+    return success;
+}
+
+// The default receiver cannot be used while added receivers exist
+static bool MixedReceiverTest(siamese::PCGRandom& prng)
+{
+    static const unsigned kPacketCount = 100;
+
+    SiameseEncoder encoder = siamese_encoder_create();
+    SiameseReceiver added = encoder ? siamese_encoder_add_receiver(encoder) : nullptr;
+    TestReceiver defaultDecoder, addedDecoder;
+    bool success = (added != nullptr) && defaultDecoder.Initialize() && addedDecoder.Initialize();
+
+    // Both receivers get the data, but the default receiver loses some of it.
+    // Note: The last packet always arrives so that every loss is NACKed
+    for (unsigned i = 0; success && i < kPacketCount; ++i)
+    {
+        uint8_t buffer[kApiTestMaxPacketBytes];
+        const unsigned bytes = GetApiTestPacketBytes(prng);
+        WriteRandomSelfCheckingPacket(prng, buffer, bytes);
+
+        SiameseOriginalPacket original;
+        original.Data      = buffer;
+        original.DataBytes = bytes;
+        success = (siamese_encoder_add(encoder, &original) == Siamese_Success) &&
+            addedDecoder.OnOriginal(original);
+
+        if (success && (i + 1 == kPacketCount || prng.Next() % 100 >= 10))
+            success = defaultDecoder.OnOriginal(original);
+    }
+
+    // The added receiver acknowledges everything, and the default receiver NACKs its losses
+    success = success && addedDecoder.SendAck(encoder, added);
+
+    uint8_t ack[2000];
+    unsigned ackBytes = 0;
+    success = success &&
+        (siamese_decoder_ack(defaultDecoder.Decoder, ack, (unsigned)sizeof(ack), 0, &ackBytes) == Siamese_Success);
+
+    if (success)
+    {
+        SiameseOriginalPacket original;
+        uint8_t buffer[kApiTestMaxPacketBytes];
+        unsigned packetNum = 0, bytes = 0, count = 0;
+
+        if (siamese_encoder_ack(encoder, ack, ackBytes) != Siamese_InvalidInput ||
+            siamese_encoder_retransmit(encoder, 0, &original) != Siamese_InvalidInput ||
+            siamese_encoder_retransmit_into(encoder, 0, buffer, (unsigned)sizeof(buffer), 0, &packetNum, &bytes) != Siamese_InvalidInput ||
+            siamese_encoder_retransmit_batch(encoder, 0, &original, 1, &count) != Siamese_InvalidInput)
+        {
+            Logger.Error("Default receiver was used alongside an added receiver");
+            SIAMESE_DEBUG_BREAK();
+            success = false;
+        }
+    }
+
+    // Once the added receiver is gone, the default receiver can be used again
+    if (success)
+    {
+        siamese_encoder_remove_receiver(encoder, added);
+
+        if (siamese_encoder_ack(encoder, ack, ackBytes) != Siamese_Success)
+        {
+            Logger.Error("Default receiver was unusable after the added receiver was removed");
+            SIAMESE_DEBUG_BREAK();
+            success = false;
+        }
+    }
+
+    // And after the default receiver has been used, no receivers can be added
+    if (success && siamese_encoder_add_receiver(encoder) != nullptr)
+    {
+        Logger.Error("Receiver was added after the default receiver was used");
+        SIAMESE_DEBUG_BREAK();
+        success = false;
+    }
+
+    siamese_encoder_free(encoder);
+    return success;
+}
+
+static bool MultipleReceiverTest()
+{
+    Logger.Info("Multiple receiver test...");
+
+    siamese::PCGRandom prng;
+    prng.Seed(kSeed, 23);
+
+    static const unsigned kPacketCount = 300;
+    static const unsigned kReceiverCount = 3;
+    static const unsigned kLossRate[kReceiverCount] = { 5, 10, 20 }; // percent
+    static const unsigned kRetransmitMsec = 1000;
+
+    SiameseEncoder encoder = siamese_encoder_create();
+    if (!encoder)
+    {
+        Logger.Error("Unable to create encoder");
+        SIAMESE_DEBUG_BREAK();
+        return false;
+    }
+
+    bool success = true;
+    SiameseReceiver receivers[kReceiverCount];
+    TestReceiver decoders[kReceiverCount];
+    std::vector<unsigned> lost[kReceiverCount];
+
+    for (unsigned r = 0; r < kReceiverCount; ++r)
+    {
+        receivers[r] = siamese_encoder_add_receiver(encoder);
+        if (!receivers[r] || !decoders[r].Initialize())
+        {
+            Logger.Error("Unable to add receiver");
+            SIAMESE_DEBUG_BREAK();
+            success = false;
+        }
+    }
+
+    // Send the data, losing different packets on the way to each receiver.
+    // Note: The last packet always arrives so that every loss is NACKed
+    for (unsigned i = 0; success && i < kPacketCount; ++i)
+    {
+        uint8_t buffer[kApiTestMaxPacketBytes];
+        const unsigned bytes = GetApiTestPacketBytes(prng);
+        WriteRandomSelfCheckingPacket(prng, buffer, bytes);
+
+        SiameseOriginalPacket original;
+        original.Data      = buffer;
+        original.DataBytes = bytes;
+        if (siamese_encoder_add(encoder, &original))
+        {
+            Logger.Error("Unable to add original data to encoder");
+            SIAMESE_DEBUG_BREAK();
+            success = false;
+            break;
+        }
+
+        for (unsigned r = 0; success && r < kReceiverCount; ++r)
+        {
+            if (i + 1 < kPacketCount && prng.Next() % 100 < kLossRate[r])
+                lost[r].push_back(original.PacketNum);
+            else
+                success = decoders[r].OnOriginal(original);
+        }
+    }
+
+    // Collect the retransmissions for a receiver, using a different API for each,
+    // and check that they are exactly the packets it lost
+    const auto retransmitLost = [&](unsigned r) -> bool
+    {
+        std::vector<unsigned> resent;
+
+        for (;;)
+        {
+            SiameseOriginalPacket original;
+            int result = Siamese_NeedMoreData;
+            unsigned count = 0;
+            uint8_t buffer[16 + kApiTestMaxPacketBytes];
+
+            if (r == 0)
+                result = siamese_encoder_receiver_retransmit(encoder, receivers[r], kRetransmitMsec, &original);
+            else if (r == 1)
+            {
+                result = siamese_encoder_receiver_retransmit_into(encoder, receivers[r], kRetransmitMsec,
+                    buffer, (unsigned)sizeof(buffer), 16, &original.PacketNum, &original.DataBytes);
+                original.Data = buffer + 16;
+            }
+            else
+            {
+                result = siamese_encoder_receiver_retransmit_batch(encoder, receivers[r], kRetransmitMsec,
+                    &original, 1, &count);
+            }
+
+            if (result == Siamese_NeedMoreData)
+                break;
+            if (result)
+            {
+                Logger.Error("Retransmit failed: ", result);
+                SIAMESE_DEBUG_BREAK();
+                return false;
+            }
+
+            resent.push_back(original.PacketNum);
+            if (!decoders[r].OnOriginal(original))
+                return false;
+        }
+
+        std::sort(resent.begin(), resent.end());
+        if (resent != lost[r])
+        {
+            Logger.Error("Receiver ", r, " was resent ", resent.size(), " packets but lost ", lost[r].size());
+            SIAMESE_DEBUG_BREAK();
+            return false;
+        }
+        return true;
+    };
+
+    // The first receivers catch up while the last one has not acknowledged anything
+    for (unsigned r = 0; success && r + 1 < kReceiverCount; ++r)
+    {
+        success = decoders[r].SendAck(encoder, receivers[r]) &&
+            retransmitLost(r) &&
+            decoders[r].SendAck(encoder, receivers[r]);
+    }
+
+    if (success && !EncoderHoldsData(encoder))
+    {
+        Logger.Error("Data was removed before the slowest receiver acknowledged it");
+        SIAMESE_DEBUG_BREAK();
+        success = false;
+    }
+
+    // The last receiver still gets all of its losses, then the window empties
+    const unsigned last = kReceiverCount - 1;
+    success = success &&
+        decoders[last].SendAck(encoder, receivers[last]) &&
+        retransmitLost(last) &&
+        decoders[last].SendAck(encoder, receivers[last]);
+
+    for (unsigned r = 0; success && r < kReceiverCount; ++r)
+    {
+        if (decoders[r].NextExpectedPacket != kPacketCount)
+        {
+            Logger.Error("Receiver ", r, " failed to get packet ", decoders[r].NextExpectedPacket);
+            SIAMESE_DEBUG_BREAK();
+            success = false;
+        }
+    }
+
+    if (success && EncoderHoldsData(encoder))
+    {
+        Logger.Error("Data was kept after every receiver acknowledged it");
+        SIAMESE_DEBUG_BREAK();
+        success = false;
+    }
+
+    // Send more data that the last receiver never acknowledges, then remove it
+    for (unsigned i = 0; success && i < 50; ++i)
+    {
+        uint8_t buffer[kApiTestMaxPacketBytes];
+        const unsigned bytes = GetApiTestPacketBytes(prng);
+        WriteRandomSelfCheckingPacket(prng, buffer, bytes);
+
+        SiameseOriginalPacket original;
+        original.Data      = buffer;
+        original.DataBytes = bytes;
+        success = (siamese_encoder_add(encoder, &original) == Siamese_Success);
+
+        for (unsigned r = 0; success && r < last; ++r)
+            success = decoders[r].OnOriginal(original) && decoders[r].SendAck(encoder, receivers[r]);
+    }
+
+    if (success && !EncoderHoldsData(encoder))
+    {
+        Logger.Error("Data was removed before the removed receiver acknowledged it");
+        SIAMESE_DEBUG_BREAK();
+        success = false;
+    }
+
+    if (success)
+    {
+        siamese_encoder_remove_receiver(encoder, receivers[last]);
+
+        if (EncoderHoldsData(encoder))
+        {
+            Logger.Error("Data was kept for a removed receiver");
+            SIAMESE_DEBUG_BREAK();
+            success = false;
+        }
+    }
+
+    siamese_encoder_free(encoder);
+
+    success = success && MixedReceiverTest(prng);
+    return success;
+}
+
+#endif // TEST_API
+
+
+#ifdef ENABLE_UNIT_TEST
+
+int main()
+{
+    FunctionTimer t_siamese_init("siamese_init");
+
+    t_siamese_init.BeginCall();
+    if (0 != siamese_init())
+    {
+        Logger.Error("Failed to initialize");
+        return -1;
+    }
+    t_siamese_init.EndCall();
+
+    t_siamese_init.Print(1);
+
+#ifdef TEST_API
+    if (!GF256KernelTest() ||
+        !ParallelismTest() ||
+        !EncodeBatchTest() ||
+        !EncodeIntoTest() ||
+        !AddOwnedTest() ||
+        !ScatterGatherTest() ||
+        !EagerSumsTest() ||
+        !ShrinkRecoveryTest() ||
+        !PreEncodeTest() ||
+        !RetransmitOrderTest() ||
+        !RetransmitBatchTest() ||
+        !MultipleReceiverTest())
+    {
+        Logger.Error("API tests failed");
+        return -1;
+    }
+#endif
 
 #ifdef TEST_HARQ_STREAM
     HARQSimulation simulation;